@@ -0,0 +1,188 @@
+/**
+ ===================================================================================================
+ Name        : benchcorpus.c
+ Author      : Yinnon Bratspiess
+ Description : This file reads the corpora of the benchmarks and checks the solutions of their
+ * 			   puzzles.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../sudukutree.h"
+#include "benchcorpus.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define EMPTY_SLOT 0
+#define EMPTY_SLOT_CHAR '.'
+#define LINE_SIZE 9
+#define INITIAL_PUZZLES 64
+#define BIT(num) ((SudukuMask)1 << ((num) % SUDUKU_MASK_BITS))
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function reads the puzzles of a corpus: lines of 81 chars, one per slot of a 9x9 board
+ * with '0' or '.' for an empty slot, or blocks of the size and then size * size nums, as
+ * sudukusolver --batch reads them.
+ * input :
+ * 		char* fileName - the corpus
+ * 		int* numOfPuzzles - a pointer to put the number of puzzles in
+ * output :
+ * 		the puzzles, NULL if the file can't be read or has an invalid puzzle
+ **/
+BenchPuzzle* readCorpus(char* fileName, int* numOfPuzzles)
+{
+	FILE* file = fopen(fileName, "r");
+	if (file == NULL)
+	{
+		return NULL;
+	}
+	int capacity = INITIAL_PUZZLES;
+	BenchPuzzle* puzzles = (BenchPuzzle*)malloc(capacity * sizeof(BenchPuzzle));
+	int valid = (puzzles != NULL);
+	int slot, num;
+	*numOfPuzzles = 0;
+	while (valid)
+	{
+		int first = fgetc(file);
+		while (first != EOF && isspace(first))
+		{
+			first = fgetc(file);
+		}
+		if (first == EOF)
+		{
+			break;
+		}
+		if (*numOfPuzzles == capacity)
+		{
+			capacity *= 2;
+			BenchPuzzle* grown = (BenchPuzzle*)realloc(puzzles, capacity * sizeof(BenchPuzzle));
+			if (grown == NULL)
+			{
+				valid = FALSE;
+				break;
+			}
+			puzzles = grown;
+		}
+		BenchPuzzle* puzzle = &puzzles[*numOfPuzzles];
+		char line[LINE_SIZE * LINE_SIZE + 1];
+		ungetc(first, file);
+		// a line puzzle is a single token of 81 slots, the first token of a block is its size
+		int scanned = (fscanf(file, "%81[0-9.]", line) == 1);
+		if (scanned && strlen(line) == LINE_SIZE * LINE_SIZE)
+		{
+			puzzle->size = LINE_SIZE;
+			puzzle->cells = (SudukuCell*)malloc(LINE_SIZE * LINE_SIZE * sizeof(SudukuCell));
+			valid = (puzzle->cells != NULL);
+			for (slot = 0; valid && slot < LINE_SIZE * LINE_SIZE; slot++)
+			{
+				puzzle->cells[slot] = (line[slot] == EMPTY_SLOT_CHAR) ? EMPTY_SLOT : \
+									  (SudukuCell)(line[slot] - '0');
+			}
+		}
+		else
+		{
+			// a token that is not all digits, or no token at all, is not a size
+			char* end = line;
+			long size = scanned ? strtol(line, &end, 10) : 0;
+			valid = (end != line && *end == '\0' && size > 0 && size <= SUDUKU_MAX_SIZE && \
+					 sqrtCheck((int)size) >= 0);
+			puzzle->size = valid ? (int)size : 0;
+			puzzle->cells = valid ? (SudukuCell*)malloc(puzzle->size * puzzle->size * \
+														sizeof(SudukuCell)) : NULL;
+			valid = (puzzle->cells != NULL);
+			for (slot = 0; valid && slot < puzzle->size * puzzle->size; slot++)
+			{
+				valid = (fscanf(file, "%d", &num) == 1 && num >= 0 && num <= puzzle->size);
+				puzzle->cells[slot] = (SudukuCell)num;
+			}
+		}
+		(*numOfPuzzles)++;
+	}
+	fclose(file);
+	if (!valid)
+	{
+		for (slot = 0; puzzles != NULL && slot < *numOfPuzzles; slot++)
+		{
+			free(puzzles[slot].cells);
+		}
+		free(puzzles);
+		return NULL;
+	}
+	return puzzles;
+}
+
+/**
+ * This function checks a solved board is full, keeps the clues of its puzzle and has no digit
+ * twice in a row, col or little board.
+ * input :
+ * 		const SudukuCell* cells - the slots of the solved board
+ * 		BenchPuzzle* puzzle - the puzzle
+ * output :
+ * 		1 if the board is a solution of the puzzle, else 0.
+ **/
+int isSolution(const SudukuCell* cells, BenchPuzzle* puzzle)
+{
+	int size = puzzle->size, boxSize = sqrtCheck(size);
+	int slot, unit, k;
+	for (slot = 0; slot < size * size; slot++)
+	{
+		if (cells[slot] == EMPTY_SLOT || \
+			(puzzle->cells[slot] != EMPTY_SLOT && cells[slot] != puzzle->cells[slot]))
+		{
+			return FALSE;
+		}
+	}
+	// the units are the rows, then the cols, then the little boards
+	for (unit = 0; unit < 3 * size; unit++)
+	{
+		SudukuMask seen[SUDUKU_MAX_MASK_WORDS] = {0};
+		int index = unit % size;
+		for (k = 0; k < size; k++)
+		{
+			if (unit < size)
+			{
+				slot = index * size + k;
+			}
+			else if (unit < 2 * size)
+			{
+				slot = k * size + index;
+			}
+			else
+			{
+				slot = ((index / boxSize) * boxSize + k / boxSize) * size + \
+					   (index % boxSize) * boxSize + k % boxSize;
+			}
+			int num = cells[slot] - 1;
+			if (seen[num / SUDUKU_MASK_BITS] & BIT(num))
+			{
+				return FALSE;
+			}
+			seen[num / SUDUKU_MASK_BITS] |= BIT(num);
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * This function frees the puzzles of a corpus.
+ * input :
+ * 		BenchPuzzle* puzzles - the puzzles
+ * 		int numOfPuzzles - the number of puzzles
+ * output :
+ * 		void
+ **/
+void freeCorpus(BenchPuzzle* puzzles, int numOfPuzzles)
+{
+	int k;
+	for (k = 0; k < numOfPuzzles; k++)
+	{
+		free(puzzles[k].cells);
+	}
+	free(puzzles);
+}
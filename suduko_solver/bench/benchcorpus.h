@@ -0,0 +1,58 @@
+/**
+ ===================================================================================================
+ Name        : benchcorpus.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for benchcorpus.c
+ ===================================================================================================
+ **/
+
+#ifndef benchcorpus_H
+#define benchcorpus_H
+
+#include "../sudukutree.h"
+
+//********      structs
+/**
+ * a puzzle of a corpus: its size and its size * size slots.
+ **/
+typedef struct BenchPuzzle
+{
+	int size;
+	SudukuCell* cells;
+}BenchPuzzle;
+
+//********      functions
+/**
+ * This function reads the puzzles of a corpus: lines of 81 chars, one per slot of a 9x9 board
+ * with '0' or '.' for an empty slot, or blocks of the size and then size * size nums, as
+ * sudukusolver --batch reads them.
+ * input :
+ * 		char* fileName - the corpus
+ * 		int* numOfPuzzles - a pointer to put the number of puzzles in
+ * output :
+ * 		the puzzles, NULL if the file can't be read or has an invalid puzzle
+ **/
+BenchPuzzle* readCorpus(char* fileName, int* numOfPuzzles);
+
+/**
+ * This function checks a solved board is full, keeps the clues of its puzzle and has no digit
+ * twice in a row, col or little board.
+ * input :
+ * 		const SudukuCell* cells - the slots of the solved board
+ * 		BenchPuzzle* puzzle - the puzzle
+ * output :
+ * 		1 if the board is a solution of the puzzle, else 0.
+ **/
+int isSolution(const SudukuCell* cells, BenchPuzzle* puzzle);
+
+/**
+ * This function frees the puzzles of a corpus.
+ * input :
+ * 		BenchPuzzle* puzzles - the puzzles
+ * 		int numOfPuzzles - the number of puzzles
+ * output :
+ * 		void
+ **/
+void freeCorpus(BenchPuzzle* puzzles, int numOfPuzzles);
+
+#endif // benchcorpus_H
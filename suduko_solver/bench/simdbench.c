@@ -0,0 +1,268 @@
+/**
+ ===================================================================================================
+ Name        : simdbench.c
+ Author      : Yinnon Bratspiess
+ Description : A micro benchmark of the candidate kernels of sudukusimd.c against the per slot
+ * 			   isValid and getSudukuCandidates paths, and of the vectorized filled slots count
+ * 			   against the plain loop getSudukuValFunc used to run.
+ * 			   usage: simdbench <suduku file> [rounds]
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../sudukutree.h"
+#include "../sudukusimd.h"
+
+// -------------------------- const definitions -------------------------
+#define DEFAULT_ROUNDS 200000
+#define NANOS_IN_SECOND 1000000000.0
+#define NUM_OF_LEVELS 3
+
+// ------------------------------ globals -------------------------------
+static const char* levelNames[NUM_OF_LEVELS] = {"scalar", "sse2", "avx2"};
+// the results of the benchmarked calls are summed here, so the compiler can't drop the calls
+static volatile unsigned long sink = 0;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function returns the current time in seconds.
+ **/
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / NANOS_IN_SECOND;
+}
+
+/**
+ * This function reads a board in the format of sudukusolver: the size and then size * size nums.
+ * input :
+ * 		char* fileName - the file
+ * 		SudukuContext** context - a pointer to put the context of the board in
+ * output :
+ * 		the board, NULL if the file is not a board of size up to SUDUKU_SIMD_MAX_SIZE
+ **/
+static SudukuBoardStruct* readBoard(char* fileName, SudukuContext** context)
+{
+	FILE* file = fopen(fileName, "r");
+	int size, row, col, num;
+	if (file == NULL || fscanf(file, "%d", &size) != 1 || size < 1 || \
+		size > SUDUKU_SIMD_MAX_SIZE || sqrtCheck(size) < 0)
+	{
+		if (file != NULL)
+		{
+			fclose(file);
+		}
+		return NULL;
+	}
+	*context = createSudukuContext(size);
+	SudukuBoardStruct* suduku = (*context == NULL) ? NULL : createSudukuBoard(*context);
+	for (row = 0; suduku != NULL && row < size; row++)
+	{
+		for (col = 0; col < size; col++)
+		{
+			if (fscanf(file, "%d", &num) != 1 || num < 0 || num > size)
+			{
+				suduku = NULL;
+				break;
+			}
+			SUDUKU_SLOT(suduku, row, col) = (SudukuCell)num;
+		}
+	}
+	fclose(file);
+	if (suduku == NULL || !initSudukuMasks(suduku))
+	{
+		return NULL;
+	}
+	return suduku;
+}
+
+/**
+ * the per slot path the solver used before the kernels: isValid for every digit of every empty slot
+ **/
+static unsigned long candidatesByIsValid(SudukuBoardStruct* suduku, uint16_t* candidates)
+{
+	int row, col, num;
+	unsigned long total = 0;
+	for (row = 0; row < suduku->size; row++)
+	{
+		for (col = 0; col < suduku->size; col++)
+		{
+			uint16_t set = 0;
+			if (SUDUKU_SLOT(suduku, row, col) == 0)
+			{
+				for (num = 1; num <= suduku->size; num++)
+				{
+					set |= (uint16_t)(isValid(suduku, num, row, col) << (num - 1));
+				}
+			}
+			candidates[row * SUDUKU_SIMD_MAX_SIZE + col] = set;
+			total += set;
+		}
+	}
+	return total;
+}
+
+/**
+ * the per slot path of the bitset sets: getSudukuCandidates for every empty slot
+ **/
+static unsigned long candidatesByMasks(SudukuBoardStruct* suduku, uint16_t* candidates)
+{
+	int row, col;
+	unsigned long total = 0;
+	SudukuMask set[SUDUKU_MAX_MASK_WORDS];
+	for (row = 0; row < suduku->size; row++)
+	{
+		for (col = 0; col < suduku->size; col++)
+		{
+			set[0] = 0;
+			if (SUDUKU_SLOT(suduku, row, col) == 0)
+			{
+				getSudukuCandidates(suduku, row, col, set);
+			}
+			candidates[row * SUDUKU_SIMD_MAX_SIZE + col] = (uint16_t)set[0];
+			total += set[0];
+		}
+	}
+	return total;
+}
+
+/**
+ * the loop getSudukuValFunc used before the vectorized count
+ **/
+static int countByLoop(SudukuBoardStruct* suduku)
+{
+	int i, j, counter = 0;
+	for (i = 0; i < suduku->size; i++)
+	{
+		for (j = 0; j < suduku->size; j++)
+		{
+			if (SUDUKU_SLOT(suduku, i, j) != 0)
+			{
+				counter++;
+			}
+		}
+	}
+	return counter;
+}
+
+/**
+ * This function checks the sets of the slots of two candidates arrays are the same.
+ **/
+static int sameCandidates(SudukuBoardStruct* suduku, uint16_t* first, uint16_t* second)
+{
+	int row, col;
+	for (row = 0; row < suduku->size; row++)
+	{
+		for (col = 0; col < suduku->size; col++)
+		{
+			if (first[row * SUDUKU_SIMD_MAX_SIZE + col] != second[row * SUDUKU_SIMD_MAX_SIZE + col])
+			{
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/**
+ * This function prints the time of a benchmarked call.
+ **/
+static void report(const char* name, double seconds, long rounds)
+{
+	printf("%-28s %10.1f ns/call\n", name, seconds * NANOS_IN_SECOND / rounds);
+}
+
+/**
+ * runs every path over the board for the given number of rounds, checks they agree and prints
+ * the time of a call of each.
+ **/
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: simdbench <suduku file> [rounds]\n");
+		return 1;
+	}
+	long rounds = (argc > 2) ? atol(argv[2]) : DEFAULT_ROUNDS;
+	SudukuContext* context = NULL;
+	SudukuBoardStruct* suduku = readBoard(argv[1], &context);
+	if (suduku == NULL || rounds < 1)
+	{
+		fprintf(stderr, "%s: not a valid suduku file of size up to %d\n", argv[1], \
+				SUDUKU_SIMD_MAX_SIZE);
+		return 1;
+	}
+	uint16_t expected[SUDUKU_SIMD_MAX_SIZE * SUDUKU_SIMD_MAX_SIZE];
+	uint16_t candidates[SUDUKU_SIMD_MAX_SIZE * SUDUKU_SIMD_MAX_SIZE];
+	int best = getSudukuSimdLevel();
+	int mismatch = 0;
+	long i;
+	int level;
+	double start;
+	printf("board %dx%d, %d filled, best level %s, %ld rounds\n", suduku->size, suduku->size, \
+		   countByLoop(suduku), levelNames[best], rounds);
+
+	start = now();
+	for (i = 0; i < rounds; i++)
+	{
+		sink += candidatesByIsValid(suduku, expected);
+	}
+	report("candidates isValid", now() - start, rounds);
+
+	start = now();
+	for (i = 0; i < rounds; i++)
+	{
+		sink += candidatesByMasks(suduku, candidates);
+	}
+	report("candidates getSudukuCandidates", now() - start, rounds);
+	mismatch |= !sameCandidates(suduku, expected, candidates);
+
+	for (level = SUDUKU_SIMD_SCALAR; level <= best; level++)
+	{
+		char name[64];
+		setSudukuSimdLevel(level);
+		start = now();
+		for (i = 0; i < rounds; i++)
+		{
+			getSudukuCandidateMasks(suduku, candidates);
+			sink += candidates[i % (SUDUKU_SIMD_MAX_SIZE * suduku->size)];
+		}
+		snprintf(name, sizeof(name), "candidates kernel %s", levelNames[level]);
+		report(name, now() - start, rounds);
+		mismatch |= !sameCandidates(suduku, expected, candidates);
+	}
+
+	setSudukuSimdLevel(best);
+	start = now();
+	for (i = 0; i < rounds; i++)
+	{
+		sink += countByLoop(suduku);
+	}
+	report("filled count loop", now() - start, rounds);
+	for (level = SUDUKU_SIMD_SCALAR; level <= best; level++)
+	{
+		char name[64];
+		setSudukuSimdLevel(level);
+		start = now();
+		for (i = 0; i < rounds; i++)
+		{
+			sink += countSudukuFilledSlots(suduku);
+		}
+		snprintf(name, sizeof(name), "filled count %s", levelNames[level]);
+		report(name, now() - start, rounds);
+		mismatch |= (countSudukuFilledSlots(suduku) != countByLoop(suduku));
+	}
+
+	freeSudukuContext(context);
+	if (mismatch)
+	{
+		fprintf(stderr, "the paths disagree!\n");
+		return 1;
+	}
+	return 0;
+}
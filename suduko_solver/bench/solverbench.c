@@ -0,0 +1,249 @@
+/**
+ ===================================================================================================
+ Name        : solverbench.c
+ Author      : Yinnon Bratspiess
+ Description : A benchmark of the DFS (or the SAT) solver over a corpus of puzzles. it solves
+ * 			   every puzzle of the corpus, checks the solutions, and prints one line of key=value
+ * 			   fields: the wall time, the nodes expanded (the decisions of the SAT solver), the
+ * 			   nodes per second, the peak RSS and the allocation counts, so the lines of two
+ * 			   builds can be diffed.
+ * 			   the malloc family is wrapped at link time (see the bench target of the makefile)
+ * 			   to count the allocations of the solver.
+ * 			   a node budget stops the DFS of a puzzle after that many nodes, and the puzzle is
+ * 			   counted as stopped instead of solved, so the puzzles too hard for the DFS don't
+ * 			   stop the benchmark.
+ * 			   the lib solver is the DFS of sudukulib.h: its solver is created before the
+ * 			   allocations are counted, so mallocs shows the solves themselves allocate nothing.
+ * 			   usage: solverbench <corpus file> [rounds] [dfs|sat|lib] [node budget]
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "../genericdfs.h"
+#include "../sudukutree.h"
+#include "../sudukufixed.h"
+#include "../sudukusat.h"
+#include "../sudukulib.h"
+#include "benchcorpus.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define DEFAULT_ROUNDS 1
+#define DFS_SOLVER "dfs"
+#define SAT_SOLVER "sat"
+#define LIB_SOLVER "lib"
+#define NANOS_IN_SECOND 1e9
+
+// ------------------------------ globals -------------------------------
+// the allocations made through the wrapped malloc family, and the bytes they asked for
+static unsigned long allocations = 0;
+static unsigned long allocatedBytes = 0;
+
+// ------------------------------ functions -----------------------------
+void* __real_malloc(size_t bytes);
+void* __real_calloc(size_t count, size_t bytes);
+void* __real_realloc(void* pointer, size_t bytes);
+
+/**
+ * the wrappers of the malloc family, which count the allocations and pass them on
+ **/
+void* __wrap_malloc(size_t bytes)
+{
+	allocations++;
+	allocatedBytes += bytes;
+	return __real_malloc(bytes);
+}
+
+void* __wrap_calloc(size_t count, size_t bytes)
+{
+	allocations++;
+	allocatedBytes += count * bytes;
+	return __real_calloc(count, bytes);
+}
+
+void* __wrap_realloc(void* pointer, size_t bytes)
+{
+	allocations++;
+	allocatedBytes += bytes;
+	return __real_realloc(pointer, bytes);
+}
+
+/**
+ * This function returns the current time in seconds.
+ **/
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / NANOS_IN_SECOND;
+}
+
+/**
+ * solves the corpus the given number of rounds and prints the line of its results.
+ **/
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: solverbench <corpus file> [rounds] [dfs|sat|lib] [node budget]\n");
+		return 1;
+	}
+	int rounds = (argc > 2) ? atoi(argv[2]) : DEFAULT_ROUNDS;
+	const char* solver = (argc > 3) ? argv[3] : DFS_SOLVER;
+	unsigned long nodeBudget = (argc > 4) ? strtoul(argv[4], NULL, 10) : DFS_NO_LIMIT;
+	int useSat = (strcmp(solver, SAT_SOLVER) == 0);
+	int useLib = (strcmp(solver, LIB_SOLVER) == 0);
+	if (!useSat && !useLib && strcmp(solver, DFS_SOLVER) != 0)
+	{
+		fprintf(stderr, "%s: not a solver, use %s, %s or %s\n", solver, DFS_SOLVER, SAT_SOLVER, \
+				LIB_SOLVER);
+		return 1;
+	}
+	int numOfPuzzles, k;
+	BenchPuzzle* puzzles = readCorpus(argv[1], &numOfPuzzles);
+	if (puzzles == NULL || rounds < 1)
+	{
+		fprintf(stderr, "%s: not a valid corpus\n", argv[1]);
+		return 1;
+	}
+	SudukuContext* contexts[SUDUKU_MAX_SIZE + 1] = {NULL};
+	// the library's solver and the array of its solutions are made for the biggest puzzle
+	SudukuSolver* libSolver = NULL;
+	SudukuCell* solution = NULL;
+	int maxSize = 0;
+	for (k = 0; k < numOfPuzzles; k++)
+	{
+		maxSize = (puzzles[k].size > maxSize) ? puzzles[k].size : maxSize;
+	}
+	if (useLib)
+	{
+		libSolver = createSudukuSolver(maxSize);
+		solution = (SudukuCell*)malloc(maxSize * maxSize * sizeof(SudukuCell));
+	}
+	if (useLib && (libSolver == NULL || solution == NULL))
+	{
+		fprintf(stderr, "memory allocation failed\n");
+		return 1;
+	}
+	unsigned long nodes = 0, slabAllocations = 0, nodeAcquisitions = 0;
+	// only the allocations of the solving are counted, not the ones of reading the corpus
+	unsigned long readAllocations = allocations, readBytes = allocatedBytes;
+	int solved = 0, wrong = 0, stopped = 0;
+	DfsBudget budget;
+	int round;
+	double start = now();
+	for (round = 0; round < rounds; round++)
+	{
+		for (k = 0; k < numOfPuzzles; k++)
+		{
+			int size = puzzles[k].size;
+			initDfsBudget(&budget, nodeBudget, DFS_NO_LIMIT);
+			if (useLib)
+			{
+				int status = solveSudukuCells(libSolver, size, puzzles[k].cells, solution, \
+											  (nodeBudget == DFS_NO_LIMIT) ? NULL : &budget);
+				if (status == SUDUKU_SOLVE_FAILED)
+				{
+					fprintf(stderr, "memory allocation failed\n");
+					return 1;
+				}
+				stopped += (status == SUDUKU_SOLVE_STOPPED);
+				if (status == SUDUKU_SOLVE_OK)
+				{
+					solved++;
+					wrong += !isSolution(solution, &puzzles[k]);
+				}
+				continue;
+			}
+			if (contexts[size] == NULL && (contexts[size] = createSudukuContext(size)) == NULL)
+			{
+				fprintf(stderr, "memory allocation failed\n");
+				return 1;
+			}
+			SudukuBoardStruct* suduku = createSudukuBoard(contexts[size]);
+			if (suduku == NULL)
+			{
+				fprintf(stderr, "memory allocation failed\n");
+				return 1;
+			}
+			memcpy(suduku->board, puzzles[k].cells, size * size * sizeof(SudukuCell));
+			// the solver specialized for the size, like sudukusolver picks it
+			getNodeMovesFunc getMoves;
+			applyMoveFunc applyMove;
+			getSudukuFixedMoveFuncs(contexts[size], &getMoves, &applyMove);
+			int valid = initSudukuMasks(suduku);
+			if (valid && useSat)
+			{
+				valid = solveSudukuSat(suduku, NULL);
+				if (valid == SUDUKU_SAT_FAILED)
+				{
+					fprintf(stderr, "memory allocation failed\n");
+					return 1;
+				}
+			}
+			else if (valid)
+			{
+				valid = getBestInPlaceWithBudget(suduku, getMoves, applyMove, undoSudukuMoveFunc, \
+												 getSudukuValFunc, NULL, NULL, size * size, \
+												 NULL, (nodeBudget == DFS_NO_LIMIT) ? NULL : \
+												 &budget) != NULL;
+				if (budget.status == DFS_STATUS_FAILED)
+				{
+					fprintf(stderr, "memory allocation failed\n");
+					return 1;
+				}
+				stopped += (budget.status != DFS_STATUS_DONE);
+			}
+			if (valid && budget.status == DFS_STATUS_DONE)
+			{
+				solved++;
+				wrong += !isSolution(suduku->board, &puzzles[k]);
+			}
+			freeSudukuFunc(suduku);
+		}
+	}
+	double seconds = now() - start;
+	if (useLib)
+	{
+		nodes = getSudukuSolverNodes(libSolver);
+	}
+	for (k = 0; k <= SUDUKU_MAX_SIZE; k++)
+	{
+		if (contexts[k] != NULL)
+		{
+			nodes += contexts[k]->nodesExpanded;
+			slabAllocations += contexts[k]->slabAllocations;
+			nodeAcquisitions += contexts[k]->nodeAcquisitions;
+		}
+	}
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	const char* name = strrchr(argv[1], '/');
+	name = (name == NULL) ? argv[1] : name + 1;
+	// every count is the total of all the rounds
+	printf("corpus=%s solver=%s puzzles=%d rounds=%d solved=%d stopped=%d wrong=%d " \
+		   "seconds=%.6f nodes=%lu nodes_per_second=%.0f peak_rss_kb=%ld mallocs=%lu " \
+		   "malloc_bytes=%lu slab_allocations=%lu node_acquisitions=%lu\n", name, solver, \
+		   numOfPuzzles, rounds, solved, stopped, wrong, seconds, nodes, \
+		   (seconds > 0) ? nodes / seconds : 0, usage.ru_maxrss, allocations - readAllocations, \
+		   allocatedBytes - readBytes, slabAllocations, nodeAcquisitions);
+	for (k = 0; k <= SUDUKU_MAX_SIZE; k++)
+	{
+		if (contexts[k] != NULL)
+		{
+			freeSudukuContext(contexts[k]);
+		}
+	}
+	freeSudukuSolver(libSolver);
+	free(solution);
+	freeCorpus(puzzles, numOfPuzzles);
+	// a stopped puzzle ran out of its budget, which is not a failure of the solver
+	return (wrong != 0 || solved + stopped != numOfPuzzles * rounds);
+}
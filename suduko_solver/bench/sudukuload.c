@@ -0,0 +1,502 @@
+/**
+ ===================================================================================================
+ Name        : sudukuload.c
+ Author      : Yinnon Bratspiess
+ Description : A load generator for the daemon of sudukusolver --daemon. it opens a number of
+ * 			   connections to the daemon's socket, keeps up to a pipeline depth of boards of a
+ * 			   corpus in flight on each, checks every answer, and prints one line of key=value
+ * 			   fields: the wall time, the boards per second and the percentiles of the latency
+ * 			   the client saw, from sending a board to reading its whole answer. then it asks
+ * 			   the daemon for its own statistics and prints them on a line of their own.
+ * 			   the connections are retried for a while, so it can be started with the daemon.
+ * 			   usage: sudukuload <socket> <corpus file> [connections] [depth] [rounds]
+ * 			   [text|binary]
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "../sudukutree.h"
+#include "../sudukulib.h"
+#include "../sudukudaemon.h"
+#include "benchcorpus.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define DEFAULT_CONNECTIONS 4
+#define DEFAULT_DEPTH 16
+#define DEFAULT_ROUNDS 1
+#define TEXT_FORMAT "text"
+#define BINARY_FORMAT "binary"
+// the bytes of a binary answer before its slots: the magic, the status and the size
+#define BINARY_ANSWER_HEADER 3
+// a slot of a text board is up to 3 digits and a space or a new line
+#define TEXT_SLOT_BYTES 4
+#define TEXT_SIZE_BYTES 16
+#define READ_BYTES 65536
+#define STATS_LINE_BYTES 512
+// the daemon is waited for this many times, a retry interval apart
+#define CONNECT_RETRIES 200
+#define RETRY_NANOS 10000000L
+#define NANOS_IN_SECOND 1e9
+#define MICROS_IN_SECOND 1e6
+
+// -------------------------- structs -----------------------------------
+/**
+ * a connection to the daemon: the requests not sent yet, the answers not parsed yet, and the
+ * puzzles in flight with the times they were sent, in a ring of depth entries.
+ **/
+typedef struct LoadConnection
+{
+	int fd;
+	char* output;
+	size_t outputLength;
+	size_t outputSent;
+	size_t outputCapacity;
+	char* input;
+	size_t inputLength;
+	size_t inputCapacity;
+	int* inFlight;
+	double* sentAt;
+	int first;
+	int numInFlight;
+}LoadConnection;
+
+/**
+ * the counts of the answers.
+ **/
+typedef struct LoadCounts
+{
+	unsigned long answers;
+	unsigned long solved;
+	unsigned long wrong;
+	unsigned long unsolved;
+}LoadCounts;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function returns the current time in seconds.
+ **/
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / NANOS_IN_SECOND;
+}
+
+/**
+ * This function connects to the daemon's socket, waiting for the daemon to make it.
+ * input :
+ * 		const char* socketPath - the path of the socket
+ * output :
+ * 		the connected socket, -1 if it can't connect.
+ **/
+static int connectDaemon(const char* socketPath)
+{
+	struct sockaddr_un address;
+	if (strlen(socketPath) >= sizeof(address.sun_path))
+	{
+		return -1;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, socketPath);
+	struct timespec interval = {0, RETRY_NANOS};
+	int retry;
+	for (retry = 0; retry < CONNECT_RETRIES; retry++)
+	{
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+		{
+			return -1;
+		}
+		if (connect(fd, (struct sockaddr*)&address, sizeof(address)) == 0)
+		{
+			return fd;
+		}
+		close(fd);
+		if (errno != ENOENT && errno != ECONNREFUSED)
+		{
+			return -1;
+		}
+		nanosleep(&interval, NULL);
+	}
+	return -1;
+}
+
+/**
+ * This function makes sure a buffer has room for more bytes.
+ * input :
+ * 		char** buffer - the buffer
+ * 		size_t* capacity - its capacity
+ * 		size_t needed - the bytes it has to hold
+ * output :
+ * 		1 on success, 0 if memory allocation failed.
+ **/
+static int reserve(char** buffer, size_t* capacity, size_t needed)
+{
+	if (needed <= *capacity)
+	{
+		return TRUE;
+	}
+	size_t grown = (*capacity == 0) ? READ_BYTES : *capacity;
+	while (grown < needed)
+	{
+		grown *= 2;
+	}
+	char* bytes = (char*)realloc(*buffer, grown);
+	if (bytes == NULL)
+	{
+		return FALSE;
+	}
+	*buffer = bytes;
+	*capacity = grown;
+	return TRUE;
+}
+
+/**
+ * This function appends the request of a puzzle to a connection's output.
+ * input :
+ * 		LoadConnection* connection - the connection
+ * 		BenchPuzzle* puzzle - the puzzle
+ * 		int binary - 1 for the binary form, 0 for the text one
+ * output :
+ * 		1 on success, 0 if memory allocation failed.
+ **/
+static int appendRequest(LoadConnection* connection, BenchPuzzle* puzzle, int binary)
+{
+	int size = puzzle->size, slot;
+	size_t needed = connection->outputLength + size * size * TEXT_SLOT_BYTES + TEXT_SIZE_BYTES;
+	if (!reserve(&connection->output, &connection->outputCapacity, needed))
+	{
+		return FALSE;
+	}
+	char* output = connection->output + connection->outputLength;
+	if (binary)
+	{
+		output[0] = (char)SUDUKU_DAEMON_BINARY_MAGIC;
+		output[1] = (char)size;
+		memcpy(output + 2, puzzle->cells, size * size);
+		connection->outputLength += 2 + size * size;
+		return TRUE;
+	}
+	size_t length = sprintf(output, "%d\n", size);
+	for (slot = 0; slot < size * size; slot++)
+	{
+		length += sprintf(output + length, "%d", puzzle->cells[slot]);
+		output[length] = (slot % size == size - 1) ? '\n' : ' ';
+		length++;
+	}
+	connection->outputLength += length;
+	return TRUE;
+}
+
+/**
+ * This function parses the answer at the start of a connection's input, if it's all there.
+ * input :
+ * 		const char* input - the input
+ * 		size_t length - the length of the input
+ * 		int binary - 1 for the binary form, 0 for the text one
+ * 		int size - the size of the board the answer is for
+ * 		SudukuCell* solution - an array of size * size slots to put a solution in
+ * 		int* solved - a pointer to put 1 in if the answer is a solution, else 0
+ * output :
+ * 		the length of the answer, 0 if it's not all in the input yet.
+ **/
+static size_t parseAnswer(const char* input, size_t length, int binary, int size, \
+						  SudukuCell* solution, int* solved)
+{
+	*solved = FALSE;
+	if (binary)
+	{
+		if (length < BINARY_ANSWER_HEADER)
+		{
+			return 0;
+		}
+		if (input[1] != SUDUKU_SOLVE_OK)
+		{
+			return BINARY_ANSWER_HEADER;
+		}
+		if (length < BINARY_ANSWER_HEADER + (size_t)size * size)
+		{
+			return 0;
+		}
+		memcpy(solution, input + BINARY_ANSWER_HEADER, size * size);
+		*solved = ((unsigned char)input[2] == size);
+		return BINARY_ANSWER_HEADER + size * size;
+	}
+	// a solution is a line of the size and a line per row, anything else is a single line
+	const char* end = memchr(input, '\n', length);
+	if (end == NULL)
+	{
+		return 0;
+	}
+	if (*input < '0' || *input > '9')
+	{
+		return end - input + 1;
+	}
+	int row;
+	for (row = 0; row < size; row++)
+	{
+		end = memchr(end + 1, '\n', input + length - end - 1);
+		if (end == NULL)
+		{
+			return 0;
+		}
+	}
+	char* position = (char*)input;
+	*solved = (strtol(position, &position, 10) == size);
+	int slot;
+	for (slot = 0; slot < size * size; slot++)
+	{
+		solution[slot] = (SudukuCell)strtol(position, &position, 10);
+	}
+	return end - input + 1;
+}
+
+/**
+ * This function asks the daemon for its statistics.
+ * input :
+ * 		const char* socketPath - the path of the socket
+ * 		char* line - a buffer of STATS_LINE_BYTES bytes to put the line in
+ * output :
+ * 		1 on success, else 0.
+ **/
+static int readDaemonStats(const char* socketPath, char* line)
+{
+	int fd = connectDaemon(socketPath);
+	if (fd < 0)
+	{
+		return FALSE;
+	}
+	const char request[] = SUDUKU_DAEMON_STATS_REQUEST "\n";
+	size_t length = 0;
+	if (write(fd, request, strlen(request)) == (ssize_t)strlen(request))
+	{
+		shutdown(fd, SHUT_WR);
+		ssize_t bytes;
+		while (length < STATS_LINE_BYTES - 1 && \
+			   (bytes = read(fd, line + length, STATS_LINE_BYTES - 1 - length)) > 0)
+		{
+			length += bytes;
+		}
+	}
+	line[length] = '\0';
+	close(fd);
+	return (length > 0);
+}
+
+/**
+ * This function compares two latencies, for qsort.
+ **/
+static int compareLatencies(const void* first, const void* second)
+{
+	unsigned long a = *(const unsigned long*)first, b = *(const unsigned long*)second;
+	return (a > b) - (a < b);
+}
+
+/**
+ * sends the corpus the given number of rounds over the connections and prints the results.
+ **/
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: sudukuload <socket> <corpus file> [connections] [depth] " \
+				"[rounds] [text|binary]\n");
+		return 1;
+	}
+	const char* socketPath = argv[1];
+	int numOfConnections = (argc > 3) ? atoi(argv[3]) : DEFAULT_CONNECTIONS;
+	int depth = (argc > 4) ? atoi(argv[4]) : DEFAULT_DEPTH;
+	int rounds = (argc > 5) ? atoi(argv[5]) : DEFAULT_ROUNDS;
+	const char* format = (argc > 6) ? argv[6] : TEXT_FORMAT;
+	int binary = (strcmp(format, BINARY_FORMAT) == 0);
+	if ((!binary && strcmp(format, TEXT_FORMAT) != 0) || numOfConnections < 1 || depth < 1 || \
+		rounds < 1)
+	{
+		fprintf(stderr, "not a valid connections, depth, rounds or format\n");
+		return 1;
+	}
+	int numOfPuzzles, k;
+	BenchPuzzle* puzzles = readCorpus(argv[2], &numOfPuzzles);
+	if (puzzles == NULL || numOfPuzzles == 0)
+	{
+		fprintf(stderr, "%s: not a valid corpus\n", argv[2]);
+		return 1;
+	}
+	int maxSize = 0;
+	for (k = 0; k < numOfPuzzles; k++)
+	{
+		maxSize = (puzzles[k].size > maxSize) ? puzzles[k].size : maxSize;
+	}
+	unsigned long numOfRequests = (unsigned long)numOfPuzzles * rounds;
+	LoadConnection* connections = (LoadConnection*)calloc(numOfConnections, \
+														  sizeof(LoadConnection));
+	struct pollfd* fds = (struct pollfd*)malloc(numOfConnections * sizeof(struct pollfd));
+	unsigned long* latencies = (unsigned long*)malloc(numOfRequests * sizeof(unsigned long));
+	SudukuCell* solution = (SudukuCell*)malloc(maxSize * maxSize * sizeof(SudukuCell));
+	int valid = (connections != NULL && fds != NULL && latencies != NULL && solution != NULL);
+	int i;
+	for (i = 0; valid && i < numOfConnections; i++)
+	{
+		LoadConnection* connection = &connections[i];
+		connection->inFlight = (int*)malloc(depth * sizeof(int));
+		connection->sentAt = (double*)malloc(depth * sizeof(double));
+		connection->fd = connectDaemon(socketPath);
+		valid = (connection->inFlight != NULL && connection->sentAt != NULL && \
+				 connection->fd >= 0 && fcntl(connection->fd, F_SETFL, O_NONBLOCK) != -1);
+	}
+	if (!valid)
+	{
+		fprintf(stderr, "can't connect to %s\n", socketPath);
+		return 1;
+	}
+	LoadCounts counts = {0, 0, 0, 0};
+	unsigned long nextRequest = 0;
+	int failed = FALSE;
+	double start = now();
+	while (counts.answers < numOfRequests && !failed)
+	{
+		// every connection is topped up to depth boards in flight
+		for (i = 0; i < numOfConnections; i++)
+		{
+			LoadConnection* connection = &connections[i];
+			while (connection->numInFlight < depth && nextRequest < numOfRequests && !failed)
+			{
+				int puzzle = nextRequest % numOfPuzzles;
+				int ring = (connection->first + connection->numInFlight) % depth;
+				connection->inFlight[ring] = puzzle;
+				connection->sentAt[ring] = now();
+				connection->numInFlight++;
+				nextRequest++;
+				failed = !appendRequest(connection, &puzzles[puzzle], binary);
+			}
+			fds[i].fd = connection->fd;
+			fds[i].events = POLLIN;
+			if (connection->outputSent < connection->outputLength)
+			{
+				fds[i].events |= POLLOUT;
+			}
+		}
+		if (failed || poll(fds, numOfConnections, -1) < 0)
+		{
+			failed = TRUE;
+			break;
+		}
+		for (i = 0; i < numOfConnections && !failed; i++)
+		{
+			LoadConnection* connection = &connections[i];
+			if (fds[i].revents & POLLOUT)
+			{
+				ssize_t bytes = send(connection->fd, connection->output + connection->outputSent, \
+									 connection->outputLength - connection->outputSent, \
+									 MSG_NOSIGNAL);
+				failed = (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+				connection->outputSent += (bytes > 0) ? bytes : 0;
+				if (connection->outputSent == connection->outputLength)
+				{
+					connection->outputSent = 0;
+					connection->outputLength = 0;
+				}
+			}
+			if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)) || failed)
+			{
+				continue;
+			}
+			if (!reserve(&connection->input, &connection->inputCapacity, \
+						 connection->inputLength + READ_BYTES))
+			{
+				failed = TRUE;
+				break;
+			}
+			ssize_t bytes = read(connection->fd, connection->input + connection->inputLength, \
+								 READ_BYTES);
+			if (bytes <= 0)
+			{
+				// the daemon went away with boards in flight
+				failed = (bytes == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+				continue;
+			}
+			connection->inputLength += bytes;
+			size_t position = 0, length;
+			double time = now();
+			int solved;
+			// the answers of a connection come in the order of its requests
+			while (connection->numInFlight > 0 && \
+				   (length = parseAnswer(connection->input + position, \
+										 connection->inputLength - position, binary, \
+										 puzzles[connection->inFlight[connection->first]].size, \
+										 solution, &solved)) > 0)
+			{
+				BenchPuzzle* puzzle = &puzzles[connection->inFlight[connection->first]];
+				latencies[counts.answers] = (unsigned long)((time - \
+											connection->sentAt[connection->first]) * \
+											MICROS_IN_SECOND);
+				counts.answers++;
+				counts.solved += solved;
+				counts.wrong += (solved && !isSolution(solution, puzzle));
+				counts.unsolved += !solved;
+				connection->first = (connection->first + 1) % depth;
+				connection->numInFlight--;
+				position += length;
+			}
+			memmove(connection->input, connection->input + position, \
+					connection->inputLength - position);
+			connection->inputLength -= position;
+		}
+	}
+	double seconds = now() - start;
+	qsort(latencies, counts.answers, sizeof(unsigned long), compareLatencies);
+	// the nearest rank percentiles: the latency that many per mill of the boards were within
+	const int perMills[] = {500, 900, 990, 999, 1000};
+	unsigned long percentiles[sizeof(perMills) / sizeof(perMills[0])] = {0};
+	size_t rank;
+	for (k = 0; counts.answers > 0 && k < (int)(sizeof(perMills) / sizeof(perMills[0])); k++)
+	{
+		rank = (counts.answers * perMills[k] + 999) / 1000;
+		percentiles[k] = latencies[(rank == 0) ? 0 : rank - 1];
+	}
+	const char* name = strrchr(argv[2], '/');
+	name = (name == NULL) ? argv[2] : name + 1;
+	printf("corpus=%s format=%s connections=%d depth=%d requests=%lu answers=%lu solved=%lu " \
+		   "wrong=%lu unsolved=%lu seconds=%.6f requests_per_second=%.0f p50_us=%lu p90_us=%lu " \
+		   "p99_us=%lu p999_us=%lu max_us=%lu\n", name, format, numOfConnections, depth, \
+		   numOfRequests, counts.answers, counts.solved, counts.wrong, counts.unsolved, seconds, \
+		   (seconds > 0) ? counts.answers / seconds : 0, percentiles[0], percentiles[1], \
+		   percentiles[2], percentiles[3], percentiles[4]);
+	char stats[STATS_LINE_BYTES];
+	if (readDaemonStats(socketPath, stats))
+	{
+		printf("daemon %s", stats);
+	}
+	for (i = 0; i < numOfConnections; i++)
+	{
+		close(connections[i].fd);
+		free(connections[i].output);
+		free(connections[i].input);
+		free(connections[i].inFlight);
+		free(connections[i].sentAt);
+	}
+	free(connections);
+	free(fds);
+	free(latencies);
+	free(solution);
+	freeCorpus(puzzles, numOfPuzzles);
+	if (failed)
+	{
+		fprintf(stderr, "the connection to the daemon failed\n");
+	}
+	return (failed || counts.wrong != 0);
+}
@@ -10,29 +10,237 @@
 #include <stdio.h>
 #include <string.h> 
 #include <stdlib.h>
+#include <time.h>
 #include "genericdfs.h"
-	
+#if defined(DFS_TRACE) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+// -------------------------- const definitions -------------------------
+// the number of frames the stacks of getBestLazy and getBestIterative start with. a stack is
+// doubled when it's full
+#define DFS_INITIAL_STACK 64
+#define TRUE 1
+#define FALSE 0
+#define NANOS_IN_SECOND 1000000000ULL
+#define NANOS_IN_MILLI 1000000ULL
+// the number of nodes a search with a deadline expands between two readings of the clock
+#define DFS_CLOCK_INTERVAL 32
+
+// ------------------------------ clocks --------------------------------
+/**
+ * This function returns the time of CLOCK_MONOTONIC in nanoseconds.
+ **/
+static uint64_t readNanos(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * NANOS_IN_SECOND + time.tv_nsec;
+}
+
+// ------------------------------ tracing -------------------------------
+#ifdef DFS_TRACE
+// the trace the searches of the thread record into, NULL when they're not traced
+static _Thread_local DfsTrace* currentTrace = NULL;
+
+/**
+ * This function returns the time stamp counter, or the time in nanoseconds where there's none.
+ **/
+static inline uint64_t readCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return readNanos();
+#endif
+}
+
+/**
+ * This function counts a node expanded at a depth, with its number of children, in the trace of
+ * the thread.
+ **/
+static inline void traceNode(unsigned long depth, int numOfChildren)
+{
+	DfsTrace* trace = currentTrace;
+	if (trace == NULL)
+	{
+		return;
+	}
+	trace->nodesExpanded++;
+	if (depth > trace->peakDepth)
+	{
+		trace->peakDepth = depth;
+	}
+	if (depth >= DFS_TRACE_MAX_DEPTH)
+	{
+		depth = DFS_TRACE_MAX_DEPTH - 1;
+	}
+	trace->nodesAtDepth[depth]++;
+	trace->childrenAtDepth[depth] += (numOfChildren > 0) ? numOfChildren : 0;
+}
+
+// makes a call of a callback, counting the call and its cycles in the trace of the thread
+#define TRACE_CALLBACK(callback, call) \
+	do \
+	{ \
+		DfsTrace* trace_ = currentTrace; \
+		uint64_t start_ = (trace_ != NULL) ? readCycles() : 0; \
+		call; \
+		if (trace_ != NULL) \
+		{ \
+			trace_->callbackCycles[callback] += readCycles() - start_; \
+			trace_->callbackCalls[callback]++; \
+		} \
+	} while (0)
+#define TRACE_NODE(depth, numOfChildren) traceNode(depth, numOfChildren)
+#else
+#define TRACE_CALLBACK(callback, call) call
+#define TRACE_NODE(depth, numOfChildren)
+#endif
+
+// the names of the callbacks, by the DFS_TRACE_ consts
+static const char* callbackNames[DFS_TRACE_CALLBACKS] = {"getChildren", "getNextChild", \
+	"getMoves", "applyMove", "undoMove", "getVal", "copy", "freeNode", "getHash"};
+
+/**
+ * @brief startDfsTrace This function zeroes a trace and makes the searches of the calling thread
+ * record into it: getBest, getBestLazy and the in place searches (getBestIterative,
+ * getBestWithTable, countBest and getBestInPlace). the searches of other threads, like the
+ * workers of getBestParallel, are not traced. The counters are compiled in only when the library
+ * is built with DFS_TRACE defined, so a build without it pays nothing for them.
+ * @param trace The trace, NULL to stop tracing.
+ * @return 1 if the searches are traced, 0 if the library was built without DFS_TRACE (the trace
+ * is still zeroed) or trace is NULL.
+ */
+int startDfsTrace(DfsTrace* trace)
+{
+	if (trace != NULL)
+	{
+		memset(trace, 0, sizeof(DfsTrace));
+	}
+#ifdef DFS_TRACE
+	currentTrace = trace;
+	return trace != NULL;
+#else
+	return FALSE;
+#endif
+}
+
+/**
+ * @brief printDfsTrace This function prints a trace: the nodes expanded, the nodes and the
+ * branching factor of every depth, and the calls and cycles of every callback that was called.
+ * @param output The stream to print to.
+ * @param trace The trace.
+ */
+void printDfsTrace(FILE* output, DfsTrace* trace)
+{
+	unsigned long depth;
+	int callback;
+	fprintf(output, "nodes expanded: %lu\npeak depth: %lu\n", trace->nodesExpanded, \
+			trace->peakDepth);
+	fprintf(output, "depth nodes children branching\n");
+	for (depth = 0; depth < DFS_TRACE_MAX_DEPTH; depth++)
+	{
+		if (trace->nodesAtDepth[depth] != 0)
+		{
+			fprintf(output, "%5lu%s %lu %lu %.2f\n", depth, \
+					(depth == DFS_TRACE_MAX_DEPTH - 1) ? "+" : "", trace->nodesAtDepth[depth], \
+					trace->childrenAtDepth[depth], \
+					(double)trace->childrenAtDepth[depth] / trace->nodesAtDepth[depth]);
+		}
+	}
+	fprintf(output, "callback calls cycles cycles/call\n");
+	for (callback = 0; callback < DFS_TRACE_CALLBACKS; callback++)
+	{
+		if (trace->callbackCalls[callback] != 0)
+		{
+			fprintf(output, "%s %lu %llu %.1f\n", callbackNames[callback], \
+					trace->callbackCalls[callback], \
+					(unsigned long long)trace->callbackCycles[callback], \
+					(double)trace->callbackCycles[callback] / trace->callbackCalls[callback]);
+		}
+	}
+}
+
+// ------------------------------ budget --------------------------------
+/**
+ * @brief initDfsBudget This function sets the limits of a budget and clears its cancellation. A
+ * search with the budget stops when it expanded maxNodes nodes, when the timeout passed since
+ * this call or when cancelDfsSearch is called, whichever comes first. The deadline is checked
+ * once every few nodes, so the search can run over it by the time of expanding them.
+ * @param budget The budget.
+ * @param maxNodes The most nodes the search may expand, DFS_NO_LIMIT for no limit.
+ * @param timeoutMillis The milliseconds the search may take, DFS_NO_LIMIT for no deadline.
+ */
+void initDfsBudget(DfsBudget* budget, unsigned long maxNodes, unsigned long timeoutMillis)
+{
+	budget->maxNodes = maxNodes;
+	budget->deadline = (timeoutMillis == DFS_NO_LIMIT) ? DFS_NO_LIMIT : \
+					   readNanos() + timeoutMillis * NANOS_IN_MILLI;
+	atomic_init(&budget->cancelled, FALSE);
+	budget->status = DFS_STATUS_DONE;
+	budget->nodesExpanded = 0;
+	budget->bestValue = 0;
+}
+
+/**
+ * @brief cancelDfsSearch This function makes the search with a budget stop, as soon as it gets to
+ * its next node, with DFS_STATUS_CANCELLED. It can be called from any thread, also before the
+ * search starts.
+ * @param budget The budget of the search.
+ */
+void cancelDfsSearch(DfsBudget* budget)
+{
+	atomic_store(&budget->cancelled, TRUE);
+}
+
+/**
+ * This function counts a node the search is about to expand in its budget.
+ * input :
+ * 		DfsBudget* budget - the budget, NULL for a search without one
+ * output :
+ * 		1 if the node may be expanded, 0 if the budget ran out. its status tells which limit did.
+ **/
+static inline int spendBudget(DfsBudget* budget)
+{
+	if (budget == NULL)
+	{
+		return TRUE;
+	}
+	if (atomic_load_explicit(&budget->cancelled, memory_order_relaxed))
+	{
+		budget->status = DFS_STATUS_CANCELLED;
+		return FALSE;
+	}
+	if (budget->maxNodes != DFS_NO_LIMIT && budget->nodesExpanded >= budget->maxNodes)
+	{
+		budget->status = DFS_STATUS_NODE_LIMIT;
+		return FALSE;
+	}
+	if (budget->deadline != DFS_NO_LIMIT && budget->nodesExpanded % DFS_CLOCK_INTERVAL == 0 && \
+		readNanos() >= budget->deadline)
+	{
+		budget->status = DFS_STATUS_DEADLINE;
+		return FALSE;
+	}
+	budget->nodesExpanded++;
+	return TRUE;
+}
+
 // ------------------------------ functions -----------------------------
 /**
- * @brief getBest This function returns the node with the highest value in the tree, using
- * DFS algorithm.
- * @param head The head of the tree.
- * @param getChildren A function that gets a node and a pointer to an array of nodes.
- * The function allocates memory for an array of all the children of the node, populate it,
- * and returns it using the second parameter. The returned value is the number of children.
- * @param getVal A function that gets a node and returns its value, as int.
- * @param freeNode A function that frees a node from memory. This function will be called for each
- * node returned by getChildren.
- * @param copy A function that does a deep copy of a node.
- * @param best The highest possible value for a node. When the function encounters a node with that
- * value, it stops looking and returns it. If the best value can't be determined, pass 
- * UINT_MAX (defined in limits.h) for that parameter.
- * @return The node with the highest value in the tree. In case of an error, or when all the nodes
- * in the tree have a value of zero, the returned node is NULL. If some nodes share the best value,
- * the function returns the first one it encounters.
- */	
-pNode getBest(pNode head, getNodeChildrenFunc getChildren,\
-			  getNodeValFunc getVal, freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best)
+ * This function is the search of getBest, on a node at the given depth of the tree.
+ * input :
+ * 		the parameters of getBestWithBudget, and:
+ * 		unsigned long depth - the depth of the head, for the trace
+ * 		pNode* partial - a pointer to the copy of the node with the highest value visited so far,
+ * 						 kept only if there's a budget
+ * output :
+ * 		the return value of getBest for the subtree of the head. NULL if the budget ran out.
+ **/
+static pNode searchBest(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+						freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, \
+						DfsBudget* budget, unsigned long depth, pNode* partial)
 { 
 	// a pnode for children list which will hold the childrens.
 	pNode* childrenList = NULL;
@@ -42,57 +250,732 @@ pNode getBest(pNode head, getNodeChildrenFunc getChildren,\
 	//value the get val of head
 	if (head != NULL)
 	{
-		currentBestNode = copy(head);
+		TRACE_CALLBACK(DFS_TRACE_COPY, currentBestNode = copy(head));
 	}
-	unsigned int currentBestValue = getVal(currentBestNode);
+	unsigned int currentBestValue;
+	TRACE_CALLBACK(DFS_TRACE_GET_VAL, currentBestValue = getVal(currentBestNode));
 	// if currentBestValue is equal to best, means in the current node all the board is full in 
 	// numbers that are not 0 than return that board.
 	if (currentBestValue == best)
 	{
 		return currentBestNode;
 	}
+	// the node with the highest value so far is kept for when the budget runs out
+	if (budget != NULL && currentBestNode != NULL && \
+		(*partial == NULL || currentBestValue > budget->bestValue))
+	{
+		if (*partial != NULL)
+		{
+			TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(*partial));
+		}
+		TRACE_CALLBACK(DFS_TRACE_COPY, *partial = copy(currentBestNode));
+		budget->bestValue = currentBestValue;
+	}
+	if (!spendBudget(budget))
+	{
+		TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(currentBestNode));
+		return NULL;
+	}
 
 	// using get children function the get the number of children and put them in the childrenList
-	int numOfChildren = getChildren(head, &childrenList);
+	int numOfChildren;
+	TRACE_CALLBACK(DFS_TRACE_GET_CHILDREN, numOfChildren = getChildren(head, &childrenList));
+	TRACE_NODE(depth, numOfChildren);
 	int i;
 	// a loop running on the number of children and calling get best recursivly for each and every
 	// child
 	for (i = 0; i < numOfChildren; i++)
 	{
-		pNode child = getBest(childrenList[i], getChildren, getVal, freeNode, copy, best);
+		pNode child = searchBest(childrenList[i], getChildren, getVal, freeNode, copy, best, \
+								 budget, depth + 1, partial);
+		// the budget ran out in the subtree of the child, so the search stops
+		if (budget != NULL && budget->status != DFS_STATUS_DONE)
+		{
+			break;
+		}
 		if (child != NULL)
 		{
+			// the value of the child is asked for once, and the value of the current best node is
+			// kept in currentBestValue, since a copy has the value of its original
+			unsigned int childValue;
+			TRACE_CALLBACK(DFS_TRACE_GET_VAL, childValue = getVal(child));
 			// if the val of child is best than copy it to currentBestNode, breaking and return it
-			if (getVal(child) == best)
+			if (childValue == best)
 			{
-				freeNode(currentBestNode);
-				currentBestNode = copy(child);
-				freeNode(child);
+				TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(currentBestNode));
+				TRACE_CALLBACK(DFS_TRACE_COPY, currentBestNode = copy(child));
+				currentBestValue = childValue;
+				TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(child));
 				break;
 			}
 			// if it's value is bigger than the current best node than copy it to the current
 			//best node
-			if (currentBestNode != NULL && getVal(child) >getVal(currentBestNode))
+			if (currentBestNode != NULL && childValue > currentBestValue)
 			{
-				freeNode(currentBestNode);
-				currentBestNode = copy(child);
-				freeNode(child);
+				TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(currentBestNode));
+				TRACE_CALLBACK(DFS_TRACE_COPY, currentBestNode = copy(child));
+				currentBestValue = childValue;
+				TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(child));
 			}
 		}
 	}
 	// free the children list
 	for (i = 0; i < numOfChildren; i++)
 	{
-		freeNode(childrenList[i]);
+		TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(childrenList[i]));
 	}
 	free(childrenList);
 	// in case we finished the DFS and getval of current best node is not best means there's no 
 	// solution for the board return null
-	if (getVal(currentBestNode) != best)
+	if (currentBestValue != best)
 	{
-		freeNode(currentBestNode);
+		TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(currentBestNode));
 		return NULL;
 
 	}
 	return currentBestNode;
 }
+
+/**
+ * @brief getBest This function returns the node with the highest value in the tree, using
+ * DFS algorithm.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory. This function will be called for each
+ * node returned by getChildren.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The highest possible value for a node. When the function encounters a node with that
+ * value, it stops looking and returns it. If the best value can't be determined, pass 
+ * UINT_MAX (defined in limits.h) for that parameter.
+ * @return The node with the highest value in the tree. In case of an error, or when all the nodes
+ * in the tree have a value of zero, the returned node is NULL. If some nodes share the best value,
+ * the function returns the first one it encounters.
+ */	
+pNode getBest(pNode head, getNodeChildrenFunc getChildren,\
+			  getNodeValFunc getVal, freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best)
+{
+	return searchBest(head, getChildren, getVal, freeNode, copy, best, NULL, 0, NULL);
+}
+
+/**
+ * @brief getBestWithBudget This function is getBest that stops when its budget runs out. it keeps
+ * a copy of the node with the highest value it visited so far, so a search that is stopped still
+ * returns the furthest it got.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The value the function looks for.
+ * @param budget The budget of the search, set by initDfsBudget. The search puts its status, the
+ * nodes it expanded and the highest value it visited in it.
+ * @return If the search ended by itself, what getBest returns. If the budget ran out, the node
+ * with the highest value the search visited (the first one, if some nodes share it). Either way
+ * the caller should free the node with freeNode.
+ */
+pNode getBestWithBudget(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+						freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, \
+						DfsBudget* budget)
+{
+	budget->status = DFS_STATUS_DONE;
+	budget->nodesExpanded = 0;
+	budget->bestValue = 0;
+	pNode partial = NULL;
+	pNode found = searchBest(head, getChildren, getVal, freeNode, copy, best, budget, 0, \
+							 &partial);
+	if (found != NULL)
+	{
+		budget->bestValue = best;
+	}
+	else if (budget->status != DFS_STATUS_DONE)
+	{
+		return partial;
+	}
+	if (partial != NULL)
+	{
+		TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(partial));
+	}
+	return found;
+}
+
+/**
+ * a frame of the explicit stack of getBestLazy: a node on the path from the head, the cursor
+ * over its children and the number of children it gave so far.
+ **/
+typedef struct LazyFrame
+{
+	pNode node;
+	long cursor;
+	long children;
+}LazyFrame;
+
+/**
+ * @brief getBestLazy This function returns the node with the highest value in the tree, using
+ * DFS algorithm, like getBest. The children of a node are created one at a time, when the search
+ * gets to them, so the children after the one that leads to the best node are never created,
+ * and the search holds only the nodes of the path from the head.
+ * @param head The head of the tree.
+ * @param getNextChild A function that gets a node and a cursor over its children, and returns
+ * the next child or NULL when there are no more.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory. This function will be called for each
+ * node returned by getNextChild, except the returned node.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The highest possible value for a node. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @return The first node with the best value the function encounters, which the caller should
+ * free with freeNode. If there's no such node, or in case of an error, the returned node is NULL.
+ */
+pNode getBestLazy(pNode head, getNextChildFunc getNextChild, getNodeValFunc getVal, \
+				  freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best)
+{
+	if (head == NULL)
+	{
+		return NULL;
+	}
+	unsigned int value;
+	TRACE_CALLBACK(DFS_TRACE_GET_VAL, value = getVal(head));
+	if (value == best)
+	{
+		pNode found;
+		TRACE_CALLBACK(DFS_TRACE_COPY, found = copy(head));
+		return found;
+	}
+	LazyFrame* stack = (LazyFrame*)malloc(DFS_INITIAL_STACK * sizeof(LazyFrame));
+	if (stack == NULL)
+	{
+		return NULL;
+	}
+	int capacity = DFS_INITIAL_STACK;
+	// the head is the bottom of the stack. it belongs to the caller, so it's never freed
+	int depth = 1;
+	stack[0].node = head;
+	stack[0].cursor = 0;
+	stack[0].children = 0;
+	pNode found = NULL;
+	while (depth > 0)
+	{
+		LazyFrame* frame = &stack[depth - 1];
+		pNode child;
+		TRACE_CALLBACK(DFS_TRACE_GET_NEXT_CHILD, child = getNextChild(frame->node, &frame->cursor));
+		// the node is done, so the search goes back to its parent. it's counted once it's done,
+		// when the number of its children is known
+		if (child == NULL)
+		{
+			TRACE_NODE(depth - 1, (int)frame->children);
+			if (depth > 1)
+			{
+				TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(frame->node));
+			}
+			depth--;
+			continue;
+		}
+		frame->children++;
+		TRACE_CALLBACK(DFS_TRACE_GET_VAL, value = getVal(child));
+		if (value == best)
+		{
+			found = child;
+			break;
+		}
+		if (depth == capacity)
+		{
+			LazyFrame* newStack = (LazyFrame*)realloc(stack, capacity * 2 * sizeof(LazyFrame));
+			if (newStack == NULL)
+			{
+				TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(child));
+				break;
+			}
+			stack = newStack;
+			capacity *= 2;
+		}
+		stack[depth].node = child;
+		stack[depth].cursor = 0;
+		stack[depth].children = 0;
+		depth++;
+	}
+	// the nodes left on the path, but the head
+	for (; depth > 1; depth--)
+	{
+		TRACE_CALLBACK(DFS_TRACE_FREE, freeNode(stack[depth - 1].node));
+	}
+	free(stack);
+	return found;
+}
+
+/**
+ * a frame of the explicit stack of getBestIterative: the moves to the children of a node on the
+ * path from the head, and the index of the move that leads to the child being searched.
+ **/
+typedef struct DfsFrame
+{
+	int* moves;
+	int numOfMoves;
+	int next;
+}DfsFrame;
+
+/**
+ * the workspace of getBestInWorkspace: the frames of its stack, maxMoves moves for every frame and
+ * the best path of its budget.
+ **/
+struct DfsWorkspace
+{
+	int maxDepth;
+	int maxMoves;
+	DfsFrame* frames;
+	int* moves;
+	int* bestPath;
+};
+
+/**
+ * This function is the search of getBestIterative, getBestWithTable and countBest. it walks the
+ * tree from the head by applying moves and undoing them, and counts the nodes with the best
+ * value, which are leaves of the search, until there are limit of them.
+ * input :
+ * 		the parameters of getBestInPlaceWithBudget, and:
+ * 		unsigned long limit - the number of nodes with the best value to stop at. 0 for no limit
+ * 		int keepBest - 1 to leave the head in the state of the node the search stopped at, 0 to
+ * 					   turn it back into its original state
+ * 		unsigned long* count - a pointer to put the number of nodes with the best value in
+ * 		fillNodeMovesFunc fillMoves - the moves function of getBestInWorkspace, used instead of
+ * 									  getMoves if there's a workspace
+ * 		DfsWorkspace* workspace - the workspace of getBestInWorkspace, NULL to allocate the stack
+ * output :
+ * 		the head, if the search stopped at the limit and keepBest is 1, or if the budget ran out
+ * 		(turned into the node with the highest value visited). NULL else.
+ **/
+static pNode walkInPlace(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+						 undoMoveFunc undoMove, getNodeValFunc getVal, getNodeHashFunc getHash, \
+						 TranspositionTable* table, unsigned int best, DfsStats* stats, \
+						 DfsBudget* budget, unsigned long limit, int keepBest, \
+						 unsigned long* count, fillNodeMovesFunc fillMoves, \
+						 DfsWorkspace* workspace)
+{
+	*count = 0;
+	if (budget != NULL)
+	{
+		budget->status = DFS_STATUS_DONE;
+		budget->nodesExpanded = 0;
+		budget->bestValue = 0;
+	}
+	if (stats != NULL)
+	{
+		memset(stats, 0, sizeof(DfsStats));
+	}
+	if (head == NULL)
+	{
+		return NULL;
+	}
+	DfsFrame* stack = NULL;
+	// the moves from the head to the node with the highest value so far, kept only if there's a
+	// budget. it has the capacity of the stack, and its first bestPathShared moves are still the
+	// moves of the path, so a better node copies only the moves after them
+	int* bestPath = NULL;
+	int bestPathLength = 0;
+	int bestPathShared = 0;
+	int capacity = 0;
+	if (workspace != NULL)
+	{
+		stack = workspace->frames;
+		bestPath = workspace->bestPath;
+		capacity = workspace->maxDepth + 1;
+	}
+	// the number of frames - the depth of the node the head is turned into, plus one
+	int depth = 0;
+	// the children generated for the nodes of the path and not searched yet
+	unsigned long pendingChildren = 0;
+	pNode found = NULL;
+	int reachedNode = 1;
+	int failed = FALSE;
+	while (1)
+	{
+		// the head was just turned into a node that wasn't visited yet
+		if (reachedNode)
+		{
+			reachedNode = 0;
+			unsigned int value;
+			TRACE_CALLBACK(DFS_TRACE_GET_VAL, value = getVal(head));
+			if (budget != NULL && value > budget->bestValue)
+			{
+				int i;
+				for (i = bestPathShared; i < depth; i++)
+				{
+					bestPath[i] = stack[i].moves[stack[i].next - 1];
+				}
+				bestPathLength = depth;
+				bestPathShared = depth;
+				budget->bestValue = value;
+			}
+			// a node with the best value is counted, and the search stops at the limit or goes
+			// back to the node's parent
+			if (value == best)
+			{
+				(*count)++;
+				if (*count == limit || depth == 0)
+				{
+					found = (*count == limit && keepBest) ? head : NULL;
+					break;
+				}
+				DfsFrame* parent = &stack[depth - 1];
+				TRACE_CALLBACK(DFS_TRACE_UNDO_MOVE, \
+							   undoMove(head, parent->moves[parent->next - 1]));
+				continue;
+			}
+			// a node that was visited before is not searched again, so the head goes back to its
+			// parent. the head itself is only remembered
+			if (getHash != NULL)
+			{
+				uint64_t hash;
+				TRACE_CALLBACK(DFS_TRACE_GET_HASH, hash = getHash(head));
+				if (checkAndStoreTransposition(table, hash, head) && depth > 0)
+				{
+					DfsFrame* parent = &stack[depth - 1];
+					TRACE_CALLBACK(DFS_TRACE_UNDO_MOVE, \
+								   undoMove(head, parent->moves[parent->next - 1]));
+					continue;
+				}
+			}
+			// the stack of a workspace doesn't grow, so a deeper tree is an error
+			if (depth == capacity && workspace != NULL)
+			{
+				failed = TRUE;
+				break;
+			}
+			if (depth == capacity)
+			{
+				int newCapacity = (capacity == 0) ? DFS_INITIAL_STACK : capacity * 2;
+				DfsFrame* newStack = (DfsFrame*)realloc(stack, newCapacity * sizeof(DfsFrame));
+				if (newStack == NULL)
+				{
+					failed = TRUE;
+					break;
+				}
+				stack = newStack;
+				if (budget != NULL)
+				{
+					int* newPath = (int*)realloc(bestPath, newCapacity * sizeof(int));
+					if (newPath == NULL)
+					{
+						failed = TRUE;
+						break;
+					}
+					bestPath = newPath;
+				}
+				capacity = newCapacity;
+			}
+			if (!spendBudget(budget))
+			{
+				break;
+			}
+			DfsFrame* frame = &stack[depth];
+			frame->moves = NULL;
+			frame->next = 0;
+			// an error (-1) is treated as no children
+			if (workspace != NULL)
+			{
+				frame->moves = workspace->moves + (size_t)depth * workspace->maxMoves;
+				TRACE_CALLBACK(DFS_TRACE_GET_MOVES, \
+							   frame->numOfMoves = fillMoves(head, frame->moves));
+			}
+			else
+			{
+				TRACE_CALLBACK(DFS_TRACE_GET_MOVES, \
+							   frame->numOfMoves = getMoves(head, &frame->moves));
+			}
+			if (frame->numOfMoves < 0)
+			{
+				frame->numOfMoves = 0;
+			}
+			TRACE_NODE(depth, frame->numOfMoves);
+			pendingChildren += frame->numOfMoves;
+			depth++;
+			if (stats != NULL)
+			{
+				if ((unsigned long)depth > stats->peakDepth)
+				{
+					stats->peakDepth = depth;
+				}
+				// the nodes of the path and the children waiting for their turn
+				if (depth + pendingChildren > stats->peakLiveNodes)
+				{
+					stats->peakLiveNodes = depth + pendingChildren;
+				}
+			}
+		}
+		DfsFrame* frame = &stack[depth - 1];
+		// the last child of the node was searched, so the head goes back to the node's parent
+		if (frame->next == frame->numOfMoves)
+		{
+			if (workspace == NULL)
+			{
+				free(frame->moves);
+			}
+			depth--;
+			if (depth == 0)
+			{
+				break;
+			}
+			DfsFrame* parent = &stack[depth - 1];
+			TRACE_CALLBACK(DFS_TRACE_UNDO_MOVE, undoMove(head, parent->moves[parent->next - 1]));
+			continue;
+		}
+		// turning the head into the next child
+		TRACE_CALLBACK(DFS_TRACE_APPLY_MOVE, applyMove(head, frame->moves[frame->next]));
+		frame->next++;
+		if (bestPathShared > depth - 1)
+		{
+			bestPathShared = depth - 1;
+		}
+		pendingChildren--;
+		reachedNode = 1;
+	}
+	// every frame left has the move to its child applied. the head stays in the state of the
+	// best node if it's kept, else (also on an error) the moves are undone on the way out
+	while (depth > 0)
+	{
+		DfsFrame* frame = &stack[depth - 1];
+		if (found == NULL)
+		{
+			TRACE_CALLBACK(DFS_TRACE_UNDO_MOVE, undoMove(head, frame->moves[frame->next - 1]));
+		}
+		if (workspace == NULL)
+		{
+			free(frame->moves);
+		}
+		depth--;
+	}
+	if (workspace == NULL)
+	{
+		free(stack);
+	}
+	if (failed && budget != NULL)
+	{
+		budget->status = DFS_STATUS_FAILED;
+	}
+	// the budget ran out, so the head is turned into the node with the highest value visited
+	if (budget != NULL && budget->status != DFS_STATUS_DONE && !failed)
+	{
+		int i;
+		for (i = 0; i < bestPathLength; i++)
+		{
+			TRACE_CALLBACK(DFS_TRACE_APPLY_MOVE, applyMove(head, bestPath[i]));
+		}
+		found = head;
+	}
+	if (workspace == NULL)
+	{
+		free(bestPath);
+	}
+	return found;
+}
+
+
+/**
+ * @brief getBestIterative This function looks for a node with the best value in the tree, using
+ * DFS algorithm, without recursion and without copying any node. it walks the tree by applying
+ * moves to the head and undoing them on the way back, and keeps the moves of every node on the
+ * path in an explicit stack, so a child exists only as a move until its turn comes and the
+ * memory of the search grows with the depth of the tree only.
+ * @param head The head of the tree. It's changed during the search.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param best The value the function looks for. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @param stats A struct to put the statistics of the search in, NULL if they're not needed.
+ * @return The head itself, turned into the first node with the best value the function
+ * encounters. If there's no such node, or in case of an error, the head is turned back into its
+ * original state and the returned node is NULL.
+ */
+pNode getBestIterative(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+					   undoMoveFunc undoMove, getNodeValFunc getVal, unsigned int best, \
+					   DfsStats* stats)
+{
+	return getBestWithTable(head, getMoves, applyMove, undoMove, getVal, NULL, NULL, best, stats);
+}
+
+/**
+ * @brief getBestWithTable This function is getBestIterative that remembers the nodes it visited
+ * in a transposition table, by their hashes and keys, and doesn't search the subtree of a node it
+ * already visited once more. a node it visited before was either searched all the way without
+ * finding the best value, or is on the path to the node being visited.
+ * @param head The head of the tree. It's changed during the search.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param getHash A function that gets a node and returns its hash. NULL to search without the
+ * table.
+ * @param table The transposition table. It should be cleared before searching another tree.
+ * @param best The value the function looks for. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @param stats A struct to put the statistics of the search in, NULL if they're not needed.
+ * @return The head itself, turned into the first node with the best value the function
+ * encounters. If there's no such node, or in case of an error, the head is turned back into its
+ * original state and the returned node is NULL.
+ */
+pNode getBestWithTable(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+					   undoMoveFunc undoMove, getNodeValFunc getVal, getNodeHashFunc getHash, \
+					   TranspositionTable* table, unsigned int best, DfsStats* stats)
+{
+	return getBestInPlaceWithBudget(head, getMoves, applyMove, undoMove, getVal, getHash, table, \
+									best, stats, NULL);
+}
+
+/**
+ * @brief countBest This function counts the nodes with the best value in the tree, using DFS
+ * algorithm in place like getBestIterative, without copying any of them. a node with the best
+ * value is not searched any deeper, and the count stops as soon as it gets to the limit, so a
+ * limit of 2 tells a tree with one node with the best value from a tree with more at about the
+ * cost of finding one.
+ * @param head The head of the tree. It's changed during the count and turned back into its
+ * original state at the end.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param best The value of the counted nodes.
+ * @param limit The count to stop at. 0 for no limit.
+ * @return The number of nodes with the best value, up to the limit. In case of an error, the
+ * number of nodes counted until then.
+ */
+unsigned long countBest(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+						undoMoveFunc undoMove, getNodeValFunc getVal, unsigned int best, \
+						unsigned long limit)
+{
+	unsigned long count;
+	walkInPlace(head, getMoves, applyMove, undoMove, getVal, NULL, NULL, best, NULL, NULL, limit, \
+				FALSE, &count, NULL, NULL);
+	return count;
+}
+
+/**
+ * @brief getBestInPlace This function looks for a node with the best value in the tree, using
+ * DFS algorithm, without copying any node: it walks the tree by applying moves to the head and
+ * undoing them on the way back. It's getBestIterative without the statistics.
+ * @param head The head of the tree. It's changed during the search.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param best The value the function looks for. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @return The head itself, turned into the first node with the best value the function
+ * encounters. If there's no such node, or in case of an error, the head is turned back into its
+ * original state and the returned node is NULL.
+ */
+pNode getBestInPlace(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+					 undoMoveFunc undoMove, getNodeValFunc getVal, unsigned int best)
+{
+	return getBestIterative(head, getMoves, applyMove, undoMove, getVal, best, NULL);
+}
+
+/**
+ * @brief getBestInPlaceWithBudget This function is getBestWithTable that stops when its budget
+ * runs out. it keeps the moves that lead from the head to the node with the highest value it
+ * visited so far, and when it's stopped it undoes its path and applies them, so the head is
+ * turned into the furthest node it got to without copying any node.
+ * @param head The head of the tree. It's changed during the search.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move. Applying the
+ * same moves to the head again must turn it into the same node.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param getHash A function that gets a node and returns its hash. NULL to search without the
+ * table.
+ * @param table The transposition table. It should be cleared before searching another tree.
+ * @param best The value the function looks for.
+ * @param stats A struct to put the statistics of the search in, NULL if they're not needed.
+ * @param budget The budget of the search, set by initDfsBudget. The search puts its status, the
+ * nodes it expanded and the highest value it visited in it.
+ * @return If the search ended by itself, what getBestWithTable returns. If the budget ran out,
+ * the head itself, turned into the node with the highest value the search visited (the first
+ * one, if some nodes share it). In case of an error, NULL with DFS_STATUS_FAILED.
+ */
+pNode getBestInPlaceWithBudget(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+							   undoMoveFunc undoMove, getNodeValFunc getVal, \
+							   getNodeHashFunc getHash, TranspositionTable* table, \
+							   unsigned int best, DfsStats* stats, DfsBudget* budget)
+{
+	unsigned long count;
+	return walkInPlace(head, getMoves, applyMove, undoMove, getVal, getHash, table, best, stats, \
+					   budget, 1, TRUE, &count, NULL, NULL);
+}
+
+/**
+ * @brief createDfsWorkspace This function creates the workspace of an in place search.
+ * @param maxDepth The most moves on a path from the head of a tree to a node.
+ * @param maxMoves The most moves of a node.
+ * @return The workspace, NULL if memory allocation failed.
+ */
+DfsWorkspace* createDfsWorkspace(int maxDepth, int maxMoves)
+{
+	DfsWorkspace* workspace = (DfsWorkspace*)malloc(sizeof(DfsWorkspace));
+	if (workspace == NULL)
+	{
+		return NULL;
+	}
+	// a frame for every node on the deepest path, its last node (which has no moves) included
+	workspace->maxDepth = maxDepth;
+	workspace->maxMoves = maxMoves;
+	workspace->frames = (DfsFrame*)malloc((maxDepth + 1) * sizeof(DfsFrame));
+	workspace->moves = (int*)malloc((size_t)(maxDepth + 1) * maxMoves * sizeof(int));
+	workspace->bestPath = (int*)malloc((maxDepth + 1) * sizeof(int));
+	if (workspace->frames == NULL || workspace->moves == NULL || workspace->bestPath == NULL)
+	{
+		freeDfsWorkspace(workspace);
+		return NULL;
+	}
+	return workspace;
+}
+
+/**
+ * @brief freeDfsWorkspace This function frees a workspace from memory.
+ * @param workspace The workspace.
+ */
+void freeDfsWorkspace(DfsWorkspace* workspace)
+{
+	if (workspace == NULL)
+	{
+		return;
+	}
+	free(workspace->frames);
+	free(workspace->moves);
+	free(workspace->bestPath);
+	free(workspace);
+}
+
+/**
+ * @brief getBestInWorkspace This function is getBestInPlaceWithBudget without a table, that keeps
+ * its stack and the moves of the nodes on its path in a workspace instead of allocating them, so
+ * it makes no allocation at all.
+ * @param head The head of the tree. It's changed during the search.
+ * @param fillMoves A function that gets a node and an array of moves, with room for the maxMoves
+ * of the workspace, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move. Applying the
+ * same moves to the head again must turn it into the same node.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param best The value the function looks for.
+ * @param budget The budget of the search, set by initDfsBudget. NULL for none.
+ * @param workspace The workspace. A tree deeper than its maxDepth is an error.
+ * @return What getBestInPlaceWithBudget returns.
+ */
+pNode getBestInWorkspace(pNode head, fillNodeMovesFunc fillMoves, applyMoveFunc applyMove, \
+						 undoMoveFunc undoMove, getNodeValFunc getVal, unsigned int best, \
+						 DfsBudget* budget, DfsWorkspace* workspace)
+{
+	unsigned long count;
+	return walkInPlace(head, NULL, applyMove, undoMove, getVal, NULL, NULL, best, NULL, budget, \
+					   1, TRUE, &count, fillMoves, workspace);
+}
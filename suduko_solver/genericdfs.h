@@ -0,0 +1,574 @@
+/**
+ ===================================================================================================
+ Name        : genericdfs.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for genericdfs.c, genericdfsparallel.c,
+ * 			   genericdfsbestfirst.c and genericdfstable.c
+ ===================================================================================================
+ **/
+
+#ifndef genericdfs_H
+#define genericdfs_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+//********      consts
+// the callbacks a trace counts the calls and cycles of, as the indexes of its arrays
+#define DFS_TRACE_GET_CHILDREN 0
+#define DFS_TRACE_GET_NEXT_CHILD 1
+#define DFS_TRACE_GET_MOVES 2
+#define DFS_TRACE_APPLY_MOVE 3
+#define DFS_TRACE_UNDO_MOVE 4
+#define DFS_TRACE_GET_VAL 5
+#define DFS_TRACE_COPY 6
+#define DFS_TRACE_FREE 7
+#define DFS_TRACE_GET_HASH 8
+#define DFS_TRACE_CALLBACKS 9
+// the depths a trace keeps apart. the nodes of deeper levels are counted in the last one
+#define DFS_TRACE_MAX_DEPTH 4096
+// the status of a search with a budget: it ended by itself (it found a node with the best value
+// or searched the whole tree), it stopped when a limit of the budget ran out, or it failed since
+// memory allocation failed or the tree was deeper than its workspace
+#define DFS_STATUS_DONE 0
+#define DFS_STATUS_NODE_LIMIT 1
+#define DFS_STATUS_DEADLINE 2
+#define DFS_STATUS_CANCELLED 3
+#define DFS_STATUS_FAILED 4
+// no limit on the nodes of a budget, and no deadline
+#define DFS_NO_LIMIT 0
+
+//********      types and functions types
+/**
+ * a node of the searched tree. the library never looks inside it, only passes it to the callbacks
+ **/
+typedef void* pNode;
+
+/**
+ * @brief getNodeChildrenFunc A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ */
+typedef int(*getNodeChildrenFunc)(pNode, pNode**);
+
+/**
+ * @brief getNextChildFunc A function that gets a node and a cursor over its children, creates
+ * the child the cursor points to, moves the cursor past it and returns the child. The cursor
+ * starts as 0 for the first child and means nothing to the library. Once there are no more
+ * children (the node is done) the returned value is NULL. The node doesn't change between the
+ * calls.
+ */
+typedef pNode(*getNextChildFunc)(pNode, long*);
+
+/**
+ * @brief getNodeValFunc A function that gets a node and returns its value, as int.
+ * The search asks for the value of every node it visits, so the function should return a value
+ * the node keeps up to date as it's built (and a copy of a node has the value of its original),
+ * rather than calculate it from the whole node.
+ */
+typedef unsigned int(*getNodeValFunc)(pNode);
+
+/**
+ * @brief freeNodeFunc A function that frees a node from memory.
+ */
+typedef void(*freeNodeFunc)(pNode);
+
+/**
+ * @brief copyNodeFunc A function that does a deep copy of a node.
+ */
+typedef pNode(*copyNodeFunc)(pNode);
+
+/**
+ * @brief getNodeMovesFunc A function that gets a node and a pointer to an array of moves.
+ * The function allocates memory for an array of all the moves that lead from the node to its
+ * children, populate it, and returns it using the second parameter. The returned value is the
+ * number of moves, -1 on an error.
+ */
+typedef int(*getNodeMovesFunc)(pNode, int**);
+
+/**
+ * @brief fillNodeMovesFunc A function that gets a node and an array of moves, with room for the
+ * most moves a node of the tree has. The function puts the moves that lead from the node to its
+ * children in the array, and returns their number, -1 on an error.
+ */
+typedef int(*fillNodeMovesFunc)(pNode, int*);
+
+/**
+ * @brief applyMoveFunc A function that turns a node into its child by applying one of the moves
+ * returned for it by getNodeMovesFunc.
+ */
+typedef void(*applyMoveFunc)(pNode, int);
+
+/**
+ * @brief undoMoveFunc A function that turns a child back into its parent by undoing the move that
+ * was the last one applied to it.
+ */
+typedef void(*undoMoveFunc)(pNode, int);
+
+/**
+ * @brief getNodeHashFunc A function that gets a node and returns a 64 bit hash of it. Nodes that
+ * are the same must have the same hash, and different nodes should have different ones.
+ */
+typedef uint64_t(*getNodeHashFunc)(pNode);
+
+/**
+ * @brief getNodeKeyFunc A function that gets a node and returns a pointer to its key: bytes that
+ * are the same for nodes that are the same and different for different ones, like the node's
+ * state itself. The key of every node of a tree has the same number of bytes.
+ */
+typedef const void*(*getNodeKeyFunc)(pNode);
+
+//********      structs
+/**
+ * a fixed size table of the nodes a search visited. a node's hash and key are kept in one entry
+ * picked by the low bits of the hash, and replace the node that was there. a node is found by its
+ * hash and then its whole key, so nodes whose hashes collide are never taken for each other. the
+ * entries are read and written without locks, so one table can be shared by searches on several
+ * threads.
+ **/
+typedef struct TranspositionTable TranspositionTable;
+
+/**
+ * the memory of an in place search, allocated once for the deepest tree and the most moves of a
+ * node it's made for, so getBestInWorkspace can search any number of trees without allocating.
+ * one workspace is used by one search at a time.
+ **/
+typedef struct DfsWorkspace DfsWorkspace;
+
+/**
+ * struct for the statistics of a transposition table.
+ * unsigned long lookups - the number of hashes looked for in the table
+ * unsigned long hits - the number of hashes that were found in it, with the same key
+ * unsigned long collisions - the number of hashes that were found in it with another key
+ * unsigned long replaced - the number of hashes stored in place of another one
+ **/
+typedef struct TranspositionStats
+{
+	unsigned long lookups;
+	unsigned long hits;
+	unsigned long collisions;
+	unsigned long replaced;
+}TranspositionStats;
+
+/**
+ * struct for the statistics of a search by getBestIterative.
+ * unsigned long peakDepth - the most nodes that were on the path from the head at once, the head
+ * included
+ * unsigned long peakLiveNodes - the most nodes the search held at once: the nodes of the path and
+ * the children generated for them and not searched yet (which the search holds as moves only)
+ **/
+typedef struct DfsStats
+{
+	unsigned long peakDepth;
+	unsigned long peakLiveNodes;
+}DfsStats;
+
+/**
+ * struct for the trace of the searches of a thread, see startDfsTrace.
+ * unsigned long nodesExpanded - the number of nodes whose children (or moves) were asked for
+ * unsigned long peakDepth - the depth of the deepest node expanded, the head being at depth 0
+ * unsigned long nodesAtDepth - the number of nodes expanded at every depth
+ * unsigned long childrenAtDepth - the number of children the nodes of every depth had, so
+ * childrenAtDepth / nodesAtDepth is the branching factor of the depth
+ * unsigned long callbackCalls - the number of calls of every callback, by the DFS_TRACE_ consts
+ * uint64_t callbackCycles - the cycles (the time stamp counter, or nanoseconds where there's no
+ * such counter) spent in every callback
+ **/
+typedef struct DfsTrace
+{
+	unsigned long nodesExpanded;
+	unsigned long peakDepth;
+	unsigned long nodesAtDepth[DFS_TRACE_MAX_DEPTH];
+	unsigned long childrenAtDepth[DFS_TRACE_MAX_DEPTH];
+	unsigned long callbackCalls[DFS_TRACE_CALLBACKS];
+	uint64_t callbackCycles[DFS_TRACE_CALLBACKS];
+}DfsTrace;
+
+/**
+ * struct for the budget of a search, see initDfsBudget. the limits are set before the search, and
+ * the search puts how far it got in the rest.
+ * unsigned long maxNodes - the most nodes the search may expand, DFS_NO_LIMIT for no limit
+ * uint64_t deadline - the time (of CLOCK_MONOTONIC, in nanoseconds) the search must stop at,
+ * DFS_NO_LIMIT for no deadline
+ * atomic_int cancelled - set by cancelDfsSearch, from any thread
+ * int status - the DFS_STATUS_ the search ended with
+ * unsigned long nodesExpanded - the number of nodes the search expanded
+ * unsigned int bestValue - the highest value of a node the search visited
+ **/
+typedef struct DfsBudget
+{
+	unsigned long maxNodes;
+	uint64_t deadline;
+	atomic_int cancelled;
+	int status;
+	unsigned long nodesExpanded;
+	unsigned int bestValue;
+}DfsBudget;
+
+//********      functions
+/**
+ * @brief startDfsTrace This function zeroes a trace and makes the searches of the calling thread
+ * record into it: getBest, getBestLazy and the in place searches (getBestIterative,
+ * getBestWithTable, countBest and getBestInPlace). the searches of other threads, like the
+ * workers of getBestParallel, are not traced. The counters are compiled in only when the library
+ * is built with DFS_TRACE defined, so a build without it pays nothing for them.
+ * @param trace The trace, NULL to stop tracing.
+ * @return 1 if the searches are traced, 0 if the library was built without DFS_TRACE (the trace
+ * is still zeroed) or trace is NULL.
+ */
+int startDfsTrace(DfsTrace* trace);
+
+/**
+ * @brief printDfsTrace This function prints a trace: the nodes expanded, the nodes and the
+ * branching factor of every depth, and the calls and cycles of every callback that was called.
+ * @param output The stream to print to.
+ * @param trace The trace.
+ */
+void printDfsTrace(FILE* output, DfsTrace* trace);
+
+/**
+ * @brief initDfsBudget This function sets the limits of a budget and clears its cancellation. A
+ * search with the budget stops when it expanded maxNodes nodes, when the timeout passed since
+ * this call or when cancelDfsSearch is called, whichever comes first. The deadline is checked
+ * once every few nodes, so the search can run over it by the time of expanding them.
+ * @param budget The budget.
+ * @param maxNodes The most nodes the search may expand, DFS_NO_LIMIT for no limit.
+ * @param timeoutMillis The milliseconds the search may take, DFS_NO_LIMIT for no deadline.
+ */
+void initDfsBudget(DfsBudget* budget, unsigned long maxNodes, unsigned long timeoutMillis);
+
+/**
+ * @brief cancelDfsSearch This function makes the search with a budget stop, as soon as it gets to
+ * its next node, with DFS_STATUS_CANCELLED. It can be called from any thread, also before the
+ * search starts.
+ * @param budget The budget of the search.
+ */
+void cancelDfsSearch(DfsBudget* budget);
+
+/**
+ * @brief getBest This function returns the node with the highest value in the tree, using
+ * DFS algorithm.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory. This function will be called for each
+ * node returned by getChildren.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The highest possible value for a node. When the function encounters a node with that
+ * value, it stops looking and returns it. If the best value can't be determined, pass
+ * UINT_MAX (defined in limits.h) for that parameter.
+ * @return The node with the highest value in the tree. In case of an error, or when all the nodes
+ * in the tree have a value of zero, the returned node is NULL. If some nodes share the best value,
+ * the function returns the first one it encounters.
+ */
+pNode getBest(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+			  freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best);
+
+/**
+ * @brief getBestWithBudget This function is getBest that stops when its budget runs out. it keeps
+ * a copy of the node with the highest value it visited so far, so a search that is stopped still
+ * returns the furthest it got.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The value the function looks for.
+ * @param budget The budget of the search, set by initDfsBudget. The search puts its status, the
+ * nodes it expanded and the highest value it visited in it.
+ * @return If the search ended by itself, what getBest returns. If the budget ran out, the node
+ * with the highest value the search visited (the first one, if some nodes share it). Either way
+ * the caller should free the node with freeNode.
+ */
+pNode getBestWithBudget(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+						freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, \
+						DfsBudget* budget);
+
+/**
+ * @brief getBestLazy This function returns the node with the highest value in the tree, using
+ * DFS algorithm, like getBest. The children of a node are created one at a time, when the search
+ * gets to them, so the children after the one that leads to the best node are never created,
+ * and the search holds only the nodes of the path from the head.
+ * @param head The head of the tree.
+ * @param getNextChild A function that gets a node and a cursor over its children, and returns
+ * the next child or NULL when there are no more.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory. This function will be called for each
+ * node returned by getNextChild, except the returned node.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The highest possible value for a node. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @return The first node with the best value the function encounters, which the caller should
+ * free with freeNode. If there's no such node, or in case of an error, the returned node is NULL.
+ */
+pNode getBestLazy(pNode head, getNextChildFunc getNextChild, getNodeValFunc getVal, \
+				  freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best);
+
+/**
+ * @brief getBestIterative This function looks for a node with the best value in the tree, using
+ * DFS algorithm, without recursion and without copying any node. it walks the tree by applying
+ * moves to the head and undoing them on the way back, and keeps the moves of every node on the
+ * path in an explicit stack, so a child exists only as a move until its turn comes and the
+ * memory of the search grows with the depth of the tree only.
+ * @param head The head of the tree. It's changed during the search.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param best The value the function looks for. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @param stats A struct to put the statistics of the search in, NULL if they're not needed.
+ * @return The head itself, turned into the first node with the best value the function
+ * encounters. If there's no such node, or in case of an error, the head is turned back into its
+ * original state and the returned node is NULL.
+ */
+pNode getBestIterative(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+					   undoMoveFunc undoMove, getNodeValFunc getVal, unsigned int best, \
+					   DfsStats* stats);
+
+/**
+ * @brief getBestWithTable This function is getBestIterative that remembers the nodes it visited
+ * in a transposition table, by their hashes and keys, and doesn't search the subtree of a node it
+ * already visited once more. a node it visited before was either searched all the way without
+ * finding the best value, or is on the path to the node being visited.
+ * @param head The head of the tree. It's changed during the search.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param getHash A function that gets a node and returns its hash. NULL to search without the
+ * table.
+ * @param table The transposition table. It should be cleared before searching another tree.
+ * @param best The value the function looks for. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @param stats A struct to put the statistics of the search in, NULL if they're not needed.
+ * @return The head itself, turned into the first node with the best value the function
+ * encounters. If there's no such node, or in case of an error, the head is turned back into its
+ * original state and the returned node is NULL.
+ */
+pNode getBestWithTable(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+					   undoMoveFunc undoMove, getNodeValFunc getVal, getNodeHashFunc getHash, \
+					   TranspositionTable* table, unsigned int best, DfsStats* stats);
+
+/**
+ * @brief countBest This function counts the nodes with the best value in the tree, using DFS
+ * algorithm in place like getBestIterative, without copying any of them. a node with the best
+ * value is not searched any deeper, and the count stops as soon as it gets to the limit, so a
+ * limit of 2 tells a tree with one node with the best value from a tree with more at about the
+ * cost of finding one.
+ * @param head The head of the tree. It's changed during the count and turned back into its
+ * original state at the end.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param best The value of the counted nodes.
+ * @param limit The count to stop at. 0 for no limit.
+ * @return The number of nodes with the best value, up to the limit. In case of an error, the
+ * number of nodes counted until then.
+ */
+unsigned long countBest(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+						undoMoveFunc undoMove, getNodeValFunc getVal, unsigned int best, \
+						unsigned long limit);
+
+/**
+ * @brief getBestInPlace This function looks for a node with the best value in the tree, using
+ * DFS algorithm, without copying any node: it walks the tree by applying moves to the head and
+ * undoing them on the way back. It's getBestIterative without the statistics.
+ * @param head The head of the tree. It's changed during the search.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param best The value the function looks for. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @return The head itself, turned into the first node with the best value the function
+ * encounters. If there's no such node, or in case of an error, the head is turned back into its
+ * original state and the returned node is NULL.
+ */
+pNode getBestInPlace(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+					 undoMoveFunc undoMove, getNodeValFunc getVal, unsigned int best);
+
+/**
+ * @brief getBestInPlaceWithBudget This function is getBestWithTable that stops when its budget
+ * runs out. it keeps the moves that lead from the head to the node with the highest value it
+ * visited so far, and when it's stopped it undoes its path and applies them, so the head is
+ * turned into the furthest node it got to without copying any node.
+ * @param head The head of the tree. It's changed during the search.
+ * @param getMoves A function that gets a node and a pointer to an array of moves, allocates the
+ * array, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move. Applying the
+ * same moves to the head again must turn it into the same node.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param getHash A function that gets a node and returns its hash. NULL to search without the
+ * table.
+ * @param table The transposition table. It should be cleared before searching another tree.
+ * @param best The value the function looks for.
+ * @param stats A struct to put the statistics of the search in, NULL if they're not needed.
+ * @param budget The budget of the search, set by initDfsBudget. The search puts its status, the
+ * nodes it expanded and the highest value it visited in it.
+ * @return If the search ended by itself, what getBestWithTable returns. If the budget ran out,
+ * the head itself, turned into the node with the highest value the search visited (the first
+ * one, if some nodes share it). In case of an error, NULL with DFS_STATUS_FAILED.
+ */
+pNode getBestInPlaceWithBudget(pNode head, getNodeMovesFunc getMoves, applyMoveFunc applyMove, \
+							   undoMoveFunc undoMove, getNodeValFunc getVal, \
+							   getNodeHashFunc getHash, TranspositionTable* table, \
+							   unsigned int best, DfsStats* stats, DfsBudget* budget);
+
+/**
+ * @brief getBestParallel This function looks for a node with the best value in the tree, using
+ * DFS algorithm on several threads. every thread searches depth first from its own deque of
+ * subtrees and steals subtrees from the others when it runs out of work, and all the threads
+ * stop as soon as one of them finds a node with the best value. the callbacks are called from
+ * all the threads at once, so they must be thread safe.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The value the function looks for.
+ * @param numOfThreads The number of threads to search with. 0 or less uses one thread per online
+ * processor.
+ * @return A node with the best value, which the caller should free with freeNode. If there's no
+ * such node, or in case of an error, the returned node is NULL. When several nodes have the best
+ * value, any of them may be returned.
+ */
+pNode getBestParallel(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+					  freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, \
+					  int numOfThreads);
+
+/**
+ * @brief getBestFirst This function looks for the node with the highest value in the tree, using
+ * best first search: it always expands the waiting node with the highest value.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The highest possible value for a node. When the function encounters a node with that
+ * value, it stops looking and returns it. If the best value can't be determined, pass
+ * UINT_MAX (defined in limits.h) for that parameter.
+ * @param maxNodes The most nodes that may wait to be expanded at once. children that don't fit
+ * are dropped with their subtrees. 0 for no limit.
+ * @return The node with the highest value the search encountered, which the caller should free
+ * with freeNode. If some nodes share that value, the first one encountered is returned. When all
+ * the nodes encountered have a value of zero, or the head is NULL, the returned node is NULL.
+ */
+pNode getBestFirst(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+				   freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, size_t maxNodes);
+
+/**
+ * @brief getBestBeam This function looks for the node with the highest value in the tree, using
+ * beam search: it goes down the tree one level at a time, and keeps only the beamWidth children
+ * with the highest values of every level to expand in the next one.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The highest possible value for a node. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @param beamWidth The number of nodes kept in every level, which bounds the memory of the
+ * search by about twice as many nodes.
+ * @return The node with the highest value the search encountered, which the caller should free
+ * with freeNode. If some nodes share that value, the first one encountered is returned. When all
+ * the nodes encountered have a value of zero, or the head is NULL or beamWidth is less than 1,
+ * the returned node is NULL.
+ */
+pNode getBestBeam(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+				  freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, int beamWidth);
+
+/**
+ * @brief createDfsWorkspace This function creates the workspace of an in place search.
+ * @param maxDepth The most moves on a path from the head of a tree to a node.
+ * @param maxMoves The most moves of a node.
+ * @return The workspace, NULL if memory allocation failed.
+ */
+DfsWorkspace* createDfsWorkspace(int maxDepth, int maxMoves);
+
+/**
+ * @brief freeDfsWorkspace This function frees a workspace from memory.
+ * @param workspace The workspace.
+ */
+void freeDfsWorkspace(DfsWorkspace* workspace);
+
+/**
+ * @brief getBestInWorkspace This function is getBestInPlaceWithBudget without a table, that keeps
+ * its stack and the moves of the nodes on its path in a workspace instead of allocating them, so
+ * it makes no allocation at all.
+ * @param head The head of the tree. It's changed during the search.
+ * @param fillMoves A function that gets a node and an array of moves, with room for the maxMoves
+ * of the workspace, populate it and returns the number of moves.
+ * @param applyMove A function that turns a node into its child by applying a move. Applying the
+ * same moves to the head again must turn it into the same node.
+ * @param undoMove A function that undoes the last move applied to a node.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param best The value the function looks for.
+ * @param budget The budget of the search, set by initDfsBudget. NULL for none.
+ * @param workspace The workspace. A tree deeper than its maxDepth is an error.
+ * @return What getBestInPlaceWithBudget returns.
+ */
+pNode getBestInWorkspace(pNode head, fillNodeMovesFunc fillMoves, applyMoveFunc applyMove, \
+						 undoMoveFunc undoMove, getNodeValFunc getVal, unsigned int best, \
+						 DfsBudget* budget, DfsWorkspace* workspace);
+
+/**
+ * @brief createTranspositionTable This function creates an empty transposition table.
+ * @param numOfEntries The number of entries of the table. It's rounded up to a power of two.
+ * @param getKey A function that gets a node and returns its key.
+ * @param keyBytes The number of bytes of the key of every node.
+ * @return The table, NULL if memory allocation failed.
+ */
+TranspositionTable* createTranspositionTable(size_t numOfEntries, getNodeKeyFunc getKey, \
+											 size_t keyBytes);
+
+/**
+ * @brief clearTranspositionTable This function empties a transposition table and zeroes its
+ * statistics. no search may use the table at the same time.
+ * @param table The table.
+ */
+void clearTranspositionTable(TranspositionTable* table);
+
+/**
+ * @brief freeTranspositionTable This function frees a transposition table from memory.
+ * @param table The table.
+ */
+void freeTranspositionTable(TranspositionTable* table);
+
+/**
+ * @brief checkAndStoreTransposition This function looks for a node in a transposition table, by
+ * its hash and then its key, and stores it there if it's not found.
+ * @param table The table.
+ * @param hash The hash of the node.
+ * @param node The node.
+ * @return 1 if the node was in the table, 0 else.
+ */
+int checkAndStoreTransposition(TranspositionTable* table, uint64_t hash, pNode node);
+
+/**
+ * @brief getTranspositionStats This function returns the statistics of a transposition table
+ * since it was created or cleared.
+ * @param table The table.
+ * @return The statistics.
+ */
+TranspositionStats getTranspositionStats(TranspositionTable* table);
+
+#endif // genericdfs_H
@@ -0,0 +1,411 @@
+/**
+ ===================================================================================================
+ Name        : genericdfsbestfirst.c
+ Author      : Yinnon Bratspiess
+ Description : This file is a construction of best first and beam searches over the same generic
+ * 			   trees the DFS searches, for trees whose getVal is a heuristic score rather than a
+ * 			   count of how much of the node is done.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "genericdfs.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define INITIAL_HEAP_CAPACITY 64
+// the orders of a heap: the node that comes out first is the best one, or the worst one
+#define BEST_FIRST 0
+#define WORST_FIRST 1
+
+// -------------------------- structs -----------------------------------
+/**
+ * a node waiting in a heap, its value and the order it was pushed in.
+ **/
+typedef struct HeapEntry
+{
+	pNode node;
+	unsigned int value;
+	unsigned long order;
+}HeapEntry;
+
+/**
+ * a binary heap of nodes. a BEST_FIRST heap pops the node with the highest value, and of nodes
+ * with the same value the one pushed last, so a tree whose values are all the same is searched
+ * depth first. a WORST_FIRST heap pops in the opposite order.
+ **/
+typedef struct NodeHeap
+{
+	HeapEntry* entries;
+	size_t size;
+	size_t capacity;
+	int kind;
+	unsigned long pushed;
+}NodeHeap;
+
+/**
+ * the best node a search found so far, kept as a copy since the node itself is freed once it's
+ * expanded.
+ **/
+typedef struct BestSoFar
+{
+	pNode node;
+	unsigned int value;
+}BestSoFar;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function checks if an entry comes out of a heap before another one.
+ * input :
+ * 		NodeHeap* heap - the heap
+ * 		HeapEntry* first - an entry
+ * 		HeapEntry* second - another entry
+ * output :
+ * 		1 if first comes out before second, 0 else.
+ **/
+static int comesFirst(NodeHeap* heap, HeapEntry* first, HeapEntry* second)
+{
+	int better = (first->value > second->value) || \
+				 (first->value == second->value && first->order > second->order);
+	return (heap->kind == BEST_FIRST) ? better : !better;
+}
+
+/**
+ * This function pushes a node to a heap, growing it if it's full.
+ * input :
+ * 		NodeHeap* heap - the heap
+ * 		pNode node - the node
+ * 		unsigned int value - the value of the node
+ * output :
+ * 		1 if the node was pushed, 0 if memory allocation failed.
+ **/
+static int heapPush(NodeHeap* heap, pNode node, unsigned int value)
+{
+	if (heap->size == heap->capacity)
+	{
+		size_t newCapacity = (heap->capacity == 0) ? INITIAL_HEAP_CAPACITY : heap->capacity * 2;
+		HeapEntry* newEntries = (HeapEntry*)realloc(heap->entries, \
+													newCapacity * sizeof(HeapEntry));
+		if (newEntries == NULL)
+		{
+			return FALSE;
+		}
+		heap->entries = newEntries;
+		heap->capacity = newCapacity;
+	}
+	HeapEntry entry = {node, value, heap->pushed};
+	heap->pushed++;
+	// sift the new entry up from the last leaf
+	size_t i = heap->size;
+	heap->size++;
+	while (i > 0 && comesFirst(heap, &entry, &heap->entries[(i - 1) / 2]))
+	{
+		heap->entries[i] = heap->entries[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap->entries[i] = entry;
+	return TRUE;
+}
+
+/**
+ * This function takes the first entry out of a non empty heap.
+ * input :
+ * 		NodeHeap* heap - the heap
+ * output :
+ * 		the entry.
+ **/
+static HeapEntry heapPop(NodeHeap* heap)
+{
+	HeapEntry first = heap->entries[0];
+	heap->size--;
+	HeapEntry last = heap->entries[heap->size];
+	// sift the last entry down from the root
+	size_t i = 0;
+	while (2 * i + 1 < heap->size)
+	{
+		size_t child = 2 * i + 1;
+		if (child + 1 < heap->size && comesFirst(heap, &heap->entries[child + 1], \
+												 &heap->entries[child]))
+		{
+			child++;
+		}
+		if (!comesFirst(heap, &heap->entries[child], &last))
+		{
+			break;
+		}
+		heap->entries[i] = heap->entries[child];
+		i = child;
+	}
+	if (heap->size > 0)
+	{
+		heap->entries[i] = last;
+	}
+	return first;
+}
+
+/**
+ * This function frees the nodes left in a heap and the heap's memory.
+ * input :
+ * 		NodeHeap* heap - the heap
+ * 		freeNodeFunc freeNode - the function that frees a node
+ * output :
+ * 		void
+ **/
+static void freeHeap(NodeHeap* heap, freeNodeFunc freeNode)
+{
+	size_t i;
+	for (i = 0; i < heap->size; i++)
+	{
+		freeNode(heap->entries[i].node);
+	}
+	free(heap->entries);
+	heap->entries = NULL;
+	heap->size = 0;
+	heap->capacity = 0;
+}
+
+/**
+ * This function keeps a copy of a node if its value is higher than the best value so far.
+ * input :
+ * 		BestSoFar* bestSoFar - the best node so far
+ * 		pNode node - the node
+ * 		unsigned int value - the value of the node
+ * 		freeNodeFunc freeNode - the function that frees a node
+ * 		copyNodeFunc copy - the function that copies a node
+ * output :
+ * 		void
+ **/
+static void updateBest(BestSoFar* bestSoFar, pNode node, unsigned int value, \
+					   freeNodeFunc freeNode, copyNodeFunc copy)
+{
+	if (bestSoFar->node != NULL && value <= bestSoFar->value)
+	{
+		return;
+	}
+	pNode nodeCopy = copy(node);
+	if (nodeCopy == NULL)
+	{
+		return;
+	}
+	if (bestSoFar->node != NULL)
+	{
+		freeNode(bestSoFar->node);
+	}
+	bestSoFar->node = nodeCopy;
+	bestSoFar->value = value;
+}
+
+/**
+ * This function returns the best node a search found, or NULL if all the nodes it saw have a
+ * value of zero.
+ * input :
+ * 		BestSoFar* bestSoFar - the best node so far
+ * 		freeNodeFunc freeNode - the function that frees a node
+ * output :
+ * 		the node
+ **/
+static pNode finishBest(BestSoFar* bestSoFar, freeNodeFunc freeNode)
+{
+	if (bestSoFar->node != NULL && bestSoFar->value == 0)
+	{
+		freeNode(bestSoFar->node);
+		return NULL;
+	}
+	return bestSoFar->node;
+}
+
+/**
+ * This function frees the children of an array from a given index on, and the array.
+ * input :
+ * 		pNode* childrenList - the array
+ * 		int from - the first child to free
+ * 		int numOfChildren - the number of children in the array
+ * 		freeNodeFunc freeNode - the function that frees a node
+ * output :
+ * 		void
+ **/
+static void freeChildren(pNode* childrenList, int from, int numOfChildren, freeNodeFunc freeNode)
+{
+	int i;
+	for (i = from; i < numOfChildren; i++)
+	{
+		freeNode(childrenList[i]);
+	}
+	free(childrenList);
+}
+
+/**
+ * @brief getBestFirst This function looks for the node with the highest value in the tree, using
+ * best first search: it always expands the waiting node with the highest value.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The highest possible value for a node. When the function encounters a node with that
+ * value, it stops looking and returns it. If the best value can't be determined, pass
+ * UINT_MAX (defined in limits.h) for that parameter.
+ * @param maxNodes The most nodes that may wait to be expanded at once. children that don't fit
+ * are dropped with their subtrees. 0 for no limit.
+ * @return The node with the highest value the search encountered, which the caller should free
+ * with freeNode. If some nodes share that value, the first one encountered is returned. When all
+ * the nodes encountered have a value of zero, or the head is NULL, the returned node is NULL.
+ */
+pNode getBestFirst(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+				   freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, size_t maxNodes)
+{
+	if (head == NULL)
+	{
+		return NULL;
+	}
+	BestSoFar bestSoFar = {NULL, 0};
+	unsigned int headValue = getVal(head);
+	updateBest(&bestSoFar, head, headValue, freeNode, copy);
+	if (headValue == best)
+	{
+		return finishBest(&bestSoFar, freeNode);
+	}
+	NodeHeap heap = {NULL, 0, 0, BEST_FIRST, 0};
+	pNode headCopy = copy(head);
+	if (headCopy == NULL || !heapPush(&heap, headCopy, headValue))
+	{
+		if (headCopy != NULL)
+		{
+			freeNode(headCopy);
+		}
+		return finishBest(&bestSoFar, freeNode);
+	}
+	int found = FALSE;
+	while (heap.size > 0 && !found)
+	{
+		HeapEntry entry = heapPop(&heap);
+		pNode* childrenList = NULL;
+		// an error (-1) is treated as no children
+		int numOfChildren = getChildren(entry.node, &childrenList);
+		int i;
+		for (i = 0; i < numOfChildren; i++)
+		{
+			pNode child = childrenList[i];
+			unsigned int value = getVal(child);
+			updateBest(&bestSoFar, child, value, freeNode, copy);
+			if (value == best)
+			{
+				found = TRUE;
+				break;
+			}
+			// a child that doesn't fit in the heap is dropped
+			if ((maxNodes != 0 && heap.size >= maxNodes) || !heapPush(&heap, child, value))
+			{
+				freeNode(child);
+			}
+		}
+		// the children after the best one, if it was found, are not in the heap
+		freeChildren(childrenList, (found ? i : numOfChildren), numOfChildren, freeNode);
+		freeNode(entry.node);
+	}
+	freeHeap(&heap, freeNode);
+	return finishBest(&bestSoFar, freeNode);
+}
+
+/**
+ * @brief getBestBeam This function looks for the node with the highest value in the tree, using
+ * beam search: it goes down the tree one level at a time, and keeps only the beamWidth children
+ * with the highest values of every level to expand in the next one.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The highest possible value for a node. When the function encounters a node with that
+ * value, it stops looking and returns it.
+ * @param beamWidth The number of nodes kept in every level, which bounds the memory of the
+ * search by about twice as many nodes.
+ * @return The node with the highest value the search encountered, which the caller should free
+ * with freeNode. If some nodes share that value, the first one encountered is returned. When all
+ * the nodes encountered have a value of zero, or the head is NULL or beamWidth is less than 1,
+ * the returned node is NULL.
+ */
+pNode getBestBeam(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+				  freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, int beamWidth)
+{
+	if (head == NULL || beamWidth < 1)
+	{
+		return NULL;
+	}
+	BestSoFar bestSoFar = {NULL, 0};
+	unsigned int headValue = getVal(head);
+	updateBest(&bestSoFar, head, headValue, freeNode, copy);
+	if (headValue == best)
+	{
+		return finishBest(&bestSoFar, freeNode);
+	}
+	// the level being expanded, and the best children of it, with the worst of them on top so
+	// it's the one to give its place to a better child
+	NodeHeap level = {NULL, 0, 0, WORST_FIRST, 0};
+	NodeHeap nextLevel = {NULL, 0, 0, WORST_FIRST, 0};
+	pNode headCopy = copy(head);
+	if (headCopy == NULL || !heapPush(&level, headCopy, headValue))
+	{
+		if (headCopy != NULL)
+		{
+			freeNode(headCopy);
+		}
+		return finishBest(&bestSoFar, freeNode);
+	}
+	int found = FALSE;
+	while (level.size > 0 && !found)
+	{
+		size_t k;
+		for (k = 0; k < level.size && !found; k++)
+		{
+			pNode* childrenList = NULL;
+			// an error (-1) is treated as no children
+			int numOfChildren = getChildren(level.entries[k].node, &childrenList);
+			int i;
+			for (i = 0; i < numOfChildren; i++)
+			{
+				pNode child = childrenList[i];
+				unsigned int value = getVal(child);
+				updateBest(&bestSoFar, child, value, freeNode, copy);
+				if (value == best)
+				{
+					found = TRUE;
+					break;
+				}
+				HeapEntry candidate = {child, value, nextLevel.pushed};
+				// a full level keeps the child only if it's better than its worst node
+				if (nextLevel.size == (size_t)beamWidth)
+				{
+					if (!comesFirst(&nextLevel, &nextLevel.entries[0], &candidate))
+					{
+						freeNode(child);
+						continue;
+					}
+					freeNode(heapPop(&nextLevel).node);
+				}
+				if (!heapPush(&nextLevel, child, value))
+				{
+					freeNode(child);
+				}
+			}
+			freeChildren(childrenList, (found ? i : numOfChildren), numOfChildren, freeNode);
+		}
+		// the expanded level is done, and the kept children are the next one
+		freeHeap(&level, freeNode);
+		level = nextLevel;
+		nextLevel.entries = NULL;
+		nextLevel.size = 0;
+		nextLevel.capacity = 0;
+	}
+	freeHeap(&level, freeNode);
+	freeHeap(&nextLevel, freeNode);
+	return finishBest(&bestSoFar, freeNode);
+}
@@ -0,0 +1,415 @@
+/**
+ ===================================================================================================
+ Name        : genericdfsparallel.c
+ Author      : Yinnon Bratspiess
+ Description : This file is a parallel construction of the generic DFS algorithm. every thread
+ * 			   searches depth first from its own deque of subtrees, and steals subtrees from the
+ * 			   other threads when it runs out of work.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "genericdfs.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+// the capacity of a new deque, a power of 2 like every capacity it grows to
+#define INITIAL_DEQUE_CAPACITY 64
+
+// -------------------------- structs -----------------------------------
+/**
+ * the circular array of the nodes of a deque. a deque that grows keeps its old arrays until it's
+ * freed, since a thief may still be reading from one.
+ **/
+typedef struct DequeArray
+{
+	long capacity;
+	struct DequeArray* previous;
+	_Atomic(pNode) nodes[];
+}DequeArray;
+
+/**
+ * a lock-free (Chase-Lev) deque of nodes waiting to be searched. its owner pushes and pops at
+ * the bottom, so it goes depth first, and the other threads steal from the top, where the
+ * subtrees are the biggest. only a pop and a steal of the last node race, and they settle it with
+ * one compare and swap of top.
+ **/
+typedef struct WorkDeque
+{
+	atomic_long top;
+	atomic_long bottom;
+	_Atomic(DequeArray*) array;
+}WorkDeque;
+
+/**
+ * the state shared by all the threads of one search.
+ **/
+typedef struct ParallelSearch
+{
+	getNodeChildrenFunc getChildren;
+	getNodeValFunc getVal;
+	freeNodeFunc freeNode;
+	unsigned int best;
+	int numOfThreads;
+	WorkDeque* deques;
+	// the number of nodes pushed to a deque and not done yet. the search is over when it's 0
+	atomic_long pending;
+	// set by the thread that found a node with the best value, which stops all the threads
+	atomic_int found;
+	pNode result;
+}ParallelSearch;
+
+/**
+ * the argument of a worker thread.
+ **/
+typedef struct Worker
+{
+	ParallelSearch* search;
+	int index;
+}Worker;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function allocates an array for a deque.
+ * input :
+ * 		long capacity - the number of nodes of the array, a power of 2
+ * 		DequeArray* previous - the array it replaces, NULL for the first one
+ * output :
+ * 		the array. NULL if memory allocation failed
+ **/
+static DequeArray* createDequeArray(long capacity, DequeArray* previous)
+{
+	DequeArray* array = (DequeArray*)malloc(sizeof(DequeArray) + \
+						  capacity * sizeof(_Atomic(pNode)));
+	if (array != NULL)
+	{
+		array->capacity = capacity;
+		array->previous = previous;
+	}
+	return array;
+}
+
+/**
+ * This function initializes an empty deque.
+ * input :
+ * 		WorkDeque* deque - the deque
+ * output :
+ * 		1 if it was initialized, 0 if memory allocation failed.
+ **/
+static int initDeque(WorkDeque* deque)
+{
+	atomic_init(&deque->top, 0);
+	atomic_init(&deque->bottom, 0);
+	DequeArray* array = createDequeArray(INITIAL_DEQUE_CAPACITY, NULL);
+	atomic_init(&deque->array, array);
+	return array != NULL;
+}
+
+/**
+ * This function frees the arrays of a deque. no thread may use the deque anymore.
+ * input :
+ * 		WorkDeque* deque - the deque
+ * output :
+ * 		void
+ **/
+static void freeDeque(WorkDeque* deque)
+{
+	DequeArray* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+	while (array != NULL)
+	{
+		DequeArray* previous = array->previous;
+		free(array);
+		array = previous;
+	}
+}
+
+/**
+ * This function pushes a node at the bottom of a deque, growing it if it's full. only the owner
+ * of the deque calls it.
+ * input :
+ * 		WorkDeque* deque - the deque
+ * 		pNode node - the node
+ * output :
+ * 		1 if the node was pushed, 0 if memory allocation failed.
+ **/
+static int pushBottom(WorkDeque* deque, pNode node)
+{
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+	long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	DequeArray* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+	if (bottom - top >= array->capacity)
+	{
+		DequeArray* grown = createDequeArray(2 * array->capacity, array);
+		if (grown == NULL)
+		{
+			return FALSE;
+		}
+		long i;
+		for (i = top; i < bottom; i++)
+		{
+			atomic_store_explicit(&grown->nodes[i & (grown->capacity - 1)], \
+								  atomic_load_explicit(&array->nodes[i & (array->capacity - 1)], \
+													   memory_order_relaxed), memory_order_relaxed);
+		}
+		atomic_store_explicit(&deque->array, grown, memory_order_release);
+		array = grown;
+	}
+	atomic_store_explicit(&array->nodes[bottom & (array->capacity - 1)], node, \
+						  memory_order_relaxed);
+	// the node is in the array before the thieves see the new bottom
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+	return TRUE;
+}
+
+/**
+ * This function pops the node at the bottom of a deque. only the owner of the deque calls it.
+ * input :
+ * 		WorkDeque* deque - the deque
+ * output :
+ * 		the node. NULL if the deque is empty, or a thief took its last node
+ **/
+static pNode popBottom(WorkDeque* deque)
+{
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+	DequeArray* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+	atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+	// the new bottom is seen by the thieves before top is read
+	atomic_thread_fence(memory_order_seq_cst);
+	long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+	pNode node = NULL;
+	if (top <= bottom)
+	{
+		node = atomic_load_explicit(&array->nodes[bottom & (array->capacity - 1)], \
+									memory_order_relaxed);
+		if (top == bottom)
+		{
+			// the last node, which a thief may be taking at the same time
+			if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, \
+														 memory_order_seq_cst, \
+														 memory_order_relaxed))
+			{
+				node = NULL;
+			}
+			atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+		}
+	}
+	else
+	{
+		atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+	}
+	return node;
+}
+
+/**
+ * This function steals the node at the top of a deque. any thread may call it.
+ * input :
+ * 		WorkDeque* deque - the deque
+ * output :
+ * 		the node. NULL if the deque is empty, or another thread took the node first
+ **/
+static pNode stealTop(WorkDeque* deque)
+{
+	long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+	if (top >= bottom)
+	{
+		return NULL;
+	}
+	DequeArray* array = atomic_load_explicit(&deque->array, memory_order_acquire);
+	pNode node = atomic_load_explicit(&array->nodes[top & (array->capacity - 1)], \
+									  memory_order_relaxed);
+	if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, \
+												 memory_order_seq_cst, memory_order_relaxed))
+	{
+		return NULL;
+	}
+	return node;
+}
+
+/**
+ * This function searches the subtree of a node: if the node has the best value it becomes the
+ * result, else its children are pushed to the thread's deque.
+ * input :
+ * 		ParallelSearch* search - the search
+ * 		int index - the index of the thread
+ * 		pNode node - the node. it's freed, or becomes the result
+ * output :
+ * 		void
+ **/
+static void expandNode(ParallelSearch* search, int index, pNode node)
+{
+	if (search->getVal(node) == search->best)
+	{
+		int expected = FALSE;
+		if (atomic_compare_exchange_strong(&search->found, &expected, TRUE))
+		{
+			search->result = node;
+		}
+		else
+		{
+			search->freeNode(node);
+		}
+		atomic_fetch_sub(&search->pending, 1);
+		return;
+	}
+	pNode* childrenList = NULL;
+	int numOfChildren = search->getChildren(node, &childrenList);
+	int i;
+	// the children are counted before the node is done, so pending never drops to 0 early. they're
+	// pushed last child first so the first child is popped first, like the sequential getBest
+	if (numOfChildren > 0)
+	{
+		atomic_fetch_add(&search->pending, numOfChildren);
+	}
+	for (i = numOfChildren - 1; i >= 0; i--)
+	{
+		if (!pushBottom(&search->deques[index], childrenList[i]))
+		{
+			search->freeNode(childrenList[i]);
+			atomic_fetch_sub(&search->pending, 1);
+		}
+	}
+	free(childrenList);
+	search->freeNode(node);
+	atomic_fetch_sub(&search->pending, 1);
+}
+
+/**
+ * This function is the loop of a worker thread: it searches the nodes of its own deque, steals
+ * from the other deques when it's empty, and stops when the best node was found or no node is
+ * left anywhere.
+ * input :
+ * 		void* workerStruct - a Worker struct
+ * output :
+ * 		NULL
+ **/
+static void* workerLoop(void* workerStruct)
+{
+	Worker* worker = (Worker*)workerStruct;
+	ParallelSearch* search = worker->search;
+	while (!atomic_load(&search->found) && atomic_load(&search->pending) > 0)
+	{
+		pNode node = popBottom(&search->deques[worker->index]);
+		int victim;
+		for (victim = 1; node == NULL && victim < search->numOfThreads; victim++)
+		{
+			node = stealTop(&search->deques[(worker->index + victim) % search->numOfThreads]);
+		}
+		if (node == NULL)
+		{
+			// the other threads are still expanding nodes that may push new work
+			sched_yield();
+			continue;
+		}
+		expandNode(search, worker->index, node);
+	}
+	return NULL;
+}
+
+/**
+ * @brief getBestParallel This function looks for a node with the best value in the tree, using
+ * DFS algorithm on several threads. every thread searches depth first from its own deque of
+ * subtrees and steals subtrees from the others when it runs out of work, and all the threads
+ * stop as soon as one of them finds a node with the best value. the callbacks are called from
+ * all the threads at once, so they must be thread safe.
+ * @param head The head of the tree.
+ * @param getChildren A function that gets a node and a pointer to an array of nodes.
+ * The function allocates memory for an array of all the children of the node, populate it,
+ * and returns it using the second parameter. The returned value is the number of children.
+ * @param getVal A function that gets a node and returns its value, as int.
+ * @param freeNode A function that frees a node from memory.
+ * @param copy A function that does a deep copy of a node.
+ * @param best The value the function looks for.
+ * @param numOfThreads The number of threads to search with. 0 or less uses one thread per online
+ * processor.
+ * @return A node with the best value, which the caller should free with freeNode. If there's no
+ * such node, or in case of an error, the returned node is NULL. When several nodes have the best
+ * value, any of them may be returned.
+ */
+pNode getBestParallel(pNode head, getNodeChildrenFunc getChildren, getNodeValFunc getVal, \
+					  freeNodeFunc freeNode, copyNodeFunc copy, unsigned int best, \
+					  int numOfThreads)
+{
+	if (head == NULL)
+	{
+		return NULL;
+	}
+	if (numOfThreads <= 0)
+	{
+		numOfThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		numOfThreads = (numOfThreads > 0) ? numOfThreads : 1;
+	}
+	ParallelSearch search;
+	search.getChildren = getChildren;
+	search.getVal = getVal;
+	search.freeNode = freeNode;
+	search.best = best;
+	search.numOfThreads = numOfThreads;
+	search.result = NULL;
+	atomic_init(&search.pending, 0);
+	atomic_init(&search.found, FALSE);
+	search.deques = (WorkDeque*)calloc(numOfThreads, sizeof(WorkDeque));
+	Worker* workers = (Worker*)malloc(numOfThreads * sizeof(Worker));
+	pthread_t* threads = (pthread_t*)malloc(numOfThreads * sizeof(pthread_t));
+	if (search.deques == NULL || workers == NULL || threads == NULL)
+	{
+		free(search.deques);
+		free(workers);
+		free(threads);
+		return NULL;
+	}
+	int i, allocated = TRUE;
+	for (i = 0; i < numOfThreads; i++)
+	{
+		allocated = initDeque(&search.deques[i]) && allocated;
+		workers[i].search = &search;
+		workers[i].index = i;
+	}
+	// the search starts from a copy of the head in the first thread's deque
+	pNode first = allocated ? copy(head) : NULL;
+	if (first != NULL)
+	{
+		atomic_store(&search.pending, 1);
+		pushBottom(&search.deques[0], first);
+		// the calling thread is the first worker
+		int started = 1;
+		for (i = 1; i < numOfThreads; i++)
+		{
+			if (pthread_create(&threads[i], NULL, workerLoop, &workers[i]) != 0)
+			{
+				break;
+			}
+			started++;
+		}
+		workerLoop(&workers[0]);
+		for (i = 1; i < started; i++)
+		{
+			pthread_join(threads[i], NULL);
+		}
+	}
+	// the nodes left in the deques after the best node was found are never searched
+	for (i = 0; i < numOfThreads; i++)
+	{
+		pNode node;
+		while (atomic_load(&search.deques[i].array) != NULL && \
+			   (node = popBottom(&search.deques[i])) != NULL)
+		{
+			freeNode(node);
+		}
+		freeDeque(&search.deques[i]);
+	}
+	free(search.deques);
+	free(workers);
+	free(threads);
+	return search.result;
+}
@@ -0,0 +1,231 @@
+/**
+ ===================================================================================================
+ Name        : genericdfstable.c
+ Author      : Yinnon Bratspiess
+ Description : This file implements the transposition table of the generic DFS: a fixed size
+ * 			   table of the hashes and keys of the visited nodes that is read and written
+ * 			   without locks.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "genericdfs.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+// an entry with no hash in it. a hash of 0 is stored as NO_HASH_REPLACEMENT
+#define EMPTY_ENTRY 0
+#define NO_HASH_REPLACEMENT 1
+#define MIN_ENTRIES 1
+#define KEY_WORD_BYTES sizeof(uint64_t)
+
+// -------------------------- macros ------------------------------------
+// an entry's version is odd while a thread writes the entry
+#define IS_WRITTEN(version) ((version) & 1)
+
+// -------------------------- structs -----------------------------------
+/**
+ * an entry of the table: a hash and the key of the node it's of, so two nodes with the same hash
+ * are told apart. the version is raised before and after the entry is written, so a reader that
+ * sees the same even version before and after reading it read a whole entry (a seqlock).
+ **/
+typedef struct TranspositionEntry
+{
+	atomic_ulong version;
+	_Atomic uint64_t hash;
+	// keyWords words follow the entry
+	_Atomic uint64_t key[];
+}TranspositionEntry;
+
+/**
+ * the table: numOfEntries (a power of two) entries of entryBytes each, and its statistics. the
+ * statistics are counted without ordering, since they're only read once the searches are done.
+ **/
+struct TranspositionTable
+{
+	char* entries;
+	size_t numOfEntries;
+	size_t entryBytes;
+	getNodeKeyFunc getKey;
+	size_t keyBytes;
+	size_t keyWords;
+	atomic_ulong lookups;
+	atomic_ulong hits;
+	atomic_ulong collisions;
+	atomic_ulong replaced;
+};
+
+// ------------------------------ functions -----------------------------
+/**
+ * @brief createTranspositionTable This function creates an empty transposition table.
+ * @param numOfEntries The number of entries of the table. It's rounded up to a power of two.
+ * @param getKey A function that gets a node and returns its key.
+ * @param keyBytes The number of bytes of the key of every node.
+ * @return The table, NULL if memory allocation failed.
+ */
+TranspositionTable* createTranspositionTable(size_t numOfEntries, getNodeKeyFunc getKey, \
+											 size_t keyBytes)
+{
+	TranspositionTable* table = (TranspositionTable*)malloc(sizeof(TranspositionTable));
+	if (table == NULL)
+	{
+		return NULL;
+	}
+	table->numOfEntries = MIN_ENTRIES;
+	while (table->numOfEntries < numOfEntries)
+	{
+		table->numOfEntries *= 2;
+	}
+	table->getKey = getKey;
+	table->keyBytes = keyBytes;
+	table->keyWords = (keyBytes + KEY_WORD_BYTES - 1) / KEY_WORD_BYTES;
+	table->entryBytes = sizeof(TranspositionEntry) + table->keyWords * sizeof(uint64_t);
+	table->entries = (char*)calloc(table->numOfEntries, table->entryBytes);
+	if (table->entries == NULL)
+	{
+		free(table);
+		return NULL;
+	}
+	atomic_init(&table->lookups, 0);
+	atomic_init(&table->hits, 0);
+	atomic_init(&table->collisions, 0);
+	atomic_init(&table->replaced, 0);
+	return table;
+}
+
+/**
+ * @brief clearTranspositionTable This function empties a transposition table and zeroes its
+ * statistics. no search may use the table at the same time.
+ * @param table The table.
+ */
+void clearTranspositionTable(TranspositionTable* table)
+{
+	memset(table->entries, 0, table->numOfEntries * table->entryBytes);
+	atomic_store(&table->lookups, 0);
+	atomic_store(&table->hits, 0);
+	atomic_store(&table->collisions, 0);
+	atomic_store(&table->replaced, 0);
+}
+
+/**
+ * @brief freeTranspositionTable This function frees a transposition table from memory.
+ * @param table The table.
+ */
+void freeTranspositionTable(TranspositionTable* table)
+{
+	if (table == NULL)
+	{
+		return;
+	}
+	free(table->entries);
+	free(table);
+}
+
+/**
+ * This function returns a word of a key, with the bytes after the end of the key as 0.
+ * input :
+ * 		const unsigned char* key - the key
+ * 		size_t keyBytes - the number of bytes of the key
+ * 		size_t word - the index of the word
+ * output :
+ * 		the word
+ **/
+static uint64_t keyWord(const unsigned char* key, size_t keyBytes, size_t word)
+{
+	uint64_t value = 0;
+	size_t start = word * KEY_WORD_BYTES;
+	size_t bytes = (keyBytes - start < KEY_WORD_BYTES) ? keyBytes - start : KEY_WORD_BYTES;
+	memcpy(&value, key + start, bytes);
+	return value;
+}
+
+/**
+ * @brief checkAndStoreTransposition This function looks for a node in a transposition table, by
+ * its hash and then its key, and stores it there if it's not found. a node is only found if its
+ * whole key is in the entry, so a hash collision is a miss. two threads that store at once may
+ * both miss, which only costs a subtree searched twice.
+ * @param table The table.
+ * @param hash The hash of the node.
+ * @param node The node.
+ * @return 1 if the node was in the table, 0 else.
+ */
+int checkAndStoreTransposition(TranspositionTable* table, uint64_t hash, pNode node)
+{
+	if (hash == EMPTY_ENTRY)
+	{
+		hash = NO_HASH_REPLACEMENT;
+	}
+	// the entry is picked by the low bits, so the whole hash is kept to tell hashes apart
+	TranspositionEntry* entry = (TranspositionEntry*)(table->entries + \
+							    (hash & (table->numOfEntries - 1)) * table->entryBytes);
+	const unsigned char* key = (const unsigned char*)table->getKey(node);
+	atomic_fetch_add_explicit(&table->lookups, 1, memory_order_relaxed);
+	unsigned long version = atomic_load_explicit(&entry->version, memory_order_acquire);
+	if (IS_WRITTEN(version))
+	{
+		// another thread is writing the entry, so it's a miss that isn't stored
+		return FALSE;
+	}
+	uint64_t current = atomic_load_explicit(&entry->hash, memory_order_relaxed);
+	size_t word;
+	if (current == hash)
+	{
+		int same = TRUE;
+		for (word = 0; word < table->keyWords && same; word++)
+		{
+			same = (atomic_load_explicit(&entry->key[word], memory_order_relaxed) == \
+					keyWord(key, table->keyBytes, word));
+		}
+		// the entry was read whole only if no thread wrote it in the meantime
+		atomic_thread_fence(memory_order_acquire);
+		if (atomic_load_explicit(&entry->version, memory_order_relaxed) != version)
+		{
+			return FALSE;
+		}
+		if (same)
+		{
+			atomic_fetch_add_explicit(&table->hits, 1, memory_order_relaxed);
+			return TRUE;
+		}
+		atomic_fetch_add_explicit(&table->collisions, 1, memory_order_relaxed);
+	}
+	// the thread that raises the version to odd writes the entry, any other one skips it
+	if (!atomic_compare_exchange_strong_explicit(&entry->version, &version, version + 1, \
+												 memory_order_acquire, memory_order_relaxed))
+	{
+		return FALSE;
+	}
+	if (current != EMPTY_ENTRY)
+	{
+		atomic_fetch_add_explicit(&table->replaced, 1, memory_order_relaxed);
+	}
+	atomic_store_explicit(&entry->hash, hash, memory_order_relaxed);
+	for (word = 0; word < table->keyWords; word++)
+	{
+		atomic_store_explicit(&entry->key[word], keyWord(key, table->keyBytes, word), \
+							  memory_order_relaxed);
+	}
+	atomic_store_explicit(&entry->version, version + 2, memory_order_release);
+	return FALSE;
+}
+
+/**
+ * @brief getTranspositionStats This function returns the statistics of a transposition table
+ * since it was created or cleared.
+ * @param table The table.
+ * @return The statistics.
+ */
+TranspositionStats getTranspositionStats(TranspositionTable* table)
+{
+	TranspositionStats stats;
+	stats.lookups = atomic_load(&table->lookups);
+	stats.hits = atomic_load(&table->hits);
+	stats.collisions = atomic_load(&table->collisions);
+	stats.replaced = atomic_load(&table->replaced);
+	return stats;
+}
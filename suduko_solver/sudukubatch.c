@@ -0,0 +1,711 @@
+/**
+ ===================================================================================================
+ Name        : sudukubatch.c
+ Author      : Yinnon Bratspiess
+ Description : This file solves a stream of suduku puzzles on a pool of threads, writing the
+ * 			   results in the order of the input.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include "genericdfs.h"
+#include "sudukutree.h"
+#include "sudukudlx.h"
+#include "sudukusat.h"
+#include "sudukuportfolio.h"
+#include "sudukubatch.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define EMPTY_SLOT 0
+#define EMPTY_SLOT_CHAR '.'
+// the number of puzzles read and solved at a time
+#define CHUNK_PUZZLES 4096
+// the output is written once this many bytes are waiting
+#define OUTPUT_FLUSH_BYTES (1 << 20)
+#define INITIAL_ARENA_BYTES (CHUNK_PUZZLES * 81)
+// the kinds of puzzles
+#define LINE_FORMAT 0
+#define BLOCK_FORMAT 1
+// the line puzzles - 4x4 and 9x9 boards with a char per slot
+#define SMALL_LINE_SIZE 4
+#define LINE_SIZE 9
+// the status of a puzzle
+#define PUZZLE_INVALID 0
+#define PUZZLE_PENDING 1
+#define PUZZLE_NO_SOLUTION 2
+#define PUZZLE_SOLVED 3
+// memory allocation failed while the puzzle was solved
+#define PUZZLE_FAILED 4
+// the results of reading a puzzle
+#define READ_END 0
+#define READ_PUZZLE 1
+#define READ_FAILED 2
+#define NANOS_IN_SECOND 1e9
+// not an int number indicator of sqrtCheck
+#define NOT_AN_INT -1
+
+// -------------------------- structs -----------------------------------
+/**
+ * a puzzle of a chunk. its slots are size * size bytes of the chunk's arena, replaced by the
+ * solution once it's solved.
+ **/
+typedef struct BatchPuzzle
+{
+	int size;
+	int format;
+	int status;
+	size_t cellsOffset;
+}BatchPuzzle;
+
+/**
+ * the puzzles read at a time, and the arena their slots are kept in.
+ **/
+typedef struct BatchChunk
+{
+	BatchPuzzle puzzles[CHUNK_PUZZLES];
+	int numOfPuzzles;
+	SudukuCell* arena;
+	size_t arenaLength;
+	size_t arenaCapacity;
+}BatchChunk;
+
+/**
+ * a reader of the input, one line at a time. position is the next char of the line to read, and
+ * failed is set if a line couldn't be read before the end of the input.
+ **/
+typedef struct BatchReader
+{
+	FILE* file;
+	char* line;
+	size_t capacity;
+	char* position;
+	int failed;
+}BatchReader;
+
+/**
+ * the pool of solving threads. the main thread publishes a chunk by increasing the generation,
+ * the workers take its puzzles one by one and the last one to finish wakes the main thread.
+ **/
+typedef struct BatchPool
+{
+	SudukuBatchOptions* options;
+	BatchChunk* chunk;
+	atomic_int nextPuzzle;
+	int numOfWorkers;
+	int generation;
+	int finishedWorkers;
+	int stop;
+	pthread_mutex_t lock;
+	pthread_cond_t workReady;
+	pthread_cond_t workDone;
+}BatchPool;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function reads the next line of the input.
+ * input :
+ * 		BatchReader* reader - the reader
+ * output :
+ * 		1 if a line was read, 0 at the end of the input or if it couldn't be read.
+ **/
+static int nextLine(BatchReader* reader)
+{
+	if (getline(&reader->line, &reader->capacity, reader->file) == -1)
+	{
+		// getline fails before the end of the input if it can't allocate the line
+		reader->failed = reader->failed || !feof(reader->file);
+		reader->position = NULL;
+		return FALSE;
+	}
+	reader->position = reader->line;
+	return TRUE;
+}
+
+/**
+ * This function reads the next int of the input, moving on to the next lines as needed.
+ * input :
+ * 		BatchReader* reader - the reader
+ * 		int* value - a pointer to put the int in
+ * 		int* valid - a pointer that is set to 0 if the next token is not an int (it's skipped)
+ * output :
+ * 		1 if a token was read, 0 at the end of the input.
+ **/
+static int nextInt(BatchReader* reader, int* value, int* valid)
+{
+	while (TRUE)
+	{
+		while (reader->position != NULL && isspace((unsigned char)*reader->position))
+		{
+			reader->position++;
+		}
+		if (reader->position != NULL && *reader->position != '\0')
+		{
+			break;
+		}
+		if (!nextLine(reader))
+		{
+			return FALSE;
+		}
+	}
+	char* end;
+	long number = strtol(reader->position, &end, 10);
+	if (end == reader->position || (*end != '\0' && !isspace((unsigned char)*end)) || \
+		number < 0 || number > SUDUKU_MAX_SIZE * SUDUKU_MAX_SIZE)
+	{
+		*valid = FALSE;
+		while (*end != '\0' && !isspace((unsigned char)*end))
+		{
+			end++;
+		}
+	}
+	*value = (int)number;
+	reader->position = end;
+	return TRUE;
+}
+
+/**
+ * This function checks if the rest of the reader's line is a line puzzle, and returns its size.
+ * input :
+ * 		BatchReader* reader - the reader
+ * output :
+ * 		the size of the puzzle, 0 if the line is not a line puzzle.
+ **/
+static int linePuzzleSize(BatchReader* reader)
+{
+	size_t length = 0;
+	char* position = reader->position;
+	while (isdigit((unsigned char)position[length]) || position[length] == EMPTY_SLOT_CHAR)
+	{
+		length++;
+	}
+	// nothing but white space may follow the slots
+	char* rest;
+	for (rest = position + length; *rest != '\0'; rest++)
+	{
+		if (!isspace((unsigned char)*rest))
+		{
+			return 0;
+		}
+	}
+	if (length == LINE_SIZE * LINE_SIZE)
+	{
+		return LINE_SIZE;
+	}
+	if (length == SMALL_LINE_SIZE * SMALL_LINE_SIZE)
+	{
+		return SMALL_LINE_SIZE;
+	}
+	return 0;
+}
+
+/**
+ * This function checks if the rest of the reader's line is the size line of a block: a single
+ * size of a board.
+ * input :
+ * 		BatchReader* reader - the reader
+ * output :
+ * 		1 if the line is a size line, else 0.
+ **/
+static int isSizeLine(BatchReader* reader)
+{
+	char* end;
+	long size = strtol(reader->position, &end, 10);
+	if (end == reader->position || size <= 0 || size > SUDUKU_MAX_SIZE || \
+		sqrtCheck((int)size) == NOT_AN_INT)
+	{
+		return FALSE;
+	}
+	while (isspace((unsigned char)*end))
+	{
+		end++;
+	}
+	return *end == '\0';
+}
+
+/**
+ * This function skips the rest of a block whose size is not valid. its rows can't be told apart
+ * from puzzles, so the lines are dropped up to a blank line, a size line or a line puzzle, where
+ * the reader stops.
+ * input :
+ * 		BatchReader* reader - the reader
+ * output :
+ * 		void
+ **/
+static void skipBlock(BatchReader* reader)
+{
+	while (nextLine(reader))
+	{
+		while (isspace((unsigned char)*reader->position))
+		{
+			reader->position++;
+		}
+		if (*reader->position == '\0' || linePuzzleSize(reader) != 0 || isSizeLine(reader))
+		{
+			return;
+		}
+	}
+}
+
+/**
+ * This function makes room for the slots of a puzzle in the chunk's arena.
+ * input :
+ * 		BatchChunk* chunk - the chunk
+ * 		BatchPuzzle* puzzle - the puzzle, with its size
+ * output :
+ * 		1 if there's room, 0 if memory allocation failed.
+ **/
+static int reserveCells(BatchChunk* chunk, BatchPuzzle* puzzle)
+{
+	size_t needed = chunk->arenaLength + puzzle->size * puzzle->size;
+	if (needed > chunk->arenaCapacity)
+	{
+		size_t capacity = chunk->arenaCapacity * 2;
+		while (capacity < needed)
+		{
+			capacity *= 2;
+		}
+		SudukuCell* arena = (SudukuCell*)realloc(chunk->arena, capacity);
+		if (arena == NULL)
+		{
+			return FALSE;
+		}
+		chunk->arena = arena;
+		chunk->arenaCapacity = capacity;
+	}
+	puzzle->cellsOffset = chunk->arenaLength;
+	chunk->arenaLength = needed;
+	return TRUE;
+}
+
+/**
+ * This function reads the next puzzle of the input into the chunk.
+ * input :
+ * 		BatchReader* reader - the reader
+ * 		BatchChunk* chunk - the chunk
+ * output :
+ * 		READ_PUZZLE if a puzzle was read (maybe an invalid one), READ_END at the end of the input,
+ * 		READ_FAILED if memory allocation failed.
+ **/
+static int readPuzzle(BatchReader* reader, BatchChunk* chunk)
+{
+	BatchPuzzle* puzzle = &chunk->puzzles[chunk->numOfPuzzles];
+	// skip to the first line with something on it
+	while (TRUE)
+	{
+		while (reader->position != NULL && isspace((unsigned char)*reader->position))
+		{
+			reader->position++;
+		}
+		if (reader->position != NULL && *reader->position != '\0')
+		{
+			break;
+		}
+		if (!nextLine(reader))
+		{
+			return reader->failed ? READ_FAILED : READ_END;
+		}
+	}
+	puzzle->status = PUZZLE_PENDING;
+	int slot, num, valid = TRUE;
+	int size = linePuzzleSize(reader);
+	if (size != 0)
+	{
+		puzzle->format = LINE_FORMAT;
+		puzzle->size = size;
+		if (!reserveCells(chunk, puzzle))
+		{
+			return READ_FAILED;
+		}
+		for (slot = 0; slot < size * size; slot++)
+		{
+			char slotChar = reader->position[slot];
+			num = (slotChar == EMPTY_SLOT_CHAR) ? EMPTY_SLOT : slotChar - '0';
+			valid = valid && (num <= size);
+			chunk->arena[puzzle->cellsOffset + slot] = (SudukuCell)num;
+		}
+		reader->position += size * size;
+	}
+	else
+	{
+		// a block: the size and then size * size nums
+		puzzle->format = BLOCK_FORMAT;
+		nextInt(reader, &size, &valid);
+		if (!valid || size <= 0 || size > SUDUKU_MAX_SIZE || sqrtCheck(size) == NOT_AN_INT)
+		{
+			puzzle->size = 0;
+			puzzle->status = PUZZLE_INVALID;
+			skipBlock(reader);
+			chunk->numOfPuzzles++;
+			return READ_PUZZLE;
+		}
+		puzzle->size = size;
+		if (!reserveCells(chunk, puzzle))
+		{
+			return READ_FAILED;
+		}
+		for (slot = 0; slot < size * size; slot++)
+		{
+			if (!nextInt(reader, &num, &valid))
+			{
+				valid = FALSE;
+				break;
+			}
+			valid = valid && (num <= size);
+			chunk->arena[puzzle->cellsOffset + slot] = valid ? (SudukuCell)num : EMPTY_SLOT;
+		}
+	}
+	if (!valid)
+	{
+		puzzle->status = PUZZLE_INVALID;
+	}
+	chunk->numOfPuzzles++;
+	return READ_PUZZLE;
+}
+
+/**
+ * This function solves a puzzle of the chunk, using the worker's context for its size.
+ * input :
+ * 		BatchPool* pool - the pool
+ * 		BatchPuzzle* puzzle - the puzzle
+ * 		SudukuContext** contexts - the worker's contexts, by size
+ * 		SudukuPortfolioSearch** portfolioSearch - the worker's state of the portfolio searches,
+ * 												  created on its first puzzle
+ * output :
+ * 		void
+ **/
+static void solvePuzzle(BatchPool* pool, BatchPuzzle* puzzle, SudukuContext** contexts, \
+						SudukuPortfolioSearch** portfolioSearch)
+{
+	if (puzzle->status != PUZZLE_PENDING)
+	{
+		return;
+	}
+	if (contexts[puzzle->size] == NULL)
+	{
+		contexts[puzzle->size] = createSudukuContext(puzzle->size);
+		if (contexts[puzzle->size] == NULL)
+		{
+			puzzle->status = PUZZLE_FAILED;
+			return;
+		}
+		contexts[puzzle->size]->propagate = pool->options->propagate;
+	}
+	SudukuBoardStruct* suduku = createSudukuBoard(contexts[puzzle->size]);
+	if (suduku == NULL)
+	{
+		puzzle->status = PUZZLE_FAILED;
+		return;
+	}
+	SudukuCell* cells = pool->chunk->arena + puzzle->cellsOffset;
+	memcpy(suduku->board, cells, puzzle->size * puzzle->size * sizeof(SudukuCell));
+	// a board with a repeated digit has no solution, like in a single board file
+	puzzle->status = PUZZLE_NO_SOLUTION;
+	if (initSudukuMasks(suduku) && propagateSudukuRoot(suduku))
+	{
+		int solved;
+		if (pool->options->useDlx)
+		{
+			solved = solveSudukuDlx(suduku);
+			if (solved == SUDUKU_DLX_FAILED)
+			{
+				puzzle->status = PUZZLE_FAILED;
+				freeSudukuFunc(suduku);
+				return;
+			}
+		}
+		else if (pool->options->useSat)
+		{
+			solved = solveSudukuSat(suduku, NULL);
+			if (solved == SUDUKU_SAT_FAILED)
+			{
+				puzzle->status = PUZZLE_FAILED;
+				freeSudukuFunc(suduku);
+				return;
+			}
+		}
+		else if (pool->options->portfolio != NULL)
+		{
+			if (*portfolioSearch == NULL)
+			{
+				*portfolioSearch = createSudukuPortfolioSearch(pool->options->portfolio);
+			}
+			if (*portfolioSearch == NULL || \
+				runSudukuPortfolio(*portfolioSearch, suduku, NULL) == SUDUKU_PORTFOLIO_FAILED)
+			{
+				puzzle->status = PUZZLE_FAILED;
+				freeSudukuFunc(suduku);
+				return;
+			}
+			solved = (getSudukuValFunc(suduku) == (unsigned int)(puzzle->size * puzzle->size));
+		}
+		else
+		{
+			solved = getBestInPlace(suduku, getSudukuMovesFunc, applySudukuMoveFunc, \
+									undoSudukuMoveFunc, getSudukuValFunc, \
+									puzzle->size * puzzle->size) != NULL;
+		}
+		if (solved)
+		{
+			memcpy(cells, suduku->board, puzzle->size * puzzle->size * sizeof(SudukuCell));
+			puzzle->status = PUZZLE_SOLVED;
+		}
+	}
+	freeSudukuFunc(suduku);
+}
+
+/**
+ * This function is the loop of a worker thread: it waits for a chunk, solves its puzzles until
+ * none is left, and waits for the next one.
+ * input :
+ * 		void* poolStruct - the pool
+ * output :
+ * 		NULL
+ **/
+static void* workerLoop(void* poolStruct)
+{
+	BatchPool* pool = (BatchPool*)poolStruct;
+	SudukuContext* contexts[SUDUKU_MAX_SIZE + 1] = {NULL};
+	SudukuPortfolioSearch* portfolioSearch = NULL;
+	int lastGeneration = 0;
+	int size;
+	pthread_mutex_lock(&pool->lock);
+	while (TRUE)
+	{
+		while (pool->generation == lastGeneration && !pool->stop)
+		{
+			pthread_cond_wait(&pool->workReady, &pool->lock);
+		}
+		if (pool->stop)
+		{
+			break;
+		}
+		lastGeneration = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+		int index;
+		while ((index = atomic_fetch_add(&pool->nextPuzzle, 1)) < pool->chunk->numOfPuzzles)
+		{
+			solvePuzzle(pool, &pool->chunk->puzzles[index], contexts, &portfolioSearch);
+		}
+		pthread_mutex_lock(&pool->lock);
+		pool->finishedWorkers++;
+		if (pool->finishedWorkers == pool->numOfWorkers)
+		{
+			pthread_cond_signal(&pool->workDone);
+		}
+	}
+	pthread_mutex_unlock(&pool->lock);
+	freeSudukuPortfolioSearch(portfolioSearch);
+	for (size = 0; size <= SUDUKU_MAX_SIZE; size++)
+	{
+		if (contexts[size] != NULL)
+		{
+			freeSudukuContext(contexts[size]);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * This function appends the answer of a puzzle to the output buffer.
+ * input :
+ * 		BatchChunk* chunk - the chunk
+ * 		BatchPuzzle* puzzle - the puzzle
+ * 		char* inputName - the name of the input
+ * 		unsigned long puzzleNumber - the number of the puzzle in the input, from 1
+ * 		char* buffer - the output buffer, with room for any answer
+ * output :
+ * 		the number of bytes appended
+ **/
+static size_t formatAnswer(BatchChunk* chunk, BatchPuzzle* puzzle, char* inputName, \
+						   unsigned long puzzleNumber, char* buffer)
+{
+	if (puzzle->status == PUZZLE_INVALID)
+	{
+		return sprintf(buffer, "%s:%lu:not a valid suduku file\n", inputName, puzzleNumber);
+	}
+	if (puzzle->status == PUZZLE_FAILED)
+	{
+		return sprintf(buffer, "%s:%lu:memory allocation failed\n", inputName, puzzleNumber);
+	}
+	if (puzzle->status != PUZZLE_SOLVED)
+	{
+		return sprintf(buffer, "no solution!\n");
+	}
+	SudukuCell* cells = chunk->arena + puzzle->cellsOffset;
+	size_t length = 0;
+	int row, col, slot;
+	if (puzzle->format == LINE_FORMAT)
+	{
+		for (slot = 0; slot < puzzle->size * puzzle->size; slot++)
+		{
+			buffer[length] = (char)('0' + cells[slot]);
+			length++;
+		}
+		buffer[length] = '\n';
+		return length + 1;
+	}
+	length += sprintf(buffer, "%d\n", puzzle->size);
+	for (row = 0; row < puzzle->size; row++)
+	{
+		for (col = 0; col < puzzle->size; col++)
+		{
+			length += sprintf(buffer + length, (col == puzzle->size - 1) ? "%d" : "%d ", \
+							  cells[row * puzzle->size + col]);
+		}
+		buffer[length] = '\n';
+		length++;
+	}
+	return length;
+}
+
+/**
+ * This function solves every puzzle of a stream and writes the results in the order of the
+ * input. a puzzle is either a line of 81 (or 16) chars, one per slot of a 9x9 (or 4x4) board
+ * with '0' or '.' for an empty slot, or a block in the format of a single board file: the size
+ * and then size * size nums. the two kinds can be mixed. a line puzzle is answered with a line
+ * of its solution, a block with the size and the board, as sudukusolver prints them. a puzzle
+ * with no solution is answered with "no solution!" and an invalid one with
+ * "<name>:<puzzle number>:not a valid suduku file".
+ * the puzzles are read in chunks, every chunk is solved by a pool of threads, and the number of
+ * puzzles solved per second is printed to stderr at the end.
+ * input :
+ * 		FILE* input - the stream of puzzles
+ * 		char* inputName - the name of the stream, for the error messages
+ * 		FILE* output - the stream the results are written to
+ * 		SudukuBatchOptions* options - the options of the run
+ * output :
+ * 		0 if all the puzzles were read and answered, 1 if memory allocation or a thread failed.
+ **/
+int solveSudukuBatch(FILE* input, char* inputName, FILE* output, SudukuBatchOptions* options)
+{
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	int numOfWorkers = options->numOfThreads;
+	if (numOfWorkers <= 0)
+	{
+		numOfWorkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		numOfWorkers = (numOfWorkers > 0) ? numOfWorkers : 1;
+	}
+	// the biggest answer is a block of SUDUKU_MAX_SIZE: up to 4 chars per slot and the size, or
+	// the error message of an invalid puzzle, with the name and the number of the puzzle
+	size_t maxAnswer = SUDUKU_MAX_SIZE * SUDUKU_MAX_SIZE * 4 + strlen(inputName) + 64;
+	BatchChunk* chunk = (BatchChunk*)calloc(1, sizeof(BatchChunk));
+	BatchPool* pool = (BatchPool*)calloc(1, sizeof(BatchPool));
+	pthread_t* threads = (pthread_t*)malloc(numOfWorkers * sizeof(pthread_t));
+	char* outputBuffer = (char*)malloc(OUTPUT_FLUSH_BYTES + maxAnswer);
+	if (chunk == NULL || pool == NULL || threads == NULL || outputBuffer == NULL || \
+		(chunk->arena = (SudukuCell*)malloc(INITIAL_ARENA_BYTES)) == NULL)
+	{
+		free(chunk);
+		free(pool);
+		free(threads);
+		free(outputBuffer);
+		return EXIT_FAILURE;
+	}
+	chunk->arenaCapacity = INITIAL_ARENA_BYTES;
+	pool->options = options;
+	pool->chunk = chunk;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->workReady, NULL);
+	pthread_cond_init(&pool->workDone, NULL);
+	int i, result = EXIT_SUCCESS;
+	for (i = 0; i < numOfWorkers; i++)
+	{
+		if (pthread_create(&threads[i], NULL, workerLoop, pool) != 0)
+		{
+			result = EXIT_FAILURE;
+			break;
+		}
+	}
+	pool->numOfWorkers = i;
+	BatchReader reader = {input, NULL, 0, NULL, FALSE};
+	unsigned long numOfPuzzles = 0;
+	size_t outputLength = 0;
+	int endOfInput = (pool->numOfWorkers == 0);
+	while (!endOfInput)
+	{
+		// read a chunk
+		chunk->numOfPuzzles = 0;
+		chunk->arenaLength = 0;
+		while (chunk->numOfPuzzles < CHUNK_PUZZLES && !endOfInput)
+		{
+			int read = readPuzzle(&reader, chunk);
+			endOfInput = (read != READ_PUZZLE);
+			// the puzzles read so far are still answered, but the rest of the input is lost
+			if (read == READ_FAILED || reader.failed)
+			{
+				fprintf(stderr, "%s: memory allocation failed, the rest of the input is not " \
+						"read\n", inputName);
+				result = EXIT_FAILURE;
+				endOfInput = TRUE;
+			}
+		}
+		if (chunk->numOfPuzzles == 0)
+		{
+			break;
+		}
+		// hand it to the workers and wait for all of them to finish it
+		pthread_mutex_lock(&pool->lock);
+		atomic_store(&pool->nextPuzzle, 0);
+		pool->finishedWorkers = 0;
+		pool->generation++;
+		pthread_cond_broadcast(&pool->workReady);
+		while (pool->finishedWorkers < pool->numOfWorkers)
+		{
+			pthread_cond_wait(&pool->workDone, &pool->lock);
+		}
+		pthread_mutex_unlock(&pool->lock);
+		// write the answers in the order of the input
+		for (i = 0; i < chunk->numOfPuzzles; i++)
+		{
+			numOfPuzzles++;
+			if (chunk->puzzles[i].status == PUZZLE_FAILED)
+			{
+				result = EXIT_FAILURE;
+			}
+			outputLength += formatAnswer(chunk, &chunk->puzzles[i], inputName, numOfPuzzles, \
+										 outputBuffer + outputLength);
+			if (outputLength >= OUTPUT_FLUSH_BYTES)
+			{
+				fwrite(outputBuffer, 1, outputLength, output);
+				outputLength = 0;
+			}
+		}
+	}
+	fwrite(outputBuffer, 1, outputLength, output);
+	fflush(output);
+	pthread_mutex_lock(&pool->lock);
+	pool->stop = TRUE;
+	pthread_cond_broadcast(&pool->workReady);
+	pthread_mutex_unlock(&pool->lock);
+	for (i = 0; i < pool->numOfWorkers; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / NANOS_IN_SECOND;
+	fprintf(stderr, "%lu puzzles in %.3f seconds on %d threads (%.1f puzzles/second)\n", \
+			numOfPuzzles, seconds, pool->numOfWorkers, \
+			(seconds > 0) ? numOfPuzzles / seconds : 0.0);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->workReady);
+	pthread_cond_destroy(&pool->workDone);
+	free(reader.line);
+	free(chunk->arena);
+	free(chunk);
+	free(pool);
+	free(threads);
+	free(outputBuffer);
+	return result;
+}
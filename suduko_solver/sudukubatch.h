@@ -0,0 +1,59 @@
+/**
+ ===================================================================================================
+ Name        : sudukubatch.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukubatch.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukubatch_H
+#define sudukubatch_H
+
+#include <stdio.h>
+#include "sudukuportfolio.h"
+
+//********      structs
+/**
+ * struct for the options of a batch run.
+ * int numOfThreads - the number of solving threads. 0 or less uses one per online processor
+ * int propagate - 1 to fill the forced slots of every search node, else 0
+ * int useDlx - 1 to solve with the exact cover solver instead of the DFS, else 0
+ * int useSat - 1 to solve with the SAT solver instead of the DFS, else 0
+ * SudukuPortfolio* portfolio - a portfolio to solve every puzzle with instead of one DFS, NULL
+ * for none. it counts the wins of its configurations over all the puzzles. every solving thread
+ * runs the first configuration itself and starts a thread for every other one, so the threads
+ * of the batch are numOfThreads times the configurations
+ **/
+typedef struct SudukuBatchOptions
+{
+	int numOfThreads;
+	int propagate;
+	int useDlx;
+	int useSat;
+	SudukuPortfolio* portfolio;
+}SudukuBatchOptions;
+
+//********      functions
+/**
+ * This function solves every puzzle of a stream and writes the results in the order of the
+ * input. a puzzle is either a line of 81 (or 16) chars, one per slot of a 9x9 (or 4x4) board
+ * with '0' or '.' for an empty slot, or a block in the format of a single board file: the size
+ * and then size * size nums. the two kinds can be mixed. a line puzzle is answered with a line
+ * of its solution, a block with the size and the board, as sudukusolver prints them. a puzzle
+ * with no solution is answered with "no solution!" and an invalid one with
+ * "<name>:<puzzle number>:not a valid suduku file", and one that couldn't be solved since memory
+ * allocation failed with "<name>:<puzzle number>:memory allocation failed". a block with a size
+ * that is not valid is skipped up to the next blank line, size line or line puzzle.
+ * the puzzles are read in chunks, every chunk is solved by a pool of threads, and the number of
+ * puzzles solved per second is printed to stderr at the end.
+ * input :
+ * 		FILE* input - the stream of puzzles
+ * 		char* inputName - the name of the stream, for the error messages
+ * 		FILE* output - the stream the results are written to
+ * 		SudukuBatchOptions* options - the options of the run
+ * output :
+ * 		0 if all the puzzles were read and answered, 1 if memory allocation or a thread failed.
+ **/
+int solveSudukuBatch(FILE* input, char* inputName, FILE* output, SudukuBatchOptions* options);
+
+#endif // sudukubatch_H
@@ -0,0 +1,1316 @@
+/**
+ ===================================================================================================
+ Name        : sudukudaemon.c
+ Author      : Yinnon Bratspiess
+ Description : This file is a daemon that solves the boards its clients send over a Unix domain
+ * 			   socket, in batches on a pool of threads with a solver of sudukulib.h each, and
+ * 			   writes the answers of every connection back in the order of its requests.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "genericdfs.h"
+#include "sudukutree.h"
+#include "sudukulib.h"
+#include "sudukudaemon.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+// the most boards in a batch
+#define BATCH_REQUESTS 64
+// the kinds of requests. a stats request and an invalid one are answered by the connections'
+// thread at once, in their place among the boards. an invalid request that starts with the magic
+// is answered in the binary form
+#define TEXT_REQUEST 0
+#define BINARY_REQUEST 1
+#define STATS_REQUEST 2
+#define INVALID_REQUEST 3
+#define INVALID_BINARY_REQUEST 4
+// the bytes before the slots of a binary request (the magic and the size) and of its answer (the
+// magic, the status and the size)
+#define BINARY_REQUEST_HEADER 2
+#define BINARY_ANSWER_HEADER 3
+// a slot of a text answer is up to 3 digits and a space or a new line
+#define TEXT_SLOT_BYTES 4
+#define TEXT_SIZE_BYTES 16
+// the bytes read from a connection at a time, and the most bytes of a request (a text board of
+// SUDUKU_MAX_SIZE with a lot of white space). a longer one is answered as invalid, and the
+// connection is not read from anymore
+#define READ_BYTES 65536
+#define MAX_REQUEST_BYTES (SUDUKU_MAX_SIZE * SUDUKU_MAX_SIZE * 8)
+// a connection is not read from while it has this many requests in the daemon or this many bytes
+// of answers waiting to be written, so a client that doesn't read its answers can't flood it
+#define MAX_CONNECTION_REQUESTS 4096
+#define MAX_CONNECTION_OUTPUT (1 << 22)
+#define INITIAL_CONNECTIONS 16
+#define INITIAL_OUTPUT_BYTES 4096
+#define LISTEN_BACKLOG 128
+// the poll fds of the listening socket and of the wake pipe come before the connections'
+#define LISTENER_FD 0
+#define WAKE_FD 1
+#define FIRST_CONNECTION_FD 2
+// the latencies are counted in a histogram of log buckets for the percentiles: a bucket per
+// microsecond below LATENCY_SUB_BUCKETS, and LATENCY_SUB_BUCKETS buckets for every power of 2
+// above, so a percentile is off by at most 1 / LATENCY_SUB_BUCKETS of it
+#define LATENCY_SUB_BITS 3
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_BITS 64
+#define LATENCY_BUCKETS ((LATENCY_BITS - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS)
+#define STATS_ANSWER_BYTES 512
+#define NANOS_IN_SECOND 1e9
+#define MICROS_IN_SECOND 1e6
+#define WAKE_BYTES 64
+
+// the answers of a text request that is not solved
+#define NO_SOLUTION_ANSWER "no solution!\n"
+#define NOT_VALID_ANSWER "not a valid suduku file\n"
+#define STOPPED_ANSWER "search stopped!\n"
+#define FAILED_ANSWER "search failed!\n"
+
+// -------------------------- structs -----------------------------------
+typedef struct DaemonConnection DaemonConnection;
+
+/**
+ * a request of a connection. data is its bytes as they were read (without the magic of a binary
+ * one), and answer the bytes to write back, made by the thread that solved it. the requests of a
+ * connection are kept in a list in the order they came in, and they're answered from its head.
+ **/
+typedef struct DaemonRequest
+{
+	DaemonConnection* connection;
+	struct DaemonRequest* next;
+	int kind;
+	int done;
+	double arrival;
+	char* answer;
+	size_t answerLength;
+	size_t dataLength;
+	char data[];
+}DaemonRequest;
+
+/**
+ * a client's connection: the bytes read and not parsed yet, the answers not written yet, and the
+ * requests not answered yet. endOfInput is set when the client is done sending, and broken when
+ * the connection failed, so its answers are dropped.
+ **/
+struct DaemonConnection
+{
+	int fd;
+	int endOfInput;
+	int broken;
+	char* input;
+	size_t inputLength;
+	size_t inputCapacity;
+	char* output;
+	size_t outputLength;
+	size_t outputSent;
+	size_t outputCapacity;
+	DaemonRequest* head;
+	DaemonRequest* tail;
+	int numOfRequests;
+};
+
+/**
+ * a batch of boards, handed to a thread at once.
+ **/
+typedef struct DaemonBatch
+{
+	DaemonRequest* requests[BATCH_REQUESTS];
+	int numOfRequests;
+	struct DaemonBatch* next;
+}DaemonBatch;
+
+/**
+ * the pool of solving threads. the connections' thread adds batches to the queue, a thread takes
+ * the batch at its head, solves it, adds it to the done list and writes to the wake pipe if the
+ * list was empty, so the connections' thread takes the answers.
+ **/
+typedef struct DaemonPool
+{
+	SudukuDaemonOptions* options;
+	DaemonBatch* queueHead;
+	DaemonBatch* queueTail;
+	DaemonBatch* done;
+	int queueDepth;
+	int maxQueueDepth;
+	int stop;
+	int wakeFd;
+	pthread_mutex_t lock;
+	pthread_cond_t workReady;
+}DaemonPool;
+
+/**
+ * a solving thread, with its own solver and an array for its solutions.
+ **/
+typedef struct DaemonWorker
+{
+	DaemonPool* pool;
+	SudukuSolver* solver;
+	SudukuCell* solution;
+	pthread_t thread;
+}DaemonWorker;
+
+/**
+ * the state of the connections' thread: the connections and their poll fds, the boards read in
+ * this round over the connections, the spare batches, and the statistics.
+ **/
+typedef struct DaemonState
+{
+	DaemonPool* pool;
+	int listener;
+	int wakeReadFd;
+	DaemonConnection** connections;
+	struct pollfd* fds;
+	int numOfConnections;
+	int connectionsCapacity;
+	int numOfWorkers;
+	DaemonRequest** round;
+	int roundLength;
+	int roundCapacity;
+	DaemonBatch* spareBatches;
+	unsigned long requests;
+	unsigned long batches;
+	unsigned long batchedBoards;
+	int inFlight;
+	unsigned long latencyBuckets[LATENCY_BUCKETS];
+	unsigned long numOfLatencies;
+	unsigned long maxLatency;
+}DaemonState;
+
+// ------------------------------ globals -------------------------------
+// set by the signal handler, which wakes the connections' thread through the wake pipe
+static volatile sig_atomic_t stopRequested = FALSE;
+static int signalWakeFd = -1;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function returns the current time in seconds.
+ **/
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / NANOS_IN_SECOND;
+}
+
+/**
+ * the handler of SIGINT and SIGTERM: it asks the daemon to stop.
+ **/
+static void stopHandler(int signalNumber)
+{
+	(void)signalNumber;
+	int savedErrno = errno;
+	stopRequested = TRUE;
+	if (write(signalWakeFd, "s", 1) < 0)
+	{
+		// the pipe is full, so the daemon is woken anyway
+	}
+	errno = savedErrno;
+}
+
+/**
+ * This function makes a file descriptor non blocking.
+ * input :
+ * 		int fd - the file descriptor
+ * output :
+ * 		1 on success, else 0.
+ **/
+static int setNonBlocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL);
+	return (flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1);
+}
+
+/**
+ * This function solves a board request and makes its answer, in the form of the request.
+ * input :
+ * 		DaemonWorker* worker - the thread solving it
+ * 		DaemonRequest* request - the request
+ * output :
+ * 		void
+ **/
+static void solveRequest(DaemonWorker* worker, DaemonRequest* request)
+{
+	SudukuDaemonOptions* options = worker->pool->options;
+	DfsBudget budget;
+	initDfsBudget(&budget, options->nodeBudget, options->timeoutMillis);
+	DfsBudget* budgetPointer = (options->nodeBudget == DFS_NO_LIMIT && \
+								options->timeoutMillis == DFS_NO_LIMIT) ? NULL : &budget;
+	int size = 0, status;
+	if (request->kind == TEXT_REQUEST)
+	{
+		status = solveSudukuText(worker->solver, request->data, request->dataLength, &size, \
+								 worker->solution, budgetPointer);
+	}
+	else
+	{
+		size = (unsigned char)request->data[0];
+		status = solveSudukuCells(worker->solver, size, (SudukuCell*)request->data + 1, \
+								  worker->solution, budgetPointer);
+	}
+	int solved = (status == SUDUKU_SOLVE_OK);
+	size_t slots = solved ? size * size : 0;
+	size_t capacity = (request->kind == TEXT_REQUEST) ? \
+					  slots * TEXT_SLOT_BYTES + TEXT_SIZE_BYTES + sizeof(NOT_VALID_ANSWER) : \
+					  BINARY_ANSWER_HEADER + slots;
+	request->answer = (char*)malloc(capacity);
+	if (request->answer == NULL)
+	{
+		return;
+	}
+	if (request->kind == BINARY_REQUEST)
+	{
+		request->answer[0] = (char)SUDUKU_DAEMON_BINARY_MAGIC;
+		request->answer[1] = (char)status;
+		request->answer[2] = (char)(solved ? size : 0);
+		request->answerLength = BINARY_ANSWER_HEADER;
+		if (solved)
+		{
+			memcpy(request->answer + BINARY_ANSWER_HEADER, worker->solution, size * size);
+			request->answerLength += size * size;
+		}
+		return;
+	}
+	if (!solved)
+	{
+		const char* answer = (status == SUDUKU_SOLVE_NO_SOLUTION) ? NO_SOLUTION_ANSWER : \
+							 (status == SUDUKU_SOLVE_STOPPED) ? STOPPED_ANSWER : \
+							 (status == SUDUKU_SOLVE_FAILED) ? FAILED_ANSWER : NOT_VALID_ANSWER;
+		request->answerLength = strlen(answer);
+		memcpy(request->answer, answer, request->answerLength);
+		return;
+	}
+	// the size and the board, as sudukusolver prints them
+	size_t length = sprintf(request->answer, "%d\n", size);
+	int slot;
+	for (slot = 0; slot < size * size; slot++)
+	{
+		length += sprintf(request->answer + length, "%d", worker->solution[slot]);
+		request->answer[length] = (slot % size == size - 1) ? '\n' : ' ';
+		length++;
+	}
+	request->answerLength = length;
+}
+
+/**
+ * This function is the loop of a solving thread: it takes a batch from the queue, solves its
+ * boards, puts it in the done list and waits for the next one.
+ * input :
+ * 		void* workerStruct - the thread's DaemonWorker
+ * output :
+ * 		NULL
+ **/
+static void* workerLoop(void* workerStruct)
+{
+	DaemonWorker* worker = (DaemonWorker*)workerStruct;
+	DaemonPool* pool = worker->pool;
+	pthread_mutex_lock(&pool->lock);
+	while (TRUE)
+	{
+		while (pool->queueHead == NULL && !pool->stop)
+		{
+			pthread_cond_wait(&pool->workReady, &pool->lock);
+		}
+		if (pool->stop)
+		{
+			break;
+		}
+		DaemonBatch* batch = pool->queueHead;
+		pool->queueHead = batch->next;
+		if (pool->queueHead == NULL)
+		{
+			pool->queueTail = NULL;
+		}
+		pool->queueDepth -= batch->numOfRequests;
+		pthread_mutex_unlock(&pool->lock);
+		int i;
+		for (i = 0; i < batch->numOfRequests; i++)
+		{
+			solveRequest(worker, batch->requests[i]);
+		}
+		pthread_mutex_lock(&pool->lock);
+		batch->next = pool->done;
+		pool->done = batch;
+		// one byte in the pipe wakes the connections' thread for the whole list
+		if (batch->next == NULL && write(pool->wakeFd, "d", 1) < 0)
+		{
+			// the pipe is full, so the connections' thread is woken anyway
+		}
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+/**
+ * This function adds a board request to the boards read in this round over the connections.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * 		DaemonRequest* request - the request
+ * output :
+ * 		1 on success, 0 if memory allocation failed.
+ **/
+static int addToRound(DaemonState* daemon, DaemonRequest* request)
+{
+	if (daemon->roundLength == daemon->roundCapacity)
+	{
+		int capacity = (daemon->roundCapacity == 0) ? BATCH_REQUESTS : daemon->roundCapacity * 2;
+		DaemonRequest** round = (DaemonRequest**)realloc(daemon->round, \
+														 capacity * sizeof(DaemonRequest*));
+		if (round == NULL)
+		{
+			return FALSE;
+		}
+		daemon->round = round;
+		daemon->roundCapacity = capacity;
+	}
+	daemon->round[daemon->roundLength] = request;
+	daemon->roundLength++;
+	daemon->inFlight++;
+	return TRUE;
+}
+
+/**
+ * This function hands the boards read in this round to the solving threads, split evenly into a
+ * batch per thread of up to BATCH_REQUESTS boards, so a small round keeps all the threads busy
+ * and a big one takes the lock of the pool once per batch instead of once per board. a board
+ * left without a batch because memory allocation failed breaks its connection.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * output :
+ * 		void
+ **/
+static void submitRound(DaemonState* daemon)
+{
+	int batchSize = (daemon->roundLength + daemon->numOfWorkers - 1) / daemon->numOfWorkers;
+	batchSize = (batchSize > BATCH_REQUESTS) ? BATCH_REQUESTS : batchSize;
+	DaemonBatch* first = NULL;
+	DaemonBatch* last = NULL;
+	int position = 0, numOfBatches = 0;
+	while (position < daemon->roundLength)
+	{
+		DaemonBatch* batch = daemon->spareBatches;
+		if (batch != NULL)
+		{
+			daemon->spareBatches = batch->next;
+		}
+		else if ((batch = (DaemonBatch*)malloc(sizeof(DaemonBatch))) == NULL)
+		{
+			for (; position < daemon->roundLength; position++)
+			{
+				daemon->round[position]->kind = INVALID_REQUEST;
+				daemon->round[position]->done = TRUE;
+				daemon->inFlight--;
+			}
+			break;
+		}
+		batch->numOfRequests = daemon->roundLength - position;
+		batch->numOfRequests = (batch->numOfRequests > batchSize) ? batchSize : \
+							   batch->numOfRequests;
+		memcpy(batch->requests, daemon->round + position, \
+			   batch->numOfRequests * sizeof(DaemonRequest*));
+		position += batch->numOfRequests;
+		batch->next = NULL;
+		if (last == NULL)
+		{
+			first = batch;
+		}
+		else
+		{
+			last->next = batch;
+		}
+		last = batch;
+		numOfBatches++;
+		daemon->batches++;
+		daemon->batchedBoards += batch->numOfRequests;
+	}
+	int queued = position;
+	daemon->roundLength = 0;
+	if (first == NULL)
+	{
+		return;
+	}
+	DaemonPool* pool = daemon->pool;
+	pthread_mutex_lock(&pool->lock);
+	if (pool->queueTail == NULL)
+	{
+		pool->queueHead = first;
+	}
+	else
+	{
+		pool->queueTail->next = first;
+	}
+	pool->queueTail = last;
+	pool->queueDepth += queued;
+	if (pool->queueDepth > pool->maxQueueDepth)
+	{
+		pool->maxQueueDepth = pool->queueDepth;
+	}
+	if (numOfBatches == 1)
+	{
+		pthread_cond_signal(&pool->workReady);
+	}
+	else
+	{
+		pthread_cond_broadcast(&pool->workReady);
+	}
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * This function returns the bucket of a latency in the histogram of the latencies.
+ * input :
+ * 		unsigned long latency - the latency, in microseconds
+ * output :
+ * 		the index of its bucket.
+ **/
+static int latencyBucket(unsigned long latency)
+{
+	if (latency < LATENCY_SUB_BUCKETS)
+	{
+		return (int)latency;
+	}
+	// the power of 2 picks the group of buckets, and the bits after the highest one the bucket
+	int power = LATENCY_BITS - 1 - __builtin_clzl(latency);
+	return (power - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS + \
+		   (int)((latency >> (power - LATENCY_SUB_BITS)) & (LATENCY_SUB_BUCKETS - 1));
+}
+
+/**
+ * This function returns the biggest latency of a bucket in the histogram of the latencies.
+ * input :
+ * 		int bucket - the index of the bucket
+ * output :
+ * 		the latency, in microseconds.
+ **/
+static unsigned long bucketLatency(int bucket)
+{
+	if (bucket < LATENCY_SUB_BUCKETS)
+	{
+		return (unsigned long)bucket;
+	}
+	int shift = bucket / LATENCY_SUB_BUCKETS - 1;
+	unsigned long first = (unsigned long)(LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS) << \
+						  shift;
+	return first + ((1UL << shift) - 1);
+}
+
+/**
+ * This function writes the line of the daemon's statistics.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * 		char* buffer - a buffer of STATS_ANSWER_BYTES bytes
+ * output :
+ * 		the length of the line.
+ **/
+static size_t formatStats(DaemonState* daemon, char* buffer)
+{
+	unsigned long count = daemon->numOfLatencies;
+	// the nearest rank percentiles: the latency that many per mill of the boards were within,
+	// which is the biggest of its bucket (or the biggest latency so far, if it's less)
+	const int perMills[] = {500, 900, 990, 999, 1000};
+	unsigned long percentiles[sizeof(perMills) / sizeof(perMills[0])] = {0};
+	unsigned long seen = 0;
+	size_t i;
+	int bucket = 0;
+	for (i = 0; count > 0 && i < sizeof(perMills) / sizeof(perMills[0]); i++)
+	{
+		unsigned long rank = (count * perMills[i] + 999) / 1000;
+		rank = (rank == 0) ? 1 : rank;
+		while (seen + daemon->latencyBuckets[bucket] < rank)
+		{
+			seen += daemon->latencyBuckets[bucket];
+			bucket++;
+		}
+		percentiles[i] = bucketLatency(bucket);
+		percentiles[i] = (percentiles[i] > daemon->maxLatency) ? daemon->maxLatency : \
+						 percentiles[i];
+	}
+	pthread_mutex_lock(&daemon->pool->lock);
+	int queueDepth = daemon->pool->queueDepth, maxQueueDepth = daemon->pool->maxQueueDepth;
+	pthread_mutex_unlock(&daemon->pool->lock);
+	int length = snprintf(buffer, STATS_ANSWER_BYTES, "requests=%lu batches=%lu " \
+						  "boards_per_batch=%.2f queue_depth=%d max_queue_depth=%d in_flight=%d " \
+						  "connections=%d p50_us=%lu p90_us=%lu p99_us=%lu p999_us=%lu " \
+						  "max_us=%lu\n", daemon->requests, daemon->batches, \
+						  (daemon->batches == 0) ? 0.0 : \
+						  (double)daemon->batchedBoards / daemon->batches, queueDepth, \
+						  maxQueueDepth, daemon->inFlight, daemon->numOfConnections, \
+						  percentiles[0], percentiles[1], percentiles[2], percentiles[3], \
+						  percentiles[4]);
+	return (length < STATS_ANSWER_BYTES) ? (size_t)length : STATS_ANSWER_BYTES - 1;
+}
+
+/**
+ * This function finds the next token (a run of chars that are not white space) of a text
+ * request.
+ * input :
+ * 		const char* input - the input of the connection
+ * 		size_t length - the length of the input
+ * 		int endOfInput - 1 if no more input will come, so the last token is whole
+ * 		size_t* start - a pointer to put the start of the token in
+ * 		size_t* position - the position to look from, set to the end of the token
+ * output :
+ * 		1 if a whole token was found, 0 if the input ends before.
+ **/
+static int nextToken(const char* input, size_t length, int endOfInput, size_t* start, \
+					 size_t* position)
+{
+	size_t index = *position;
+	while (index < length && isspace((unsigned char)input[index]))
+	{
+		index++;
+	}
+	*start = index;
+	while (index < length && !isspace((unsigned char)input[index]))
+	{
+		index++;
+	}
+	// a token that runs to the end of the input may go on in the next read
+	if (index == *start || (index == length && !endOfInput))
+	{
+		return FALSE;
+	}
+	*position = index;
+	return TRUE;
+}
+
+/**
+ * This function finds the end of the request at the start of a connection's input, which is not
+ * white space: a binary board, the stats request, or a text board, which ends with the last of
+ * its nums (even at the end of the input, if no digit can follow it). a text request that
+ * doesn't start with a size is invalid up to the end of its line.
+ * input :
+ * 		const char* input - the input
+ * 		size_t length - the length of the input, more than 0
+ * 		int endOfInput - 1 if no more input will come, so what's left is a request, maybe an
+ * 						 invalid one
+ * 		int* kind - a pointer to put the kind of the request in
+ * output :
+ * 		the length of the request, 0 if it's not all in the input yet.
+ **/
+static size_t scanRequest(const char* input, size_t length, int endOfInput, int* kind)
+{
+	const unsigned char* bytes = (const unsigned char*)input;
+	if (bytes[0] == SUDUKU_DAEMON_BINARY_MAGIC)
+	{
+		*kind = BINARY_REQUEST;
+		if (length >= BINARY_REQUEST_HEADER && \
+			length >= BINARY_REQUEST_HEADER + (size_t)bytes[1] * bytes[1])
+		{
+			return BINARY_REQUEST_HEADER + (size_t)bytes[1] * bytes[1];
+		}
+		*kind = INVALID_BINARY_REQUEST;
+		return endOfInput ? length : 0;
+	}
+	size_t start, position = 0;
+	*kind = INVALID_REQUEST;
+	if (!nextToken(input, length, endOfInput, &start, &position))
+	{
+		return endOfInput ? length : 0;
+	}
+	if (position == strlen(SUDUKU_DAEMON_STATS_REQUEST) && \
+		strncmp(input, SUDUKU_DAEMON_STATS_REQUEST, position) == 0)
+	{
+		*kind = STATS_REQUEST;
+		return position;
+	}
+	int size = 0;
+	for (; start < position && isdigit(bytes[start]) && size <= SUDUKU_MAX_SIZE; start++)
+	{
+		size = size * 10 + (bytes[start] - '0');
+	}
+	if (start < position || size == 0 || size > SUDUKU_MAX_SIZE)
+	{
+		// the rest of the board can't be told apart from the next request, so the whole line is
+		// dropped
+		const char* endOfLine = memchr(input + position, '\n', length - position);
+		if (endOfLine != NULL)
+		{
+			return endOfLine - input + 1;
+		}
+		return endOfInput ? length : 0;
+	}
+	int slot;
+	for (slot = 0; slot < size * size - 1; slot++)
+	{
+		if (!nextToken(input, length, endOfInput, &start, &position))
+		{
+			return endOfInput ? length : 0;
+		}
+	}
+	// the last num may end the input without white space after it. it's whole unless a digit
+	// after it would make another num of the board, so the board is answered without waiting
+	if (!nextToken(input, length, TRUE, &start, &position))
+	{
+		return endOfInput ? length : 0;
+	}
+	if (position == length && !endOfInput)
+	{
+		int num = 0;
+		for (; start < position && isdigit(bytes[start]) && num <= size; start++)
+		{
+			num = num * 10 + (bytes[start] - '0');
+		}
+		if (start == position && num != 0 && num * 10 <= size)
+		{
+			return 0;
+		}
+	}
+	*kind = TEXT_REQUEST;
+	return position;
+}
+
+/**
+ * This function appends bytes to the answers a connection has to write.
+ * input :
+ * 		DaemonConnection* connection - the connection
+ * 		const char* bytes - the bytes
+ * 		size_t length - the number of bytes
+ * output :
+ * 		1 on success, 0 if memory allocation failed.
+ **/
+static int appendOutput(DaemonConnection* connection, const char* bytes, size_t length)
+{
+	if (connection->outputLength + length > connection->outputCapacity)
+	{
+		size_t capacity = (connection->outputCapacity == 0) ? INITIAL_OUTPUT_BYTES : \
+						  connection->outputCapacity;
+		while (capacity < connection->outputLength + length)
+		{
+			capacity *= 2;
+		}
+		char* output = (char*)realloc(connection->output, capacity);
+		if (output == NULL)
+		{
+			return FALSE;
+		}
+		connection->output = output;
+		connection->outputCapacity = capacity;
+	}
+	memcpy(connection->output + connection->outputLength, bytes, length);
+	connection->outputLength += length;
+	return TRUE;
+}
+
+/**
+ * This function marks a connection as failed: its input and answers are dropped, and it's closed
+ * once its requests in the solving threads are back.
+ * input :
+ * 		DaemonConnection* connection - the connection
+ * output :
+ * 		void
+ **/
+static void breakConnection(DaemonConnection* connection)
+{
+	connection->broken = TRUE;
+	connection->endOfInput = TRUE;
+	connection->inputLength = 0;
+	connection->outputLength = 0;
+	connection->outputSent = 0;
+}
+
+/**
+ * This function parses the whole requests in a connection's input: the boards join the batch
+ * being filled, and the other requests are answered at once.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * 		DaemonConnection* connection - the connection
+ * output :
+ * 		void
+ **/
+static void parseRequests(DaemonState* daemon, DaemonConnection* connection)
+{
+	size_t position = 0;
+	while (connection->numOfRequests < MAX_CONNECTION_REQUESTS)
+	{
+		while (position < connection->inputLength && \
+			   isspace((unsigned char)connection->input[position]))
+		{
+			position++;
+		}
+		if (position == connection->inputLength)
+		{
+			break;
+		}
+		int kind;
+		size_t length = scanRequest(connection->input + position, \
+									connection->inputLength - position, connection->endOfInput, \
+									&kind);
+		if (length == 0)
+		{
+			if (connection->inputLength - position <= MAX_REQUEST_BYTES)
+			{
+				break;
+			}
+			// a request too long to be a board: it's answered as invalid and the rest is dropped
+			length = connection->inputLength - position;
+			kind = ((unsigned char)connection->input[position] == SUDUKU_DAEMON_BINARY_MAGIC) ? \
+				   INVALID_BINARY_REQUEST : INVALID_REQUEST;
+			connection->endOfInput = TRUE;
+		}
+		// a binary board keeps its size and slots, without the magic
+		size_t skip = (kind == BINARY_REQUEST) ? 1 : 0;
+		size_t dataLength = (kind == TEXT_REQUEST || kind == BINARY_REQUEST) ? length - skip : 0;
+		DaemonRequest* request = (DaemonRequest*)malloc(sizeof(DaemonRequest) + dataLength);
+		if (request == NULL)
+		{
+			breakConnection(connection);
+			return;
+		}
+		memcpy(request->data, connection->input + position + skip, dataLength);
+		position += length;
+		request->connection = connection;
+		request->next = NULL;
+		request->kind = kind;
+		request->done = FALSE;
+		request->arrival = now();
+		request->answer = NULL;
+		request->answerLength = 0;
+		request->dataLength = dataLength;
+		if (connection->tail == NULL)
+		{
+			connection->head = request;
+		}
+		else
+		{
+			connection->tail->next = request;
+		}
+		connection->tail = request;
+		connection->numOfRequests++;
+		daemon->requests++;
+		if (kind == TEXT_REQUEST || kind == BINARY_REQUEST)
+		{
+			if (!addToRound(daemon, request))
+			{
+				request->kind = INVALID_REQUEST;
+				request->done = TRUE;
+				breakConnection(connection);
+				return;
+			}
+			continue;
+		}
+		request->done = TRUE;
+		char stats[STATS_ANSWER_BYTES];
+		const char binaryAnswer[BINARY_ANSWER_HEADER] = {(char)SUDUKU_DAEMON_BINARY_MAGIC, \
+														  SUDUKU_SOLVE_NOT_VALID, 0};
+		const char* answer = NOT_VALID_ANSWER;
+		request->answerLength = strlen(NOT_VALID_ANSWER);
+		if (kind == STATS_REQUEST)
+		{
+			answer = stats;
+			request->answerLength = formatStats(daemon, stats);
+		}
+		else if (kind == INVALID_BINARY_REQUEST)
+		{
+			answer = binaryAnswer;
+			request->answerLength = BINARY_ANSWER_HEADER;
+		}
+		if ((request->answer = (char*)malloc(request->answerLength)) != NULL)
+		{
+			memcpy(request->answer, answer, request->answerLength);
+		}
+	}
+	memmove(connection->input, connection->input + position, connection->inputLength - position);
+	connection->inputLength -= position;
+}
+
+/**
+ * This function reads what a connection has to read, and parses its requests.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * 		DaemonConnection* connection - the connection
+ * output :
+ * 		void
+ **/
+static void readConnection(DaemonState* daemon, DaemonConnection* connection)
+{
+	if (connection->inputCapacity - connection->inputLength < READ_BYTES)
+	{
+		size_t capacity = connection->inputLength + READ_BYTES;
+		char* input = (char*)realloc(connection->input, capacity);
+		if (input == NULL)
+		{
+			breakConnection(connection);
+			return;
+		}
+		connection->input = input;
+		connection->inputCapacity = capacity;
+	}
+	ssize_t bytes = read(connection->fd, connection->input + connection->inputLength, READ_BYTES);
+	if (bytes == 0)
+	{
+		connection->endOfInput = TRUE;
+	}
+	else if (bytes < 0)
+	{
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+		{
+			breakConnection(connection);
+		}
+		return;
+	}
+	connection->inputLength += bytes;
+	parseRequests(daemon, connection);
+}
+
+/**
+ * This function moves the answers at the head of a connection's requests that are done to its
+ * output, in order, and frees their requests.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * 		DaemonConnection* connection - the connection
+ * output :
+ * 		void
+ **/
+static void collectAnswers(DaemonState* daemon, DaemonConnection* connection)
+{
+	double time = now();
+	while (connection->head != NULL && connection->head->done)
+	{
+		DaemonRequest* request = connection->head;
+		if (request->kind == TEXT_REQUEST || request->kind == BINARY_REQUEST)
+		{
+			unsigned long latency = (unsigned long)((time - request->arrival) * MICROS_IN_SECOND);
+			daemon->latencyBuckets[latencyBucket(latency)]++;
+			daemon->numOfLatencies++;
+			daemon->maxLatency = (latency > daemon->maxLatency) ? latency : daemon->maxLatency;
+			daemon->inFlight--;
+		}
+		if (!connection->broken && (request->answer == NULL || \
+			!appendOutput(connection, request->answer, request->answerLength)))
+		{
+			breakConnection(connection);
+		}
+		connection->head = request->next;
+		if (connection->head == NULL)
+		{
+			connection->tail = NULL;
+		}
+		connection->numOfRequests--;
+		free(request->answer);
+		free(request);
+	}
+}
+
+/**
+ * This function writes what a connection can take of its answers.
+ * input :
+ * 		DaemonConnection* connection - the connection
+ * output :
+ * 		void
+ **/
+static void writeConnection(DaemonConnection* connection)
+{
+	while (connection->outputSent < connection->outputLength)
+	{
+		ssize_t bytes = send(connection->fd, connection->output + connection->outputSent, \
+							 connection->outputLength - connection->outputSent, MSG_NOSIGNAL);
+		if (bytes < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+			{
+				breakConnection(connection);
+			}
+			return;
+		}
+		connection->outputSent += bytes;
+	}
+	connection->outputLength = 0;
+	connection->outputSent = 0;
+}
+
+/**
+ * This function frees a connection and its requests, and closes its socket.
+ * input :
+ * 		DaemonConnection* connection - the connection
+ * output :
+ * 		void
+ **/
+static void freeConnection(DaemonConnection* connection)
+{
+	while (connection->head != NULL)
+	{
+		DaemonRequest* request = connection->head;
+		connection->head = request->next;
+		free(request->answer);
+		free(request);
+	}
+	close(connection->fd);
+	free(connection->input);
+	free(connection->output);
+	free(connection);
+}
+
+/**
+ * This function accepts the waiting connections.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * output :
+ * 		void
+ **/
+static void acceptConnections(DaemonState* daemon)
+{
+	while (TRUE)
+	{
+		int fd = accept(daemon->listener, NULL, NULL);
+		if (fd < 0)
+		{
+			return;
+		}
+		if (daemon->numOfConnections == daemon->connectionsCapacity)
+		{
+			int capacity = daemon->connectionsCapacity * 2;
+			DaemonConnection** connections = (DaemonConnection**)realloc(daemon->connections, \
+											 capacity * sizeof(DaemonConnection*));
+			if (connections != NULL)
+			{
+				daemon->connections = connections;
+			}
+			struct pollfd* fds = (struct pollfd*)realloc(daemon->fds, \
+								 (capacity + FIRST_CONNECTION_FD) * sizeof(struct pollfd));
+			if (fds != NULL)
+			{
+				daemon->fds = fds;
+			}
+			if (connections == NULL || fds == NULL)
+			{
+				close(fd);
+				return;
+			}
+			daemon->connectionsCapacity = capacity;
+		}
+		DaemonConnection* connection = (DaemonConnection*)calloc(1, sizeof(DaemonConnection));
+		if (connection == NULL || !setNonBlocking(fd))
+		{
+			free(connection);
+			close(fd);
+			continue;
+		}
+		connection->fd = fd;
+		daemon->connections[daemon->numOfConnections] = connection;
+		daemon->numOfConnections++;
+	}
+}
+
+/**
+ * This function takes the batches the solving threads are done with, marks their requests as
+ * done and keeps the batches for reuse.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * output :
+ * 		void
+ **/
+static void takeDoneBatches(DaemonState* daemon)
+{
+	char bytes[WAKE_BYTES];
+	while (read(daemon->wakeReadFd, bytes, sizeof(bytes)) > 0)
+	{
+	}
+	pthread_mutex_lock(&daemon->pool->lock);
+	DaemonBatch* batch = daemon->pool->done;
+	daemon->pool->done = NULL;
+	pthread_mutex_unlock(&daemon->pool->lock);
+	while (batch != NULL)
+	{
+		DaemonBatch* next = batch->next;
+		int i;
+		for (i = 0; i < batch->numOfRequests; i++)
+		{
+			batch->requests[i]->done = TRUE;
+		}
+		batch->next = daemon->spareBatches;
+		daemon->spareBatches = batch;
+		batch = next;
+	}
+}
+
+/**
+ * This function serves the connections until a signal stops the daemon: it waits for the
+ * sockets and the wake pipe, reads and parses the requests, hands their boards to the solving
+ * threads in batches, and writes the answers that are ready.
+ * input :
+ * 		DaemonState* daemon - the daemon
+ * output :
+ * 		0 if it stopped by a signal, 1 if poll failed.
+ **/
+static int serveConnections(DaemonState* daemon)
+{
+	while (!stopRequested)
+	{
+		int i, numOfFds = FIRST_CONNECTION_FD + daemon->numOfConnections;
+		daemon->fds[LISTENER_FD].fd = daemon->listener;
+		daemon->fds[LISTENER_FD].events = POLLIN;
+		daemon->fds[WAKE_FD].fd = daemon->wakeReadFd;
+		daemon->fds[WAKE_FD].events = POLLIN;
+		for (i = 0; i < daemon->numOfConnections; i++)
+		{
+			DaemonConnection* connection = daemon->connections[i];
+			struct pollfd* fd = &daemon->fds[FIRST_CONNECTION_FD + i];
+			fd->fd = connection->fd;
+			fd->events = 0;
+			fd->revents = 0;
+			if (!connection->endOfInput && connection->numOfRequests < MAX_CONNECTION_REQUESTS \
+				&& connection->outputLength < MAX_CONNECTION_OUTPUT)
+			{
+				fd->events |= POLLIN;
+			}
+			if (connection->outputSent < connection->outputLength)
+			{
+				fd->events |= POLLOUT;
+			}
+			// poll skips a negative fd, so a connection that hung up while it waits for its
+			// answers doesn't wake it over and over
+			if (fd->events == 0)
+			{
+				fd->fd = -1;
+			}
+		}
+		if (poll(daemon->fds, numOfFds, -1) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return EXIT_FAILURE;
+		}
+		if (daemon->fds[WAKE_FD].revents & POLLIN)
+		{
+			takeDoneBatches(daemon);
+		}
+		// the boards read in this round are handed to the solving threads together
+		for (i = 0; i < numOfFds - FIRST_CONNECTION_FD; i++)
+		{
+			short revents = daemon->fds[FIRST_CONNECTION_FD + i].revents;
+			if (revents & (POLLERR | POLLNVAL))
+			{
+				breakConnection(daemon->connections[i]);
+			}
+			else if (revents & (POLLIN | POLLHUP))
+			{
+				readConnection(daemon, daemon->connections[i]);
+			}
+		}
+		if (daemon->fds[LISTENER_FD].revents & POLLIN)
+		{
+			acceptConnections(daemon);
+		}
+		// a connection held back by its answers goes on parsing once they're written
+		for (i = daemon->numOfConnections - 1; i >= 0; i--)
+		{
+			DaemonConnection* connection = daemon->connections[i];
+			collectAnswers(daemon, connection);
+			writeConnection(connection);
+			if (connection->inputLength > 0 && connection->outputLength < MAX_CONNECTION_OUTPUT)
+			{
+				parseRequests(daemon, connection);
+			}
+			if (connection->endOfInput && connection->numOfRequests == 0 && \
+				connection->inputLength == 0 && connection->outputLength == 0)
+			{
+				freeConnection(connection);
+				daemon->numOfConnections--;
+				daemon->connections[i] = daemon->connections[daemon->numOfConnections];
+			}
+		}
+		submitRound(daemon);
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+ * This function makes the listening socket of the daemon, replacing an old socket file.
+ * input :
+ * 		const char* socketPath - the path of the socket
+ * output :
+ * 		the socket, -1 if it can't be made.
+ **/
+static int createListener(const char* socketPath)
+{
+	struct sockaddr_un address;
+	if (strlen(socketPath) >= sizeof(address.sun_path))
+	{
+		return -1;
+	}
+	// only a socket is replaced, never another kind of file
+	struct stat status;
+	if (lstat(socketPath, &status) == 0 && S_ISSOCK(status.st_mode))
+	{
+		unlink(socketPath);
+	}
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0)
+	{
+		return -1;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, socketPath);
+	if (bind(listener, (struct sockaddr*)&address, sizeof(address)) < 0 || \
+		listen(listener, LISTEN_BACKLOG) < 0 || !setNonBlocking(listener))
+	{
+		close(listener);
+		return -1;
+	}
+	return listener;
+}
+
+/**
+ * This function runs a daemon that solves boards for the clients of a Unix domain socket, until
+ * it gets SIGINT or SIGTERM. a client sends any number of requests on a connection without
+ * waiting for the answers, and gets the answers in the order of its requests. a request is
+ * either:
+ * 		a board in the text format of a board file (the size and then size * size nums), answered
+ * 		as sudukusolver prints it: the size and the solved board, or a line of "no solution!",
+ * 		"not a valid suduku file", "search stopped!" (the budget ran out) or "search failed!"
+ * 		(see SUDUKU_SOLVE_FAILED). a last num that could take another digit (like the 1 of a
+ * 		board of 16) is answered only after white space or the end of the connection's input
+ * 		a board in the binary form: SUDUKU_DAEMON_BINARY_MAGIC, a byte of the size and a byte per
+ * 		slot, row after row. it's answered with SUDUKU_DAEMON_BINARY_MAGIC, a status byte (one of
+ * 		the SUDUKU_SOLVE_ consts of sudukulib.h), a byte of the size and, if the status is
+ * 		SUDUKU_SOLVE_OK, a byte per slot of the solution
+ * 		the word SUDUKU_DAEMON_STATS_REQUEST, answered with a line of key=value fields: the
+ * 		requests and batches so far, the queue depth (the boards waiting for a thread) and its
+ * 		peak, and the percentiles of the latency of the boards so far (within an eighth), from
+ * 		the time a board was read to the time its answer was ready to be written
+ * one thread serves all the connections. the boards it reads in a round over the connections are
+ * split into a batch per solving thread, so a busy daemon hands many boards to a thread at once
+ * and an idle one hands every board on its own, without waiting for more. the socket file is made
+ * by the daemon and removed when it stops, and the statistics are printed to stderr at the end.
+ * input :
+ * 		const char* socketPath - the path of the socket. an old socket file there is replaced
+ * 		SudukuDaemonOptions* options - the options of the daemon
+ * output :
+ * 		0 if it stopped by a signal, 1 if the socket, memory allocation or a thread failed.
+ **/
+int runSudukuDaemon(const char* socketPath, SudukuDaemonOptions* options)
+{
+	int numOfWorkers = options->numOfThreads;
+	if (numOfWorkers <= 0)
+	{
+		numOfWorkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		numOfWorkers = (numOfWorkers > 0) ? numOfWorkers : 1;
+	}
+	int wakePipe[2];
+	if (pipe(wakePipe) < 0)
+	{
+		return EXIT_FAILURE;
+	}
+	DaemonPool pool;
+	memset(&pool, 0, sizeof(pool));
+	pool.options = options;
+	pool.wakeFd = wakePipe[1];
+	DaemonState daemon;
+	memset(&daemon, 0, sizeof(daemon));
+	daemon.pool = &pool;
+	daemon.wakeReadFd = wakePipe[0];
+	daemon.numOfWorkers = numOfWorkers;
+	daemon.connectionsCapacity = INITIAL_CONNECTIONS;
+	daemon.connections = (DaemonConnection**)malloc(INITIAL_CONNECTIONS * \
+													sizeof(DaemonConnection*));
+	daemon.fds = (struct pollfd*)malloc((INITIAL_CONNECTIONS + FIRST_CONNECTION_FD) * \
+										sizeof(struct pollfd));
+	DaemonWorker* workers = (DaemonWorker*)calloc(numOfWorkers, sizeof(DaemonWorker));
+	int i, valid = (daemon.connections != NULL && daemon.fds != NULL && workers != NULL && \
+					setNonBlocking(wakePipe[0]) && setNonBlocking(wakePipe[1]));
+	// every thread's solver is made up front, so solving allocates nothing
+	for (i = 0; valid && i < numOfWorkers; i++)
+	{
+		workers[i].pool = &pool;
+		workers[i].solver = createSudukuSolver(options->maxSize);
+		workers[i].solution = (SudukuCell*)malloc(options->maxSize * options->maxSize * \
+												  sizeof(SudukuCell));
+		valid = (workers[i].solver != NULL && workers[i].solution != NULL);
+	}
+	daemon.listener = valid ? createListener(socketPath) : -1;
+	valid = valid && (daemon.listener >= 0);
+	int result = valid ? EXIT_SUCCESS : EXIT_FAILURE;
+	int numOfThreads = 0;
+	if (valid)
+	{
+		pthread_mutex_init(&pool.lock, NULL);
+		pthread_cond_init(&pool.workReady, NULL);
+		for (numOfThreads = 0; numOfThreads < numOfWorkers; numOfThreads++)
+		{
+			if (pthread_create(&workers[numOfThreads].thread, NULL, workerLoop, \
+							   &workers[numOfThreads]) != 0)
+			{
+				result = EXIT_FAILURE;
+				break;
+			}
+		}
+	}
+	if (result == EXIT_SUCCESS)
+	{
+		signalWakeFd = wakePipe[1];
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler = stopHandler;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGINT, &action, NULL);
+		sigaction(SIGTERM, &action, NULL);
+		fprintf(stderr, "solving boards of up to %dx%d on %d threads at %s\n", options->maxSize, \
+				options->maxSize, numOfThreads, socketPath);
+		result = serveConnections(&daemon);
+		char stats[STATS_ANSWER_BYTES];
+		formatStats(&daemon, stats);
+		fputs(stats, stderr);
+	}
+	if (valid)
+	{
+		pthread_mutex_lock(&pool.lock);
+		pool.stop = TRUE;
+		pthread_cond_broadcast(&pool.workReady);
+		pthread_mutex_unlock(&pool.lock);
+		for (i = 0; i < numOfThreads; i++)
+		{
+			pthread_join(workers[i].thread, NULL);
+		}
+		pthread_mutex_destroy(&pool.lock);
+		pthread_cond_destroy(&pool.workReady);
+		close(daemon.listener);
+		unlink(socketPath);
+	}
+	// the requests are freed with their connections, and the batches on their own
+	for (i = 0; i < daemon.numOfConnections; i++)
+	{
+		freeConnection(daemon.connections[i]);
+	}
+	DaemonBatch* lists[] = {pool.queueHead, pool.done, daemon.spareBatches};
+	for (i = 0; i < (int)(sizeof(lists) / sizeof(lists[0])); i++)
+	{
+		while (lists[i] != NULL)
+		{
+			DaemonBatch* next = lists[i]->next;
+			free(lists[i]);
+			lists[i] = next;
+		}
+	}
+	free(daemon.round);
+	for (i = 0; workers != NULL && i < numOfWorkers; i++)
+	{
+		freeSudukuSolver(workers[i].solver);
+		free(workers[i].solution);
+	}
+	free(workers);
+	free(daemon.connections);
+	free(daemon.fds);
+	close(wakePipe[0]);
+	close(wakePipe[1]);
+	return result;
+}
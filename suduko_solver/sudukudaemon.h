@@ -0,0 +1,67 @@
+/**
+ ===================================================================================================
+ Name        : sudukudaemon.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukudaemon.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukudaemon_H
+#define sudukudaemon_H
+
+//********      consts
+// the first byte of a request (and of its answer) in the binary form. it's not a char of the text
+// form, so the two forms can be mixed on a connection
+#define SUDUKU_DAEMON_BINARY_MAGIC 0xB5
+// the request that is answered with a line of the daemon's statistics instead of a board
+#define SUDUKU_DAEMON_STATS_REQUEST "stats"
+
+//********      structs
+/**
+ * struct for the options of a daemon.
+ * int numOfThreads - the number of solving threads. 0 or less uses one per online processor
+ * int maxSize - the biggest size of the boards it solves, a square up to SUDUKU_MAX_SIZE. every
+ * thread holds a solver for it, of about 4 * maxSize^3 bytes
+ * unsigned long nodeBudget - the most nodes the search of a board expands, 0 for no limit
+ * unsigned long timeoutMillis - the most milliseconds the search of a board takes, 0 for no limit
+ **/
+typedef struct SudukuDaemonOptions
+{
+	int numOfThreads;
+	int maxSize;
+	unsigned long nodeBudget;
+	unsigned long timeoutMillis;
+}SudukuDaemonOptions;
+
+//********      functions
+/**
+ * This function runs a daemon that solves boards for the clients of a Unix domain socket, until
+ * it gets SIGINT or SIGTERM. a client sends any number of requests on a connection without
+ * waiting for the answers, and gets the answers in the order of its requests. a request is
+ * either:
+ * 		a board in the text format of a board file (the size and then size * size nums), answered
+ * 		as sudukusolver prints it: the size and the solved board, or a line of "no solution!",
+ * 		"not a valid suduku file", "search stopped!" (the budget ran out) or "search failed!"
+ * 		(see SUDUKU_SOLVE_FAILED). a last num that could take another digit (like the 1 of a
+ * 		board of 16) is answered only after white space or the end of the connection's input
+ * 		a board in the binary form: SUDUKU_DAEMON_BINARY_MAGIC, a byte of the size and a byte per
+ * 		slot, row after row. it's answered with SUDUKU_DAEMON_BINARY_MAGIC, a status byte (one of
+ * 		the SUDUKU_SOLVE_ consts of sudukulib.h), a byte of the size and, if the status is
+ * 		SUDUKU_SOLVE_OK, a byte per slot of the solution
+ * 		the word SUDUKU_DAEMON_STATS_REQUEST, answered with a line of key=value fields: the
+ * 		requests and batches so far, the queue depth (the boards waiting for a thread) and its
+ * 		peak, and the percentiles of the latency of the boards so far (within an eighth), from
+ * 		the time a board was read to the time its answer was ready to be written
+ * one thread serves all the connections. the boards it reads in a round over the connections are
+ * split into a batch per solving thread, so a busy daemon hands many boards to a thread at once
+ * and an idle one hands every board on its own, without waiting for more. the socket file is made
+ * by the daemon and removed when it stops, and the statistics are printed to stderr at the end.
+ * input :
+ * 		const char* socketPath - the path of the socket. an old socket file there is replaced
+ * 		SudukuDaemonOptions* options - the options of the daemon
+ * output :
+ * 		0 if it stopped by a signal, 1 if the socket, memory allocation or a thread failed.
+ **/
+int runSudukuDaemon(const char* socketPath, SudukuDaemonOptions* options);
+
+#endif // sudukudaemon_H
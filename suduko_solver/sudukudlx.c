@@ -0,0 +1,378 @@
+/**
+ ===================================================================================================
+ Name        : sudukudlx.c
+ Author      : Yinnon Bratspiess
+ Description : This file solves a suduku board as an exact cover problem, using Knuth's
+ * 			   Algorithm X on a Dancing Links matrix.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "sudukutree.h"
+#include "sudukudlx.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define EMPTY_SLOT 0
+// the index of the root in the nodes array. the column headers come right after it
+#define ROOT 0
+// the constraint families. every family has size * size columns
+#define SLOT_FAMILY 0
+#define ROW_FAMILY 1
+#define COL_FAMILY 2
+#define BOX_FAMILY 3
+#define FAMILIES 4
+
+// -------------------------- structs -----------------------------------
+/**
+ * a node of the matrix. the links are indices in the nodes array. a column header's column is
+ * itself, and a row node's choice is the (row, col, digit) it stands for, as
+ * slot * size + digit - 1.
+ **/
+typedef struct DlxNode
+{
+	int left;
+	int right;
+	int up;
+	int down;
+	int column;
+	int choice;
+}DlxNode;
+
+/**
+ * the matrix and the search state. the nodes, the column sizes and the solution are one arena.
+ **/
+typedef struct DlxMatrix
+{
+	DlxNode* nodes;
+	int numOfNodes;
+	// the number of row nodes in every column, by the index of its header
+	int* columnSizes;
+	// the choices of the current partial solution
+	int* solution;
+	int solutionLength;
+	int size;
+	int boxSize;
+	SudukuContext* context;
+}DlxMatrix;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function returns the index of the header of a column.
+ * input :
+ * 		int size - the size of the board
+ * 		int family - the constraint family of the column
+ * 		int unit - the slot for SLOT_FAMILY, else the row, col or little board
+ * 		int digit - the digit, ignored for SLOT_FAMILY
+ * output :
+ * 		the index of the header in the nodes array
+ **/
+static int columnHeader(int size, int family, int unit, int digit)
+{
+	if (family == SLOT_FAMILY)
+	{
+		return ROOT + 1 + unit;
+	}
+	return ROOT + 1 + family * size * size + unit * size + digit - 1;
+}
+
+/**
+ * This function adds a row node at the bottom of a column.
+ * input :
+ * 		DlxMatrix* matrix - the matrix
+ * 		int header - the index of the column's header
+ * 		int choice - the choice of the row
+ * output :
+ * 		the index of the new node
+ **/
+static int addToColumn(DlxMatrix* matrix, int header, int choice)
+{
+	DlxNode* nodes = matrix->nodes;
+	int node = matrix->numOfNodes;
+	matrix->numOfNodes++;
+	nodes[node].column = header;
+	nodes[node].choice = choice;
+	nodes[node].up = nodes[header].up;
+	nodes[node].down = header;
+	nodes[nodes[header].up].down = node;
+	nodes[header].up = node;
+	matrix->columnSizes[header]++;
+	return node;
+}
+
+/**
+ * This function adds the row of a (row, col, digit) choice to the matrix: one node in the column
+ * of every constraint family, linked in a circular row.
+ * input :
+ * 		DlxMatrix* matrix - the matrix
+ * 		int row - the row of the slot
+ * 		int col - the col of the slot
+ * 		int digit - the digit
+ * output :
+ * 		void
+ **/
+static void addChoice(DlxMatrix* matrix, int row, int col, int digit)
+{
+	int size = matrix->size;
+	int box = (row / matrix->boxSize) * matrix->boxSize + col / matrix->boxSize;
+	int headers[FAMILIES] = {columnHeader(size, SLOT_FAMILY, row * size + col, digit), \
+							 columnHeader(size, ROW_FAMILY, row, digit), \
+							 columnHeader(size, COL_FAMILY, col, digit), \
+							 columnHeader(size, BOX_FAMILY, box, digit)};
+	int choice = (row * size + col) * size + digit - 1;
+	int first = -1;
+	int family;
+	for (family = 0; family < FAMILIES; family++)
+	{
+		int node = addToColumn(matrix, headers[family], choice);
+		if (first == -1)
+		{
+			first = node;
+			matrix->nodes[node].left = node;
+			matrix->nodes[node].right = node;
+		}
+		else
+		{
+			// insert the node at the end of the circular row, before the first node
+			matrix->nodes[node].right = first;
+			matrix->nodes[node].left = matrix->nodes[first].left;
+			matrix->nodes[matrix->nodes[first].left].right = node;
+			matrix->nodes[first].left = node;
+		}
+	}
+}
+
+/**
+ * This function removes a column from the header list and every row that has a node in it from
+ * the other columns.
+ * input :
+ * 		DlxMatrix* matrix - the matrix
+ * 		int header - the index of the column's header
+ * output :
+ * 		void
+ **/
+static void cover(DlxMatrix* matrix, int header)
+{
+	DlxNode* nodes = matrix->nodes;
+	nodes[nodes[header].right].left = nodes[header].left;
+	nodes[nodes[header].left].right = nodes[header].right;
+	int row, node;
+	for (row = nodes[header].down; row != header; row = nodes[row].down)
+	{
+		for (node = nodes[row].right; node != row; node = nodes[node].right)
+		{
+			nodes[nodes[node].down].up = nodes[node].up;
+			nodes[nodes[node].up].down = nodes[node].down;
+			matrix->columnSizes[nodes[node].column]--;
+		}
+	}
+}
+
+/**
+ * This function undoes cover, relinking in the exact reverse order.
+ * input :
+ * 		DlxMatrix* matrix - the matrix
+ * 		int header - the index of the column's header
+ * output :
+ * 		void
+ **/
+static void uncover(DlxMatrix* matrix, int header)
+{
+	DlxNode* nodes = matrix->nodes;
+	int row, node;
+	for (row = nodes[header].up; row != header; row = nodes[row].up)
+	{
+		for (node = nodes[row].left; node != row; node = nodes[node].left)
+		{
+			matrix->columnSizes[nodes[node].column]++;
+			nodes[nodes[node].down].up = node;
+			nodes[nodes[node].up].down = node;
+		}
+	}
+	nodes[nodes[header].right].left = header;
+	nodes[nodes[header].left].right = header;
+}
+
+/**
+ * This function is Algorithm X: it covers the column with the fewest rows and tries each of its
+ * rows in turn, recursing on the smaller matrix.
+ * input :
+ * 		DlxMatrix* matrix - the matrix
+ * output :
+ * 		1 if every column is covered - the solution holds the choices - else 0.
+ **/
+static int search(DlxMatrix* matrix)
+{
+	DlxNode* nodes = matrix->nodes;
+	if (nodes[ROOT].right == ROOT)
+	{
+		return TRUE;
+	}
+	matrix->context->nodesExpanded++;
+	// the column with the fewest rows. a column with no rows can't be covered
+	int header, column = nodes[ROOT].right;
+	for (header = nodes[column].right; header != ROOT; header = nodes[header].right)
+	{
+		if (matrix->columnSizes[header] < matrix->columnSizes[column])
+		{
+			column = header;
+		}
+	}
+	if (matrix->columnSizes[column] == 0)
+	{
+		return FALSE;
+	}
+	cover(matrix, column);
+	int row, node;
+	for (row = nodes[column].down; row != column; row = nodes[row].down)
+	{
+		matrix->solution[matrix->solutionLength] = nodes[row].choice;
+		matrix->solutionLength++;
+		for (node = nodes[row].right; node != row; node = nodes[node].right)
+		{
+			cover(matrix, nodes[node].column);
+		}
+		if (search(matrix))
+		{
+			return TRUE;
+		}
+		for (node = nodes[row].left; node != row; node = nodes[node].left)
+		{
+			uncover(matrix, nodes[node].column);
+		}
+		matrix->solutionLength--;
+	}
+	uncover(matrix, column);
+	return FALSE;
+}
+
+/**
+ * This function solves a suduku board as an exact cover problem, using Knuth's Algorithm X on a
+ * Dancing Links matrix. every (row, col, digit) choice is a row of the matrix, and the columns
+ * are the four constraint families: every slot has one digit, and every digit appears once in
+ * every row, col and little board. the whole matrix lives in one arena allocated up front.
+ * every search node the algorithm expands is counted in the context's nodesExpanded.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct with its used digits sets built. it's filled
+ * 		with the solution if there is one, else left as it was
+ * output :
+ * 		1 if the board was solved, 0 if it has no solution, SUDUKU_DLX_FAILED if memory
+ * 		allocation failed.
+ **/
+int solveSudukuDlx(SudukuBoardStruct* suduku)
+{
+	int size = suduku->size;
+	int numOfColumns = FAMILIES * size * size;
+	int row, col, digit;
+	// only the digits that are legal in the empty slots become rows, so the givens and their
+	// columns never get into the matrix
+	int numOfChoices = 0;
+	SudukuMask candidates[SUDUKU_MAX_MASK_WORDS];
+	for (row = 0; row < size; row++)
+	{
+		for (col = 0; col < size; col++)
+		{
+			if (SUDUKU_SLOT(suduku, row, col) == EMPTY_SLOT)
+			{
+				numOfChoices += getSudukuCandidates(suduku, row, col, candidates);
+			}
+		}
+	}
+	// the arena: root and headers, FAMILIES nodes per choice, then the column sizes and the
+	// solution
+	int maxNodes = ROOT + 1 + numOfColumns + FAMILIES * numOfChoices;
+	char* arena = (char*)malloc(maxNodes * sizeof(DlxNode) + \
+								(ROOT + 1 + numOfColumns) * sizeof(int) + \
+								size * size * sizeof(int));
+	if (arena == NULL)
+	{
+		return SUDUKU_DLX_FAILED;
+	}
+	DlxMatrix matrix;
+	matrix.nodes = (DlxNode*)arena;
+	matrix.columnSizes = (int*)(arena + maxNodes * sizeof(DlxNode));
+	matrix.solution = matrix.columnSizes + ROOT + 1 + numOfColumns;
+	matrix.solutionLength = 0;
+	matrix.numOfNodes = ROOT + 1 + numOfColumns;
+	matrix.size = size;
+	matrix.boxSize = suduku->boxSize;
+	matrix.context = suduku->context;
+	// every header starts as an empty column. only the columns the givens don't already satisfy
+	// are linked in the header list
+	SudukuMask* usedSets[FAMILIES] = {NULL, suduku->rowUsed, suduku->colUsed, suduku->boxUsed};
+	int header, last = ROOT;
+	int family, index;
+	matrix.nodes[ROOT].column = ROOT;
+	matrix.columnSizes[ROOT] = 0;
+	for (family = 0; family < FAMILIES; family++)
+	{
+		// the columns of a family are its slots, or its (unit, digit) pairs unit after unit
+		for (index = 0; index < size * size; index++)
+		{
+			int satisfied;
+			if (family == SLOT_FAMILY)
+			{
+				satisfied = (suduku->board[index] != EMPTY_SLOT);
+				header = columnHeader(size, family, index, EMPTY_SLOT);
+			}
+			else
+			{
+				int unit = index / size;
+				digit = index % size + 1;
+				SudukuMask word = usedSets[family][unit * suduku->maskWords + \
+												   (digit - 1) / SUDUKU_MASK_BITS];
+				satisfied = (word >> ((digit - 1) % SUDUKU_MASK_BITS)) & 1;
+				header = columnHeader(size, family, unit, digit);
+			}
+			matrix.nodes[header].column = header;
+			matrix.nodes[header].up = header;
+			matrix.nodes[header].down = header;
+			matrix.columnSizes[header] = 0;
+			if (satisfied)
+			{
+				matrix.nodes[header].left = header;
+				matrix.nodes[header].right = header;
+				continue;
+			}
+			matrix.nodes[header].left = last;
+			matrix.nodes[last].right = header;
+			last = header;
+		}
+	}
+	matrix.nodes[last].right = ROOT;
+	matrix.nodes[ROOT].left = last;
+	// a row for every legal digit of every empty slot
+	for (row = 0; row < size; row++)
+	{
+		for (col = 0; col < size; col++)
+		{
+			if (SUDUKU_SLOT(suduku, row, col) != EMPTY_SLOT)
+			{
+				continue;
+			}
+			for (digit = 1; digit <= size; digit++)
+			{
+				if (isValid(suduku, digit, row, col))
+				{
+					addChoice(&matrix, row, col, digit);
+				}
+			}
+		}
+	}
+	int solved = search(&matrix);
+	if (solved)
+	{
+		int i;
+		for (i = 0; i < matrix.solutionLength; i++)
+		{
+			int slot = matrix.solution[i] / size;
+			setSudukuSlot(suduku, slot / size, slot % size, matrix.solution[i] % size + 1);
+		}
+	}
+	free(arena);
+	return solved;
+}
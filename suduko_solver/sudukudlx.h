@@ -0,0 +1,34 @@
+/**
+ ===================================================================================================
+ Name        : sudukudlx.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukudlx.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukudlx_H
+#define sudukudlx_H
+
+#include "sudukutree.h"
+
+//********      consts
+// the board could not be solved, since memory allocation failed
+#define SUDUKU_DLX_FAILED -1
+
+//********      functions
+/**
+ * This function solves a suduku board as an exact cover problem, using Knuth's Algorithm X on a
+ * Dancing Links matrix. every (row, col, digit) choice is a row of the matrix, and the columns
+ * are the four constraint families: every slot has one digit, and every digit appears once in
+ * every row, col and little board. the whole matrix lives in one arena allocated up front.
+ * every search node the algorithm expands is counted in the context's nodesExpanded.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct with its used digits sets built. it's filled
+ * 		with the solution if there is one, else left as it was
+ * output :
+ * 		1 if the board was solved, 0 if it has no solution, SUDUKU_DLX_FAILED if memory
+ * 		allocation failed.
+ **/
+int solveSudukuDlx(SudukuBoardStruct* suduku);
+
+#endif // sudukudlx_H
@@ -0,0 +1,162 @@
+/**
+ ===================================================================================================
+ Name        : sudukufixed.c
+ Author      : Yinnon Bratspiess
+ Description : This file holds the move functions of the in place search specialized for the
+ * 			   board sizes 4, 9, 16 and 25. the solver of every size is sudukufixedkernel.h
+ * 			   compiled with the size as a constant, over the tables sudukufixedgen writes.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include "genericdfs.h"
+#include "sudukutree.h"
+#include "sudukufixed.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define NO_CHILDREN 0
+#define ILLEGAL_VALUE -1
+#define EMPTY_SLOT 0
+#define NO_EMPTY_SLOT -1
+#define UNIT_TYPES 3
+
+// -------------------------- macros ------------------------------------
+// a move is packed like the moves of sudukutree.c: the slot (row * size + col) and the num
+#define MOVE_NUM_BITS 8
+#define MAKE_MOVE(slot, num) (((slot) << MOVE_NUM_BITS) | (num))
+#define MOVE_SLOT(move) ((move) >> MOVE_NUM_BITS)
+#define MOVE_NUM(move) ((move) & ((1 << MOVE_NUM_BITS) - 1))
+
+// ------------------------------ functions -----------------------------
+#ifndef SUDUKU_GENERIC_ONLY
+#include "sudukufixedtables.h"
+
+#define FIXED_SIZE 4
+#define FIXED_BOX_SIZE 2
+#include "sudukufixedkernel.h"
+#undef FIXED_SIZE
+#undef FIXED_BOX_SIZE
+
+#define FIXED_SIZE 9
+#define FIXED_BOX_SIZE 3
+#include "sudukufixedkernel.h"
+#undef FIXED_SIZE
+#undef FIXED_BOX_SIZE
+
+#define FIXED_SIZE 16
+#define FIXED_BOX_SIZE 4
+#include "sudukufixedkernel.h"
+#undef FIXED_SIZE
+#undef FIXED_BOX_SIZE
+
+#define FIXED_SIZE 25
+#define FIXED_BOX_SIZE 5
+#include "sudukufixedkernel.h"
+#undef FIXED_SIZE
+#undef FIXED_BOX_SIZE
+#endif
+
+/**
+ * This function picks the move functions of the in place search for the boards of a context: the
+ * solver specialized for the context's size, if there is one (sizes 4, 9, 16 and 25), else the
+ * generic getSudukuMovesFunc and applySudukuMoveFunc. a specialized solver makes the same moves
+ * and fills the same forced slots as the generic one, with the size, the little boards of the
+ * slots and the peers of every slot known at compile time. it only branches by
+ * SUDUKU_BRANCH_FEWEST_CANDIDATES or SUDUKU_BRANCH_FIRST_EMPTY without a tie break, so a context
+ * with a tie break gets the generic functions. undoSudukuMoveFunc, getSudukuValFunc and
+ * getSudukuHashFunc work with both. building with SUDUKU_GENERIC_ONLY defined always picks the
+ * generic functions.
+ * input :
+ * 		SudukuContext* context - the context of the boards
+ * 		getNodeMovesFunc* getMoves - a pointer to put the moves function in
+ * 		applyMoveFunc* applyMove - a pointer to put the apply function in
+ * output :
+ * 		1 if the specialized functions were picked, 0 if the generic ones were.
+ **/
+int getSudukuFixedMoveFuncs(SudukuContext* context, getNodeMovesFunc* getMoves, \
+							applyMoveFunc* applyMove)
+{
+	*getMoves = getSudukuMovesFunc;
+	*applyMove = applySudukuMoveFunc;
+#ifndef SUDUKU_GENERIC_ONLY
+	if (context->tieBreak != NULL)
+	{
+		return FALSE;
+	}
+	switch (context->size)
+	{
+		case 4:
+			*getMoves = getMoves4;
+			*applyMove = applyMove4;
+			return TRUE;
+		case 9:
+			*getMoves = getMoves9;
+			*applyMove = applyMove9;
+			return TRUE;
+		case 16:
+			*getMoves = getMoves16;
+			*applyMove = applyMove16;
+			return TRUE;
+		case 25:
+			*getMoves = getMoves25;
+			*applyMove = applyMove25;
+			return TRUE;
+		default:
+			return FALSE;
+	}
+#else
+	(void)context;
+	return FALSE;
+#endif
+}
+
+/**
+ * This function is getSudukuFixedMoveFuncs for getBestInWorkspace: it picks the moves function
+ * that puts the moves in a given array, fillSudukuMovesFunc or the one of the specialized solver.
+ * input :
+ * 		SudukuContext* context - the context of the boards
+ * 		fillNodeMovesFunc* fillMoves - a pointer to put the moves function in
+ * 		applyMoveFunc* applyMove - a pointer to put the apply function in
+ * output :
+ * 		1 if the specialized functions were picked, 0 if the generic ones were.
+ **/
+int getSudukuFixedFillFuncs(SudukuContext* context, fillNodeMovesFunc* fillMoves, \
+							applyMoveFunc* applyMove)
+{
+	*fillMoves = fillSudukuMovesFunc;
+	*applyMove = applySudukuMoveFunc;
+#ifndef SUDUKU_GENERIC_ONLY
+	if (context->tieBreak != NULL)
+	{
+		return FALSE;
+	}
+	switch (context->size)
+	{
+		case 4:
+			*fillMoves = fillMoves4;
+			*applyMove = applyMove4;
+			return TRUE;
+		case 9:
+			*fillMoves = fillMoves9;
+			*applyMove = applyMove9;
+			return TRUE;
+		case 16:
+			*fillMoves = fillMoves16;
+			*applyMove = applyMove16;
+			return TRUE;
+		case 25:
+			*fillMoves = fillMoves25;
+			*applyMove = applyMove25;
+			return TRUE;
+		default:
+			return FALSE;
+	}
+#else
+	(void)context;
+	return FALSE;
+#endif
+}
@@ -0,0 +1,49 @@
+/**
+ ===================================================================================================
+ Name        : sudukufixed.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukufixed.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukufixed_H
+#define sudukufixed_H
+
+#include "genericdfs.h"
+#include "sudukutree.h"
+
+//********      functions
+/**
+ * This function picks the move functions of the in place search for the boards of a context: the
+ * solver specialized for the context's size, if there is one (sizes 4, 9, 16 and 25), else the
+ * generic getSudukuMovesFunc and applySudukuMoveFunc. a specialized solver makes the same moves
+ * and fills the same forced slots as the generic one, with the size, the little boards of the
+ * slots and the peers of every slot known at compile time. it only branches by
+ * SUDUKU_BRANCH_FEWEST_CANDIDATES or SUDUKU_BRANCH_FIRST_EMPTY without a tie break, so a context
+ * with a tie break gets the generic functions. undoSudukuMoveFunc, getSudukuValFunc and
+ * getSudukuHashFunc work with both. building with SUDUKU_GENERIC_ONLY defined always picks the
+ * generic functions.
+ * input :
+ * 		SudukuContext* context - the context of the boards
+ * 		getNodeMovesFunc* getMoves - a pointer to put the moves function in
+ * 		applyMoveFunc* applyMove - a pointer to put the apply function in
+ * output :
+ * 		1 if the specialized functions were picked, 0 if the generic ones were.
+ **/
+int getSudukuFixedMoveFuncs(SudukuContext* context, getNodeMovesFunc* getMoves, \
+							applyMoveFunc* applyMove);
+
+/**
+ * This function is getSudukuFixedMoveFuncs for getBestInWorkspace: it picks the moves function
+ * that puts the moves in a given array, fillSudukuMovesFunc or the one of the specialized solver.
+ * input :
+ * 		SudukuContext* context - the context of the boards
+ * 		fillNodeMovesFunc* fillMoves - a pointer to put the moves function in
+ * 		applyMoveFunc* applyMove - a pointer to put the apply function in
+ * output :
+ * 		1 if the specialized functions were picked, 0 if the generic ones were.
+ **/
+int getSudukuFixedFillFuncs(SudukuContext* context, fillNodeMovesFunc* fillMoves, \
+							applyMoveFunc* applyMove);
+
+#endif // sudukufixed_H
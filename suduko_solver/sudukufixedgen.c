@@ -0,0 +1,163 @@
+/**
+ ===================================================================================================
+ Name        : sudukufixedgen.c
+ Author      : Yinnon Bratspiess
+ Description : This program writes sudukufixedtables.h, the constant tables of the size
+ * 			   specialized solvers of sudukufixed.c: for every fixed size the little board of
+ * 			   every slot, the peers of every slot (the other slots of its row, col and little
+ * 			   board) and the slots of every row, col and little board. the makefile runs it
+ * 			   before building the solver.
+ * 			   usage: sudukufixedgen > sudukufixedtables.h
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+
+// -------------------------- const definitions -------------------------
+#define NUM_OF_SIZES 4
+// the most slots a table row is printed with in one line
+#define VALUES_PER_LINE 16
+// the most values of a table row - the peers of a slot of a 25x25 board
+#define MAX_ROW_VALUES 64
+
+// ------------------------------ globals -------------------------------
+// the sizes that get a specialized solver, and the sizes of their little boards
+static const int fixedSizes[NUM_OF_SIZES] = {4, 9, 16, 25};
+static const int fixedBoxSizes[NUM_OF_SIZES] = {2, 3, 4, 5};
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function prints a row of a table, as the values of a C initializer.
+ * input :
+ * 		int* values - the values
+ * 		int numOfValues - the number of values
+ * 		int braces - 1 to put the row in braces, as a row of a two dimensional table, else 0
+ * output :
+ * 		void
+ **/
+static void printRow(int* values, int numOfValues, int braces)
+{
+	int k;
+	printf(braces ? "\t{" : "\t");
+	for (k = 0; k < numOfValues; k++)
+	{
+		if (k > 0 && k % VALUES_PER_LINE == 0)
+		{
+			printf("\n\t ");
+		}
+		printf("%d%s", values[k], (k == numOfValues - 1) ? "" : ", ");
+	}
+	printf(braces ? "},\n" : ",\n");
+}
+
+/**
+ * This function prints the tables of one size.
+ * input :
+ * 		int size - the size of the board
+ * 		int boxSize - the size of its little boards
+ * output :
+ * 		void
+ **/
+static void printTables(int size, int boxSize)
+{
+	int numOfSlots = size * size;
+	int numOfPeers = 2 * (size - 1) + (boxSize - 1) * (boxSize - 1);
+	int values[MAX_ROW_VALUES];
+	int slot, k;
+
+	printf("// the little board of every slot of a %dx%d board\n", size, size);
+	printf("static const uint8_t sudukuBoxOf%d[%d] =\n{\n", size, numOfSlots);
+	for (slot = 0; slot < numOfSlots; slot++)
+	{
+		int row = slot / size;
+		int col = slot % size;
+		values[slot % size] = row / boxSize * boxSize + col / boxSize;
+		if (slot % size == size - 1)
+		{
+			printRow(values, size, 0);
+		}
+	}
+	printf("};\n\n");
+
+	printf("// the peers of every slot of a %dx%d board: its row, then its col, then the rest of "
+		   "its\n// little board\n", size, size);
+	printf("static const uint16_t sudukuPeers%d[%d][%d] =\n{\n", size, numOfSlots, numOfPeers);
+	for (slot = 0; slot < numOfSlots; slot++)
+	{
+		int row = slot / size;
+		int col = slot % size;
+		int startRow = row / boxSize * boxSize;
+		int startCol = col / boxSize * boxSize;
+		int numOfValues = 0;
+		for (k = 0; k < size; k++)
+		{
+			if (k != col)
+			{
+				values[numOfValues++] = row * size + k;
+			}
+		}
+		for (k = 0; k < size; k++)
+		{
+			if (k != row)
+			{
+				values[numOfValues++] = k * size + col;
+			}
+		}
+		for (k = 0; k < size; k++)
+		{
+			int peerRow = startRow + k / boxSize;
+			int peerCol = startCol + k % boxSize;
+			if (peerRow != row && peerCol != col)
+			{
+				values[numOfValues++] = peerRow * size + peerCol;
+			}
+		}
+		printRow(values, numOfValues, 1);
+	}
+	printf("};\n\n");
+
+	printf("// the slots of every unit of a %dx%d board: the rows, then the cols, then the little "
+		   "boards\n", size, size);
+	printf("static const uint16_t sudukuUnits%d[%d][%d] =\n{\n", size, 3 * size, size);
+	for (k = 0; k < 3 * size; k++)
+	{
+		int unit = k % size;
+		int i;
+		for (i = 0; i < size; i++)
+		{
+			if (k < size)
+			{
+				values[i] = unit * size + i;
+			}
+			else if (k < 2 * size)
+			{
+				values[i] = i * size + unit;
+			}
+			else
+			{
+				values[i] = (unit / boxSize * boxSize + i / boxSize) * size + \
+							unit % boxSize * boxSize + i % boxSize;
+			}
+		}
+		printRow(values, size, 1);
+	}
+	printf("};\n\n");
+}
+
+/**
+ * prints the header with the tables of every fixed size.
+ **/
+int main(void)
+{
+	int i;
+	printf("/**\n * this file is generated by sudukufixedgen. don't change it, change the "
+		   "generator.\n **/\n\n");
+	printf("#ifndef sudukufixedtables_H\n#define sudukufixedtables_H\n\n#include <stdint.h>\n\n");
+	for (i = 0; i < NUM_OF_SIZES; i++)
+	{
+		printTables(fixedSizes[i], fixedBoxSizes[i]);
+	}
+	printf("#endif // sudukufixedtables_H\n");
+	return 0;
+}
@@ -0,0 +1,281 @@
+/**
+ ===================================================================================================
+ Name        : sudukufixedkernel.h
+ Author      : Yinnon Bratspiess
+ Description : The solver of sudukufixed.c for one board size. it's included by sudukufixed.c
+ * 			   once per size, with FIXED_SIZE and FIXED_BOX_SIZE defined, so every loop bound,
+ * 			   every table and every division by the size is a compile time constant. a board
+ * 			   of up to 25 digits has one SudukuMask word per used digits set, so the sets are
+ * 			   indexed by their row, col or little board alone.
+ ===================================================================================================
+ **/
+
+// the names of the functions and tables of the size
+#define FIXED_CONCAT(name, size) name##size
+#define FIXED_NAME(name, size) FIXED_CONCAT(name, size)
+#define FIXED(name) FIXED_NAME(name, FIXED_SIZE)
+#define FIXED_BOX_OF FIXED(sudukuBoxOf)
+#define FIXED_PEERS FIXED(sudukuPeers)
+#define FIXED_UNITS FIXED(sudukuUnits)
+#define FIXED_SLOTS (FIXED_SIZE * FIXED_SIZE)
+#define FIXED_NUM_OF_PEERS (2 * (FIXED_SIZE - 1) + (FIXED_BOX_SIZE - 1) * (FIXED_BOX_SIZE - 1))
+#define FIXED_ALL_DIGITS (((SudukuMask)1 << FIXED_SIZE) - 1)
+// the digits that can be legally put in a slot of a board
+#define FIXED_CANDIDATES(suduku, slot) \
+	(~((suduku)->rowUsed[(slot) / FIXED_SIZE] | (suduku)->colUsed[(slot) % FIXED_SIZE] | \
+	   (suduku)->boxUsed[FIXED_BOX_OF[slot]]) & FIXED_ALL_DIGITS)
+
+/**
+ * this function puts a num in an empty slot and records the slot on the context's trail.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int slot - the slot (row * size + col)
+ * 		int num - the num
+ * output :
+ * 		void
+ **/
+static inline void FIXED(fillSlot)(SudukuBoardStruct* suduku, int slot, int num)
+{
+	SudukuContext* context = suduku->context;
+	setSudukuSlot(suduku, slot / FIXED_SIZE, slot % FIXED_SIZE, num);
+	context->trail[context->trailLength] = slot;
+	context->trailLength++;
+}
+
+/**
+ * this function fills the slots a filled slot forced: every empty peer of a filled slot lost the
+ * slot's digit, so a peer with one legal digit left is filled, and its own peers are checked in
+ * turn.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int slot - the filled slot
+ * output :
+ * 		0 if a peer was left with no legal digit, else 1.
+ **/
+static int FIXED(fillPeers)(SudukuBoardStruct* suduku, int slot)
+{
+	// every slot is pushed once, when it's filled
+	int queue[FIXED_SLOTS];
+	int head = 0, tail = 0;
+	int k;
+	queue[tail++] = slot;
+	while (head < tail)
+	{
+		const uint16_t* peers = FIXED_PEERS[queue[head++]];
+		for (k = 0; k < FIXED_NUM_OF_PEERS; k++)
+		{
+			int peer = peers[k];
+			if (suduku->board[peer] != EMPTY_SLOT)
+			{
+				continue;
+			}
+			SudukuMask candidates = FIXED_CANDIDATES(suduku, peer);
+			if (candidates == 0)
+			{
+				return FALSE;
+			}
+			if ((candidates & (candidates - 1)) == 0)
+			{
+				FIXED(fillSlot)(suduku, peer, __builtin_ctzll(candidates) + 1);
+				queue[tail++] = peer;
+			}
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * this function fills the forced slots of a board until there are none left, like
+ * propagateSuduku: empty slots with only one legal digit (naked singles), and digits that have
+ * only one slot left in a row, col or little board (hidden singles). the filled slots are
+ * recorded on the context's trail.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * output :
+ * 		0 if it found the board can't be solved, else 1.
+ **/
+static int FIXED(propagate)(SudukuBoardStruct* suduku)
+{
+	SudukuMask* usedSets[UNIT_TYPES] = {suduku->rowUsed, suduku->colUsed, suduku->boxUsed};
+	int changed = TRUE;
+	int slot, unit, k;
+	// every round fills at least one slot, or it's the last round
+	while (changed)
+	{
+		changed = FALSE;
+		// naked singles, and the naked singles they force among their peers
+		for (slot = 0; slot < FIXED_SLOTS; slot++)
+		{
+			if (suduku->board[slot] != EMPTY_SLOT)
+			{
+				continue;
+			}
+			SudukuMask candidates = FIXED_CANDIDATES(suduku, slot);
+			if (candidates == 0)
+			{
+				return FALSE;
+			}
+			if ((candidates & (candidates - 1)) == 0)
+			{
+				FIXED(fillSlot)(suduku, slot, __builtin_ctzll(candidates) + 1);
+				if (!FIXED(fillPeers)(suduku, slot))
+				{
+					return FALSE;
+				}
+				changed = TRUE;
+			}
+		}
+		// hidden singles. for every row, col and little board the digits that are legal in at
+		// least one of its empty slots and in at least two of them
+		for (unit = 0; unit < UNIT_TYPES * FIXED_SIZE; unit++)
+		{
+			const uint16_t* slots = FIXED_UNITS[unit];
+			SudukuMask seenOnce = 0, seenTwice = 0;
+			for (k = 0; k < FIXED_SIZE; k++)
+			{
+				if (suduku->board[slots[k]] == EMPTY_SLOT)
+				{
+					SudukuMask candidates = FIXED_CANDIDATES(suduku, slots[k]);
+					seenTwice |= seenOnce & candidates;
+					seenOnce |= candidates;
+				}
+			}
+			// the digits still missing in the unit must each have a slot
+			SudukuMask missing = ~usedSets[unit / FIXED_SIZE][unit % FIXED_SIZE] & \
+								 FIXED_ALL_DIGITS;
+			if ((missing & ~seenOnce) != 0)
+			{
+				return FALSE;
+			}
+			SudukuMask singles = seenOnce & ~seenTwice;
+			while (singles != 0)
+			{
+				SudukuMask digit = singles & -singles;
+				singles &= singles - 1;
+				// the only slot of the digit may have been filled by an earlier single of this
+				// unit, and then the digit has no slot left
+				int placed = FALSE;
+				for (k = 0; k < FIXED_SIZE && !placed; k++)
+				{
+					if (suduku->board[slots[k]] == EMPTY_SLOT && \
+						(FIXED_CANDIDATES(suduku, slots[k]) & digit) != 0)
+					{
+						FIXED(fillSlot)(suduku, slots[k], __builtin_ctzll(digit) + 1);
+						placed = TRUE;
+					}
+				}
+				if (!placed)
+				{
+					return FALSE;
+				}
+				changed = TRUE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * this is fillSudukuMovesFunc for the size: the moves that put each legal digit in the slot
+ * picked by the branch policy.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int* moves - an array of FIXED_SIZE moves
+ * output :
+ * 		the number of moves.
+ **/
+static int FIXED(fillMoves)(void* sudukuStruct, int* moves)
+{
+	SudukuBoardStruct* suduku = (SudukuBoardStruct*) sudukuStruct;
+	suduku->context->nodesExpanded++;
+	if (suduku->deadEnd)
+	{
+		return NO_CHILDREN;
+	}
+	int firstEmpty = (suduku->context->branchPolicy == SUDUKU_BRANCH_FIRST_EMPTY);
+	int bestSlot = NO_EMPTY_SLOT;
+	int bestCount = FIXED_SIZE + 1;
+	SudukuMask bestCandidates = 0;
+	int slot;
+	for (slot = 0; slot < FIXED_SLOTS; slot++)
+	{
+		if (suduku->board[slot] != EMPTY_SLOT)
+		{
+			continue;
+		}
+		SudukuMask candidates = FIXED_CANDIDATES(suduku, slot);
+		int count = __builtin_popcountll(candidates);
+		if (count < bestCount)
+		{
+			bestSlot = slot;
+			bestCount = count;
+			bestCandidates = candidates;
+		}
+		// a slot with no legal digit is a dead end, and no slot has less than one otherwise
+		if (firstEmpty || bestCount <= 1)
+		{
+			break;
+		}
+	}
+	int currentMove = 0;
+	if (bestSlot == NO_EMPTY_SLOT)
+	{
+		return NO_CHILDREN;
+	}
+	while (bestCandidates != 0)
+	{
+		moves[currentMove] = MAKE_MOVE(bestSlot, __builtin_ctzll(bestCandidates) + 1);
+		bestCandidates &= bestCandidates - 1;
+		currentMove++;
+	}
+	return currentMove;
+}
+
+/**
+ * this is getSudukuMovesFunc for the size, which allocates the moves and fills them with
+ * FIXED(fillMoves).
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int** movesList - a pointer to an array of moves
+ * output :
+ * 		the number of moves. -1 indicates illeagal value
+ **/
+static int FIXED(getMoves)(void* sudukuStruct, int** movesList)
+{
+	int* moves = (int*)malloc(sizeof(int) * FIXED_SIZE);
+	if (moves == NULL)
+	{
+		return ILLEGAL_VALUE;
+	}
+	*movesList = moves;
+	return FIXED(fillMoves)(sudukuStruct, moves);
+}
+
+/**
+ * this is applySudukuMoveFunc for the size.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int move - the move
+ * output :
+ * 		void
+ **/
+static void FIXED(applyMove)(void* sudukuStruct, int move)
+{
+	SudukuBoardStruct* suduku = (SudukuBoardStruct*) sudukuStruct;
+	SudukuContext* context = suduku->context;
+	context->trailMarks[context->trailDepth] = context->trailLength;
+	context->trailDepth++;
+	FIXED(fillSlot)(suduku, MOVE_SLOT(move), MOVE_NUM(move));
+	if (context->propagate && !FIXED(propagate)(suduku))
+	{
+		suduku->deadEnd = TRUE;
+	}
+}
+
+#undef FIXED_BOX_OF
+#undef FIXED_PEERS
+#undef FIXED_UNITS
+#undef FIXED_SLOTS
+#undef FIXED_NUM_OF_PEERS
+#undef FIXED_ALL_DIGITS
+#undef FIXED_CANDIDATES
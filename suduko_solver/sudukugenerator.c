@@ -0,0 +1,373 @@
+/**
+ ===================================================================================================
+ Name        : sudukugenerator.c
+ Author      : Yinnon Bratspiess
+ Description : This file makes suduku puzzles with a unique solution on a pool of threads, by
+ * 			   removing clues from random full boards while the solution stays unique.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include "genericdfs.h"
+#include "sudukutree.h"
+#include "sudukugenerator.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define EMPTY_SLOT 0
+// a removal is kept if the puzzle has exactly one solution, so the count stops at two
+#define UNIQUE 1
+#define COUNT_LIMIT 2
+// the tries to complete a diagonal filled at random
+#define FULL_BOARD_ATTEMPTS 8
+#define NANOS_IN_SECOND 1e9
+// not an int number indicator of sqrtCheck
+#define NOT_AN_INT -1
+
+// -------------------------- structs -----------------------------------
+/**
+ * the state shared by the threads of one run: the puzzles, made into one array of
+ * numOfPuzzles * size * size slots, the next puzzle to make and the totals of the run.
+ **/
+typedef struct Generator
+{
+	SudukuGeneratorOptions* options;
+	SudukuCell* puzzles;
+	atomic_int nextPuzzle;
+	atomic_int failed;
+	atomic_long totalClues;
+}Generator;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function returns the next number of a random stream (splitmix64).
+ * input :
+ * 		uint64_t* state - the state of the stream
+ * output :
+ * 		the number
+ **/
+static uint64_t nextRandom(uint64_t* state)
+{
+	uint64_t value = (*state += 0x9e3779b97f4a7c15ULL);
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+/**
+ * This function puts the numbers of an array in a random order (Fisher Yates).
+ * input :
+ * 		int* values - the array
+ * 		int numOfValues - the number of numbers in it
+ * 		uint64_t* random - the state of the random stream
+ * output :
+ * 		void
+ **/
+static void shuffle(int* values, int numOfValues, uint64_t* random)
+{
+	int i;
+	for (i = numOfValues - 1; i > 0; i--)
+	{
+		int j = (int)(nextRandom(random) % (uint64_t)(i + 1));
+		int temp = values[i];
+		values[i] = values[j];
+		values[j] = temp;
+	}
+}
+
+/**
+ * This function tries to make a random full board: it fills the first numOfBoxes little boards on
+ * the diagonal, which share no row or col, each with the digits in a random order, solves the
+ * rest of the board, and renames the digits in a random order.
+ * input :
+ * 		SudukuContext* context - the context of the size of the board
+ * 		int numOfBoxes - the number of little boards on the diagonal to fill at random
+ * 		SudukuCell* cells - size * size slots to put the board in
+ * 		int* order - scratch of size * size ints
+ * 		uint64_t* random - the state of the random stream
+ * output :
+ * 		1 if the board was made, 0 if the filled little boards can't be completed or memory
+ * 		allocation failed.
+ **/
+static int tryFullBoard(SudukuContext* context, int numOfBoxes, SudukuCell* cells, int* order, \
+						uint64_t* random)
+{
+	SudukuBoardStruct* suduku = createSudukuBoard(context);
+	if (suduku == NULL)
+	{
+		return FALSE;
+	}
+	int size = context->size;
+	int boxSize = context->boxSize;
+	int box, k;
+	initSudukuMasks(suduku);
+	for (box = 0; box < numOfBoxes; box++)
+	{
+		for (k = 0; k < size; k++)
+		{
+			order[k] = k + 1;
+		}
+		shuffle(order, size, random);
+		for (k = 0; k < size; k++)
+		{
+			setSudukuSlot(suduku, box * boxSize + k / boxSize, box * boxSize + k % boxSize, \
+						  order[k]);
+		}
+	}
+	int solved = getBestInPlace(suduku, getSudukuMovesFunc, applySudukuMoveFunc, \
+								undoSudukuMoveFunc, getSudukuValFunc, size * size) != NULL;
+	if (solved)
+	{
+		for (k = 0; k < size; k++)
+		{
+			order[k] = k + 1;
+		}
+		shuffle(order, size, random);
+		for (k = 0; k < size * size; k++)
+		{
+			cells[k] = (SudukuCell)order[suduku->board[k] - 1];
+		}
+	}
+	freeSudukuFunc(suduku);
+	return solved;
+}
+
+/**
+ * This function makes a random full board. the whole diagonal filled at random can't always be
+ * completed (it often can't on a 4x4 board), so after FULL_BOARD_ATTEMPTS tries only the first
+ * little board is filled at random, which can always be completed.
+ * input :
+ * 		SudukuContext* context - the context of the size of the board
+ * 		SudukuCell* cells - size * size slots to put the board in
+ * 		int* order - scratch of size * size ints
+ * 		uint64_t* random - the state of the random stream
+ * output :
+ * 		1 if the board was made, 0 if memory allocation failed.
+ **/
+static int makeFullBoard(SudukuContext* context, SudukuCell* cells, int* order, uint64_t* random)
+{
+	int attempt;
+	for (attempt = 0; attempt < FULL_BOARD_ATTEMPTS; attempt++)
+	{
+		if (tryFullBoard(context, context->boxSize, cells, order, random))
+		{
+			return TRUE;
+		}
+	}
+	return tryFullBoard(context, 1, cells, order, random);
+}
+
+/**
+ * This function removes the clues of a full board in a random order, keeping every removal after
+ * which the board still has exactly one solution, until it has targetClues clues.
+ * input :
+ * 		SudukuContext* context - the context of the size of the board
+ * 		SudukuCell* cells - the full board, turned into the puzzle
+ * 		int targetClues - the number of clues to stop at
+ * 		int* order - scratch of size * size ints
+ * 		uint64_t* random - the state of the random stream
+ * output :
+ * 		the number of clues of the puzzle, -1 if memory allocation failed.
+ **/
+static int removeClues(SudukuContext* context, SudukuCell* cells, int targetClues, int* order, \
+					   uint64_t* random)
+{
+	// a new board starts with an empty trail, which the uniqueness counts need
+	SudukuBoardStruct* suduku = createSudukuBoard(context);
+	if (suduku == NULL)
+	{
+		return NOT_AN_INT;
+	}
+	int numOfSlots = context->size * context->size;
+	int clues = numOfSlots;
+	int k;
+	memcpy(suduku->board, cells, numOfSlots * sizeof(SudukuCell));
+	initSudukuMasks(suduku);
+	for (k = 0; k < numOfSlots; k++)
+	{
+		order[k] = k;
+	}
+	shuffle(order, numOfSlots, random);
+	for (k = 0; k < numOfSlots && clues > targetClues; k++)
+	{
+		int row = order[k] / context->size;
+		int col = order[k] % context->size;
+		int num = SUDUKU_SLOT(suduku, row, col);
+		setSudukuSlot(suduku, row, col, EMPTY_SLOT);
+		if (countBest(suduku, getSudukuMovesFunc, applySudukuMoveFunc, undoSudukuMoveFunc, \
+					  getSudukuValFunc, numOfSlots, COUNT_LIMIT) == UNIQUE)
+		{
+			clues--;
+		}
+		else
+		{
+			setSudukuSlot(suduku, row, col, num);
+		}
+	}
+	memcpy(cells, suduku->board, numOfSlots * sizeof(SudukuCell));
+	freeSudukuFunc(suduku);
+	return clues;
+}
+
+/**
+ * This function is the loop of a generating thread: it makes the next puzzle that no thread took
+ * until there are none left. every puzzle has its own random stream, picked by the seed and the
+ * puzzle's number, so the puzzles don't depend on the thread that makes them.
+ * input :
+ * 		void* generatorStruct - the generator
+ * output :
+ * 		NULL
+ **/
+static void* generatorLoop(void* generatorStruct)
+{
+	Generator* generator = (Generator*)generatorStruct;
+	SudukuGeneratorOptions* options = generator->options;
+	int numOfSlots = options->size * options->size;
+	SudukuContext* context = createSudukuContext(options->size);
+	int* order = (int*)malloc(numOfSlots * sizeof(int));
+	if (context == NULL || order == NULL)
+	{
+		atomic_store(&generator->failed, TRUE);
+		free(order);
+		freeSudukuContext(context);
+		return NULL;
+	}
+	context->propagate = TRUE;
+	int index;
+	while (!atomic_load(&generator->failed) && \
+		   (index = atomic_fetch_add(&generator->nextPuzzle, 1)) < options->numOfPuzzles)
+	{
+		uint64_t random = options->seed;
+		random = nextRandom(&random) ^ (uint64_t)index;
+		SudukuCell* cells = generator->puzzles + (size_t)index * numOfSlots;
+		int clues = NOT_AN_INT;
+		if (makeFullBoard(context, cells, order, &random))
+		{
+			clues = removeClues(context, cells, options->targetClues, order, &random);
+		}
+		if (clues == NOT_AN_INT)
+		{
+			atomic_store(&generator->failed, TRUE);
+			break;
+		}
+		atomic_fetch_add(&generator->totalClues, clues);
+	}
+	free(order);
+	freeSudukuContext(context);
+	return NULL;
+}
+
+/**
+ * This function writes a puzzle in the format of a single board file.
+ * input :
+ * 		FILE* output - the stream
+ * 		SudukuCell* cells - the puzzle
+ * 		int size - the size of the board
+ * output :
+ * 		void
+ **/
+static void writePuzzle(FILE* output, SudukuCell* cells, int size)
+{
+	int row, col;
+	fprintf(output, "%d\n", size);
+	for (row = 0; row < size; row++)
+	{
+		for (col = 0; col < size; col++)
+		{
+			fprintf(output, (col == size - 1) ? "%d\n" : "%d ", cells[row * size + col]);
+		}
+	}
+}
+
+/**
+ * This function makes puzzles with a unique solution and writes them in the format of a single
+ * board file (the size and then the board), one after the other, so sudukusolver can solve them
+ * with --batch. every puzzle starts as a random full board, and then its clues are removed in a
+ * random order, keeping every removal after which the puzzle still has exactly one solution, until
+ * it has targetClues clues or no clue can be removed. the puzzles are made by a pool of threads,
+ * each with its own random stream for every puzzle, and the number of puzzles made per second and
+ * their average number of clues are printed to stderr at the end.
+ * input :
+ * 		FILE* output - the stream the puzzles are written to
+ * 		SudukuGeneratorOptions* options - the options of the run
+ * output :
+ * 		0 if all the puzzles were made, 1 if the options are not valid or memory allocation or a
+ * 		thread failed.
+ **/
+int generateSudukuPuzzles(FILE* output, SudukuGeneratorOptions* options)
+{
+	if (options->size < SUDUKU_GENERATOR_MIN_SIZE || options->size > SUDUKU_GENERATOR_MAX_SIZE || \
+		sqrtCheck(options->size) == NOT_AN_INT || options->numOfPuzzles <= 0 || \
+		options->targetClues < 0 || options->targetClues > options->size * options->size)
+	{
+		return EXIT_FAILURE;
+	}
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	int numOfThreads = options->numOfThreads;
+	if (numOfThreads <= 0)
+	{
+		numOfThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		numOfThreads = (numOfThreads > 0) ? numOfThreads : 1;
+	}
+	if (numOfThreads > options->numOfPuzzles)
+	{
+		numOfThreads = options->numOfPuzzles;
+	}
+	int numOfSlots = options->size * options->size;
+	Generator generator;
+	generator.options = options;
+	generator.puzzles = (SudukuCell*)malloc((size_t)options->numOfPuzzles * numOfSlots * \
+											sizeof(SudukuCell));
+	pthread_t* threads = (pthread_t*)malloc(numOfThreads * sizeof(pthread_t));
+	if (generator.puzzles == NULL || threads == NULL)
+	{
+		free(generator.puzzles);
+		free(threads);
+		return EXIT_FAILURE;
+	}
+	atomic_init(&generator.nextPuzzle, 0);
+	atomic_init(&generator.failed, FALSE);
+	atomic_init(&generator.totalClues, 0);
+	int started, i;
+	for (started = 0; started < numOfThreads; started++)
+	{
+		if (pthread_create(&threads[started], NULL, generatorLoop, &generator) != 0)
+		{
+			atomic_store(&generator.failed, TRUE);
+			break;
+		}
+	}
+	for (i = 0; i < started; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	free(threads);
+	int failed = atomic_load(&generator.failed);
+	if (!failed)
+	{
+		for (i = 0; i < options->numOfPuzzles; i++)
+		{
+			writePuzzle(output, generator.puzzles + (size_t)i * numOfSlots, options->size);
+		}
+		fflush(output);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / \
+						 NANOS_IN_SECOND;
+		fprintf(stderr, "%d puzzles of %dx%d in %.3f seconds on %d threads (%.1f puzzles/second, " \
+				"%.1f clues on average)\n", options->numOfPuzzles, options->size, options->size, \
+				seconds, numOfThreads, options->numOfPuzzles / seconds, \
+				(double)atomic_load(&generator.totalClues) / options->numOfPuzzles);
+	}
+	free(generator.puzzles);
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+/**
+ ===================================================================================================
+ Name        : sudukugenerator.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukugenerator.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukugenerator_H
+#define sudukugenerator_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+//********      consts
+// the board sizes the generator makes puzzles of
+#define SUDUKU_GENERATOR_MIN_SIZE 4
+#define SUDUKU_GENERATOR_MAX_SIZE 25
+
+//********      structs
+/**
+ * struct for the options of a generator run.
+ * int size - the size of the boards: 4, 9, 16 or 25
+ * int numOfPuzzles - the number of puzzles to make
+ * int targetClues - the number of clues to stop removing at. a puzzle that can't lose more clues
+ * without losing its unique solution before that keeps more clues
+ * int numOfThreads - the number of generating threads. 0 or less uses one per online processor
+ * uint64_t seed - the seed of the random streams. the same seed makes the same puzzles on any
+ * number of threads
+ **/
+typedef struct SudukuGeneratorOptions
+{
+	int size;
+	int numOfPuzzles;
+	int targetClues;
+	int numOfThreads;
+	uint64_t seed;
+}SudukuGeneratorOptions;
+
+//********      functions
+/**
+ * This function makes puzzles with a unique solution and writes them in the format of a single
+ * board file (the size and then the board), one after the other, so sudukusolver can solve them
+ * with --batch. every puzzle starts as a random full board, and then its clues are removed in a
+ * random order, keeping every removal after which the puzzle still has exactly one solution, until
+ * it has targetClues clues or no clue can be removed. the puzzles are made by a pool of threads,
+ * each with its own random stream for every puzzle, and the number of puzzles made per second and
+ * their average number of clues are printed to stderr at the end.
+ * input :
+ * 		FILE* output - the stream the puzzles are written to
+ * 		SudukuGeneratorOptions* options - the options of the run
+ * output :
+ * 		0 if all the puzzles were made, 1 if the options are not valid or memory allocation or a
+ * 		thread failed.
+ **/
+int generateSudukuPuzzles(FILE* output, SudukuGeneratorOptions* options);
+
+#endif // sudukugenerator_H
@@ -0,0 +1,250 @@
+/**
+ ===================================================================================================
+ Name        : sudukulib.c
+ Author      : Yinnon Bratspiess
+ Description : This file is the entry point of the suduku library: a solver object that holds
+ * 			   every buffer the in place search needs for boards up to a maximum size, so a long
+ * 			   running program can solve any number of boards from memory without allocating.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "genericdfs.h"
+#include "sudukutree.h"
+#include "sudukufixed.h"
+#include "sudukuloader.h"
+#include "sudukulib.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+// not an int number indicator of sqrtCheck
+#define NOT_AN_INT -1
+// the biggest little board size, so the biggest board size is its square
+#define MAX_BOX_SIZE 15
+
+// -------------------------- structs -----------------------------------
+/**
+ * the solver: a context for every size up to maxSize, indexed by the size of its little boards,
+ * with the move functions picked for it, the workspace of the search, and maxSize * maxSize
+ * slots to parse the boards given as text into.
+ **/
+struct SudukuSolver
+{
+	int maxSize;
+	SudukuContext* contexts[MAX_BOX_SIZE + 1];
+	fillNodeMovesFunc fillMoves[MAX_BOX_SIZE + 1];
+	applyMoveFunc applyMoves[MAX_BOX_SIZE + 1];
+	DfsWorkspace* workspace;
+	SudukuCell* textCells;
+};
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function creates a solver and allocates every buffer its boards need: the pools and
+ * trails of the contexts of the sizes up to maxSize, a workspace with a frame and maxSize
+ * moves for every slot of the biggest board (about 4 * maxSize^3 bytes), and the slots of the
+ * biggest board for the boards given as text.
+ * input :
+ * 		int maxSize - the biggest size of the boards it solves, a square up to SUDUKU_MAX_SIZE
+ * output :
+ * 		the solver, NULL if maxSize is not a square in range or memory allocation failed.
+ **/
+SudukuSolver* createSudukuSolver(int maxSize)
+{
+	int maxBoxSize = sqrtCheck(maxSize);
+	if (maxSize <= 0 || maxSize > SUDUKU_MAX_SIZE || maxBoxSize == NOT_AN_INT)
+	{
+		return NULL;
+	}
+	SudukuSolver* solver = (SudukuSolver*)calloc(1, sizeof(SudukuSolver));
+	if (solver == NULL)
+	{
+		return NULL;
+	}
+	solver->maxSize = maxSize;
+	// every applied move fills a slot, so the path is never deeper than the slots of the board
+	solver->workspace = createDfsWorkspace(maxSize * maxSize, maxSize);
+	solver->textCells = (SudukuCell*)malloc(maxSize * maxSize * sizeof(SudukuCell));
+	int valid = (solver->workspace != NULL && solver->textCells != NULL);
+	int boxSize;
+	for (boxSize = 1; boxSize <= maxBoxSize && valid; boxSize++)
+	{
+		SudukuContext* context = createSudukuContext(boxSize * boxSize);
+		solver->contexts[boxSize] = context;
+		// taking a board and giving it back carves the first slab of the pool, which is all the
+		// pool needs for one board at a time
+		SudukuBoardStruct* suduku = (context == NULL) ? NULL : createSudukuBoard(context);
+		valid = (suduku != NULL);
+		if (valid)
+		{
+			freeSudukuFunc(suduku);
+			getSudukuFixedFillFuncs(context, &solver->fillMoves[boxSize], \
+									&solver->applyMoves[boxSize]);
+		}
+	}
+	if (!valid)
+	{
+		freeSudukuSolver(solver);
+		return NULL;
+	}
+	return solver;
+}
+
+/**
+ * This function frees a solver and all its buffers from memory.
+ * input :
+ * 		SudukuSolver* solver - the solver
+ * output :
+ * 		void
+ **/
+void freeSudukuSolver(SudukuSolver* solver)
+{
+	if (solver == NULL)
+	{
+		return;
+	}
+	int boxSize;
+	for (boxSize = 1; boxSize <= MAX_BOX_SIZE; boxSize++)
+	{
+		if (solver->contexts[boxSize] != NULL)
+		{
+			freeSudukuContext(solver->contexts[boxSize]);
+		}
+	}
+	freeDfsWorkspace(solver->workspace);
+	free(solver->textCells);
+	free(solver);
+}
+
+/**
+ * This function solves a board given by its slots, with the in place search over the solver's
+ * buffers (the solver specialized for the size if there is one), filling the forced slots of
+ * every node. it makes no allocation.
+ * input :
+ * 		SudukuSolver* solver - the solver
+ * 		int size - the size of the board
+ * 		const SudukuCell* cells - the size * size slots of the board, row after row, 0 for empty
+ * 		SudukuCell* solution - an array of size * size slots to put the solution in. it can be
+ * 							   cells itself
+ * 		DfsBudget* budget - the budget of the search, set by initDfsBudget. NULL for none
+ * output :
+ * 		one of the SUDUKU_SOLVE_ consts. solution is filled only for SUDUKU_SOLVE_OK.
+ **/
+int solveSudukuCells(SudukuSolver* solver, int size, const SudukuCell* cells, \
+					 SudukuCell* solution, DfsBudget* budget)
+{
+	int boxSize = sqrtCheck(size);
+	if (size <= 0 || size > solver->maxSize || boxSize == NOT_AN_INT)
+	{
+		return SUDUKU_SOLVE_NOT_VALID;
+	}
+	int slot;
+	for (slot = 0; slot < size * size; slot++)
+	{
+		if (cells[slot] > size)
+		{
+			return SUDUKU_SOLVE_NOT_VALID;
+		}
+	}
+	// the board comes out of the pool the solver warmed up, and goes back to it at the end
+	SudukuBoardStruct* suduku = createSudukuBoard(solver->contexts[boxSize]);
+	if (suduku == NULL)
+	{
+		return SUDUKU_SOLVE_FAILED;
+	}
+	// a search without limits still gets a budget, which tells a failed search from one that
+	// found no solution
+	DfsBudget noLimits;
+	if (budget == NULL)
+	{
+		initDfsBudget(&noLimits, DFS_NO_LIMIT, DFS_NO_LIMIT);
+		budget = &noLimits;
+	}
+	memcpy(suduku->board, cells, size * size * sizeof(SudukuCell));
+	int status = SUDUKU_SOLVE_NO_SOLUTION;
+	if (initSudukuMasks(suduku) && propagateSudukuRoot(suduku))
+	{
+		pNode found = getBestInWorkspace(suduku, solver->fillMoves[boxSize], \
+										 solver->applyMoves[boxSize], undoSudukuMoveFunc, \
+										 getSudukuValFunc, size * size, budget, \
+										 solver->workspace);
+		if (budget->status == DFS_STATUS_FAILED)
+		{
+			status = SUDUKU_SOLVE_FAILED;
+		}
+		else if (budget->status != DFS_STATUS_DONE)
+		{
+			status = SUDUKU_SOLVE_STOPPED;
+		}
+		else if (found != NULL)
+		{
+			memcpy(solution, suduku->board, size * size * sizeof(SudukuCell));
+			status = SUDUKU_SOLVE_OK;
+		}
+	}
+	freeSudukuFunc(suduku);
+	return status;
+}
+
+/**
+ * This function solves a board given in the text format of a board file (see parseSudukuText),
+ * like solveSudukuCells. it makes no allocation.
+ * input :
+ * 		SudukuSolver* solver - the solver
+ * 		const char* text - the text
+ * 		size_t length - the length of the text
+ * 		int* size - a pointer to put the size of the board in
+ * 		SudukuCell* solution - an array of maxSize * maxSize slots to put the solution in
+ * 		DfsBudget* budget - the budget of the search, NULL for none
+ * output :
+ * 		one of the SUDUKU_SOLVE_ consts. solution is filled only for SUDUKU_SOLVE_OK.
+ **/
+int solveSudukuText(SudukuSolver* solver, const char* text, size_t length, int* size, \
+					SudukuCell* solution, DfsBudget* budget)
+{
+	// the board is parsed into the solver's slots, so solution is left as it was if it's not solved
+	if (parseSudukuText(text, length, solver->maxSize, size, solver->textCells, NULL) != \
+		SUDUKU_LOAD_OK)
+	{
+		return SUDUKU_SOLVE_NOT_VALID;
+	}
+	return solveSudukuCells(solver, *size, solver->textCells, solution, budget);
+}
+
+/**
+ * This function returns the biggest size of the boards a solver solves.
+ * input :
+ * 		const SudukuSolver* solver - the solver
+ * output :
+ * 		the size.
+ **/
+int getSudukuSolverMaxSize(const SudukuSolver* solver)
+{
+	return solver->maxSize;
+}
+
+/**
+ * This function returns the number of nodes the searches of a solver expanded since it was
+ * created, over all its boards.
+ * input :
+ * 		const SudukuSolver* solver - the solver
+ * output :
+ * 		the number of nodes.
+ **/
+unsigned long getSudukuSolverNodes(const SudukuSolver* solver)
+{
+	unsigned long nodes = 0;
+	int boxSize;
+	for (boxSize = 1; boxSize <= MAX_BOX_SIZE; boxSize++)
+	{
+		if (solver->contexts[boxSize] != NULL)
+		{
+			nodes += solver->contexts[boxSize]->nodesExpanded;
+		}
+	}
+	return nodes;
+}
@@ -0,0 +1,112 @@
+/**
+ ===================================================================================================
+ Name        : sudukulib.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukulib.c, the entry point of the suduku library
+ ===================================================================================================
+ **/
+
+#ifndef sudukulib_H
+#define sudukulib_H
+
+#include <stddef.h>
+#include "genericdfs.h"
+#include "sudukutree.h"
+
+//********      consts
+// the status of a solve
+#define SUDUKU_SOLVE_OK 0
+// the board has a digit twice in a row, col or little board, or the search found no solution
+#define SUDUKU_SOLVE_NO_SOLUTION 1
+// the text is not a board, or the board is bigger than the solver's maximum size
+#define SUDUKU_SOLVE_NOT_VALID 2
+// the budget of the search ran out (or it was cancelled) before it found a solution
+#define SUDUKU_SOLVE_STOPPED 3
+// the search failed: the board couldn't be taken from the solver's pool, or its tree was deeper
+// than the solver's workspace
+#define SUDUKU_SOLVE_FAILED 4
+
+//********      structs
+/**
+ * a solver that solves boards of up to a maximum size, one at a time, without allocating: it
+ * holds a context (and so a pool of boards) for every size up to the maximum, with a board of
+ * each taken and given back once, and the workspace of the in place search for the biggest
+ * board. a solver is used by one thread at a time, and a thread can hold any number of them.
+ **/
+typedef struct SudukuSolver SudukuSolver;
+
+//********      functions
+/**
+ * This function creates a solver and allocates every buffer its boards need: the pools and
+ * trails of the contexts of the sizes up to maxSize, a workspace with a frame and maxSize
+ * moves for every slot of the biggest board (about 4 * maxSize^3 bytes), and the slots of the
+ * biggest board for the boards given as text.
+ * input :
+ * 		int maxSize - the biggest size of the boards it solves, a square up to SUDUKU_MAX_SIZE
+ * output :
+ * 		the solver, NULL if maxSize is not a square in range or memory allocation failed.
+ **/
+SudukuSolver* createSudukuSolver(int maxSize);
+
+/**
+ * This function frees a solver and all its buffers from memory.
+ * input :
+ * 		SudukuSolver* solver - the solver
+ * output :
+ * 		void
+ **/
+void freeSudukuSolver(SudukuSolver* solver);
+
+/**
+ * This function solves a board given by its slots, with the in place search over the solver's
+ * buffers (the solver specialized for the size if there is one), filling the forced slots of
+ * every node. it makes no allocation.
+ * input :
+ * 		SudukuSolver* solver - the solver
+ * 		int size - the size of the board
+ * 		const SudukuCell* cells - the size * size slots of the board, row after row, 0 for empty
+ * 		SudukuCell* solution - an array of size * size slots to put the solution in. it can be
+ * 							   cells itself
+ * 		DfsBudget* budget - the budget of the search, set by initDfsBudget. NULL for none
+ * output :
+ * 		one of the SUDUKU_SOLVE_ consts. solution is filled only for SUDUKU_SOLVE_OK.
+ **/
+int solveSudukuCells(SudukuSolver* solver, int size, const SudukuCell* cells, \
+					 SudukuCell* solution, DfsBudget* budget);
+
+/**
+ * This function solves a board given in the text format of a board file (see parseSudukuText),
+ * like solveSudukuCells. it makes no allocation.
+ * input :
+ * 		SudukuSolver* solver - the solver
+ * 		const char* text - the text
+ * 		size_t length - the length of the text
+ * 		int* size - a pointer to put the size of the board in
+ * 		SudukuCell* solution - an array of maxSize * maxSize slots to put the solution in
+ * 		DfsBudget* budget - the budget of the search, NULL for none
+ * output :
+ * 		one of the SUDUKU_SOLVE_ consts. solution is filled only for SUDUKU_SOLVE_OK.
+ **/
+int solveSudukuText(SudukuSolver* solver, const char* text, size_t length, int* size, \
+					SudukuCell* solution, DfsBudget* budget);
+
+/**
+ * This function returns the biggest size of the boards a solver solves.
+ * input :
+ * 		const SudukuSolver* solver - the solver
+ * output :
+ * 		the size.
+ **/
+int getSudukuSolverMaxSize(const SudukuSolver* solver);
+
+/**
+ * This function returns the number of nodes the searches of a solver expanded since it was
+ * created, over all its boards.
+ * input :
+ * 		const SudukuSolver* solver - the solver
+ * output :
+ * 		the number of nodes.
+ **/
+unsigned long getSudukuSolverNodes(const SudukuSolver* solver);
+
+#endif // sudukulib_H
@@ -0,0 +1,296 @@
+/**
+ ===================================================================================================
+ Name        : sudukuloader.c
+ Author      : Yinnon Bratspiess
+ Description : This file loads a suduku board file without a fscanf call per slot: the file is
+ * 			   memory mapped (or read in blocks), its nums are parsed by a hand written scanner,
+ * 			   and the board is checked in one pass by building its used digits sets.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sudukutree.h"
+#include "sudukuloader.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+// not an int number indicator of sqrtCheck
+#define NOT_AN_INT -1
+// a stream that can't be mapped is read in blocks of this many bytes, into a buffer that is
+// doubled when it's full
+#define READ_BLOCK_BYTES 65536
+// a num with more digits than this is out of range for any board, so the rest of its digits are
+// not added up
+#define MAX_NUM_DIGITS 9
+
+// -------------------------- structs -----------------------------------
+/**
+ * the text of a board file: either a memory mapping of the file or a buffer it was read into.
+ **/
+typedef struct LoaderText
+{
+	char* text;
+	size_t length;
+	int mapped;
+}LoaderText;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function gets the text of a file: a regular file is memory mapped, any other stream (or a
+ * file that can't be mapped) is read to its end in blocks.
+ * input :
+ * 		FILE* file - the file
+ * 		LoaderText* text - a struct to put the text in
+ * output :
+ * 		1 if the text was read, 0 if memory allocation failed.
+ **/
+static int readText(FILE* file, LoaderText* text)
+{
+	struct stat fileStat;
+	text->text = NULL;
+	text->length = 0;
+	text->mapped = FALSE;
+	if (fstat(fileno(file), &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0)
+	{
+		void* map = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+		if (map != MAP_FAILED)
+		{
+			posix_madvise(map, fileStat.st_size, POSIX_MADV_SEQUENTIAL);
+			text->text = (char*)map;
+			text->length = fileStat.st_size;
+			text->mapped = TRUE;
+			return TRUE;
+		}
+	}
+	size_t capacity = 0;
+	size_t bytesRead;
+	do
+	{
+		if (text->length + READ_BLOCK_BYTES > capacity)
+		{
+			capacity = (capacity == 0) ? READ_BLOCK_BYTES : capacity * 2;
+			char* grown = (char*)realloc(text->text, capacity);
+			if (grown == NULL)
+			{
+				free(text->text);
+				text->text = NULL;
+				return FALSE;
+			}
+			text->text = grown;
+		}
+		bytesRead = fread(text->text + text->length, 1, READ_BLOCK_BYTES, file);
+		text->length += bytesRead;
+	} while (bytesRead == READ_BLOCK_BYTES);
+	return TRUE;
+}
+
+/**
+ * This function frees the text of a file.
+ * input :
+ * 		LoaderText* text - the text
+ * output :
+ * 		void
+ **/
+static void freeText(LoaderText* text)
+{
+	if (text->mapped)
+	{
+		munmap(text->text, text->length);
+	}
+	else
+	{
+		free(text->text);
+	}
+}
+
+/**
+ * This function scans the next int of a text, as fscanf("%d") would: white space, an optional
+ * sign and digits.
+ * input :
+ * 		const char** position - a pointer to the position to scan from, moved past the int
+ * 		const char* end - the end of the text
+ * 		long* value - a pointer to put the int in. an int too big for a board is put as
+ * 					  SUDUKU_MAX_SIZE + 1
+ * output :
+ * 		1 if an int was scanned, 0 at the end of the text or if the next token is not an int.
+ **/
+static int scanInt(const char** position, const char* end, long* value)
+{
+	const char* scan = *position;
+	// the white space of the "C" locale
+	while (scan < end && (*scan == ' ' || (*scan >= '\t' && *scan <= '\r')))
+	{
+		scan++;
+	}
+	int negative = FALSE;
+	if (scan < end && (*scan == '-' || *scan == '+'))
+	{
+		negative = (*scan == '-');
+		scan++;
+	}
+	const char* digits = scan;
+	long number = 0;
+	while (scan < end && *scan >= '0' && *scan <= '9')
+	{
+		if (scan - digits < MAX_NUM_DIGITS)
+		{
+			number = number * 10 + (*scan - '0');
+		}
+		else
+		{
+			number = SUDUKU_MAX_SIZE + 1;
+		}
+		scan++;
+	}
+	if (scan == digits)
+	{
+		return FALSE;
+	}
+	*value = negative ? -number : number;
+	*position = scan;
+	return TRUE;
+}
+
+/**
+ * This function scans the size of a board, which must be a square of up to maxSize.
+ * input :
+ * 		const char** position - a pointer to the position to scan from, moved past the size
+ * 		const char* end - the end of the text
+ * 		int maxSize - the biggest size allowed
+ * 		int* size - a pointer to put the size in
+ * output :
+ * 		1 if a legal size was scanned, else 0.
+ **/
+static int scanSize(const char** position, const char* end, int maxSize, int* size)
+{
+	long value;
+	if (!scanInt(position, end, &value) || value <= 0 || value > maxSize || \
+		sqrtCheck((int)value) == NOT_AN_INT)
+	{
+		return FALSE;
+	}
+	*size = (int)value;
+	return TRUE;
+}
+
+/**
+ * This function scans the size * size nums of a board, row after row.
+ * input :
+ * 		const char** position - a pointer to the position to scan from, moved past the nums
+ * 		const char* end - the end of the text
+ * 		int size - the size of the board
+ * 		SudukuCell* cells - an array of size * size slots to put the nums in
+ * output :
+ * 		1 if all the nums were scanned and are from 0 to size, else 0.
+ **/
+static int scanCells(const char** position, const char* end, int size, SudukuCell* cells)
+{
+	long num;
+	int slot;
+	for (slot = 0; slot < size * size; slot++)
+	{
+		if (!scanInt(position, end, &num) || num < 0 || num > size)
+		{
+			return FALSE;
+		}
+		cells[slot] = (SudukuCell)num;
+	}
+	return TRUE;
+}
+
+/**
+ * This function parses a board from a text in memory, in the format of a board file: the size
+ * and then size * size nums. it's the scanner of loadSudukuBoard without the file and without a
+ * board, so it allocates nothing. the board is not checked for repeated digits.
+ * input :
+ * 		const char* text - the text
+ * 		size_t length - the length of the text
+ * 		int maxSize - the biggest size allowed, up to SUDUKU_MAX_SIZE
+ * 		int* size - a pointer to put the size of the board in
+ * 		SudukuCell* cells - an array of maxSize * maxSize slots to put the nums in
+ * 		size_t* parsedLength - a pointer to put the length of the text up to the end of the last
+ * 							   num in, NULL if it's not needed
+ * output :
+ * 		SUDUKU_LOAD_OK, or SUDUKU_LOAD_NOT_VALID if the text is not a board of up to maxSize.
+ **/
+int parseSudukuText(const char* text, size_t length, int maxSize, int* size, SudukuCell* cells, \
+					size_t* parsedLength)
+{
+	const char* position = text;
+	if (!scanSize(&position, text + length, maxSize, size) || \
+		!scanCells(&position, text + length, *size, cells))
+	{
+		return SUDUKU_LOAD_NOT_VALID;
+	}
+	if (parsedLength != NULL)
+	{
+		*parsedLength = position - text;
+	}
+	return SUDUKU_LOAD_OK;
+}
+
+/**
+ * This function loads a board file: the size and then size * size nums, row after row, separated
+ * by white space. a regular file is memory mapped and any other stream is read in blocks, and
+ * the nums are parsed by a scanner of their own, so there's no fscanf call per slot. the board is
+ * then checked by building its used digits sets, in one pass over the slots. anything after the
+ * last num is ignored.
+ * input :
+ * 		FILE* file - the file, open for reading and not read from yet
+ * 		int* status - a pointer to put the SUDUKU_LOAD_ status of the load in
+ * output :
+ * 		the board, ready for the solver, in a new context of its size. NULL if the status is not
+ * 		SUDUKU_LOAD_OK.
+ **/
+SudukuBoardStruct* loadSudukuBoard(FILE* file, int* status)
+{
+	LoaderText text;
+	if (!readText(file, &text))
+	{
+		*status = SUDUKU_LOAD_NO_MEMORY;
+		return NULL;
+	}
+	const char* position = text.text;
+	const char* end = text.text + text.length;
+	int size;
+	if (!scanSize(&position, end, SUDUKU_MAX_SIZE, &size))
+	{
+		freeText(&text);
+		*status = SUDUKU_LOAD_NOT_VALID;
+		return NULL;
+	}
+	// the context holds the pool every board of this size comes from
+	SudukuContext* context = createSudukuContext(size);
+	SudukuBoardStruct* suduku = (context == NULL) ? NULL : createSudukuBoard(context);
+	if (suduku == NULL)
+	{
+		if (context != NULL)
+		{
+			freeSudukuContext(context);
+		}
+		freeText(&text);
+		*status = SUDUKU_LOAD_NO_MEMORY;
+		return NULL;
+	}
+	*status = scanCells(&position, end, size, suduku->board) ? SUDUKU_LOAD_OK : \
+			  SUDUKU_LOAD_NOT_VALID;
+	freeText(&text);
+	// building the used digits sets finds any digit that is twice in a row, col or little board
+	if (*status == SUDUKU_LOAD_OK && !initSudukuMasks(suduku))
+	{
+		*status = SUDUKU_LOAD_NO_SOLUTION;
+	}
+	if (*status != SUDUKU_LOAD_OK)
+	{
+		freeSudukuContext(context);
+		return NULL;
+	}
+	return suduku;
+}
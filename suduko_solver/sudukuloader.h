@@ -0,0 +1,58 @@
+/**
+ ===================================================================================================
+ Name        : sudukuloader.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukuloader.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukuloader_H
+#define sudukuloader_H
+
+#include <stdio.h>
+#include "sudukutree.h"
+
+//********      consts
+// the status of a load
+#define SUDUKU_LOAD_OK 0
+// the file is not a board: a bad size, a missing num or a num out of range
+#define SUDUKU_LOAD_NOT_VALID 1
+// the board has a digit twice in a row, col or little board
+#define SUDUKU_LOAD_NO_SOLUTION 2
+#define SUDUKU_LOAD_NO_MEMORY 3
+
+//********      functions
+/**
+ * This function loads a board file: the size and then size * size nums, row after row, separated
+ * by white space. a regular file is memory mapped and any other stream is read in blocks, and
+ * the nums are parsed by a scanner of their own, so there's no fscanf call per slot. the board is
+ * then checked by building its used digits sets, in one pass over the slots. anything after the
+ * last num is ignored.
+ * input :
+ * 		FILE* file - the file, open for reading and not read from yet
+ * 		int* status - a pointer to put the SUDUKU_LOAD_ status of the load in
+ * output :
+ * 		the board, ready for the solver, in a new context of its size. NULL if the status is not
+ * 		SUDUKU_LOAD_OK.
+ **/
+SudukuBoardStruct* loadSudukuBoard(FILE* file, int* status);
+
+/**
+ * This function parses a board from a text in memory, in the format of a board file: the size
+ * and then size * size nums. it's the scanner of loadSudukuBoard without the file and without a
+ * board, so it allocates nothing. the board is not checked for repeated digits.
+ * input :
+ * 		const char* text - the text
+ * 		size_t length - the length of the text
+ * 		int maxSize - the biggest size allowed, up to SUDUKU_MAX_SIZE
+ * 		int* size - a pointer to put the size of the board in
+ * 		SudukuCell* cells - an array of maxSize * maxSize slots to put the nums in
+ * 		size_t* parsedLength - a pointer to put the length of the text up to the end of the last
+ * 							   num in, NULL if it's not needed
+ * output :
+ * 		SUDUKU_LOAD_OK, or SUDUKU_LOAD_NOT_VALID if the text is not a board of up to maxSize.
+ **/
+int parseSudukuText(const char* text, size_t length, int maxSize, int* size, SudukuCell* cells, \
+					size_t* parsedLength);
+
+#endif // sudukuloader_H
@@ -0,0 +1,431 @@
+/**
+ ===================================================================================================
+ Name        : sudukuportfolio.c
+ Author      : Yinnon Bratspiess
+ Description : This file solves a suduku board with a portfolio of search configurations at
+ * 			   once, one thread per configuration. the first configuration to finish wins and the
+ * 			   searches of the others are cancelled.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "genericdfs.h"
+#include "sudukutree.h"
+#include "sudukufixed.h"
+#include "sudukuportfolio.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define NANOS_IN_SECOND 1000000000ULL
+#define NANOS_IN_MILLI 1e6
+#define PERCENT 100.0
+// the seed of the random digit orders, so a portfolio tries the same orders on every run
+#define PORTFOLIO_SEED 0x5eed5eed5eed5eedULL
+
+// -------------------------- structs -----------------------------------
+
+/**
+ * a configuration searching on a thread: its own context and copy of the board, the move
+ * function of its size and branch policy, and the budget the winner cancels it through.
+ **/
+typedef struct PortfolioWorker
+{
+	const SudukuPortfolioConfig* config;
+	struct SudukuPortfolioSearch* search;
+	int index;
+	SudukuContext* context;
+	SudukuBoardStruct* suduku;
+	getNodeMovesFunc getMoves;
+	applyMoveFunc applyMove;
+	uint64_t random;
+	DfsBudget budget;
+	int started;
+}PortfolioWorker;
+
+/**
+ * the state shared by the threads of one board: the workers, the winner and the time the
+ * searches started at. the contexts of the workers are kept from board to board of their size.
+ **/
+struct SudukuPortfolioSearch
+{
+	SudukuPortfolio* portfolio;
+	PortfolioWorker workers[SUDUKU_PORTFOLIO_MAX_CONFIGS];
+	atomic_int winner;
+	uint64_t start;
+};
+
+// ------------------------------ globals -------------------------------
+const SudukuPortfolioConfig sudukuDefaultPortfolio[SUDUKU_DEFAULT_PORTFOLIO_CONFIGS] = \
+{
+	{"fewest-candidates", SUDUKU_BRANCH_FEWEST_CANDIDATES, NULL, SUDUKU_DIGITS_ASCENDING},
+	{"fewest-candidates-random", SUDUKU_BRANCH_FEWEST_CANDIDATES, NULL, SUDUKU_DIGITS_RANDOM},
+	{"fewest-candidates-degree", SUDUKU_BRANCH_FEWEST_CANDIDATES, sudukuDegreeTieBreak, \
+	 SUDUKU_DIGITS_ASCENDING},
+	{"first-empty", SUDUKU_BRANCH_FIRST_EMPTY, NULL, SUDUKU_DIGITS_ASCENDING},
+	{"first-empty-random", SUDUKU_BRANCH_FIRST_EMPTY, NULL, SUDUKU_DIGITS_RANDOM}
+};
+
+// the worker searching on the thread, for the move function of the random digit order
+static _Thread_local PortfolioWorker* currentWorker = NULL;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function returns the time of CLOCK_MONOTONIC in nanoseconds.
+ **/
+static uint64_t readNanos(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * NANOS_IN_SECOND + time.tv_nsec;
+}
+
+/**
+ * This function returns the next number of a random stream (splitmix64).
+ * input :
+ * 		uint64_t* state - the state of the stream
+ * output :
+ * 		the number
+ **/
+static uint64_t nextRandom(uint64_t* state)
+{
+	uint64_t value = (*state += 0x9e3779b97f4a7c15ULL);
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+/**
+ * This is the move function of the random digit order: the moves of the worker's move function,
+ * in a random order (Fisher Yates).
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int** movesList - a pointer to an array of moves
+ * output :
+ * 		the number of moves. -1 indicates illeagal value
+ **/
+static int getRandomOrderMoves(void* sudukuStruct, int** movesList)
+{
+	PortfolioWorker* worker = currentWorker;
+	int numOfMoves = worker->getMoves(sudukuStruct, movesList);
+	int i;
+	for (i = numOfMoves - 1; i > 0; i--)
+	{
+		int j = (int)(nextRandom(&worker->random) % (uint64_t)(i + 1));
+		int temp = (*movesList)[i];
+		(*movesList)[i] = (*movesList)[j];
+		(*movesList)[j] = temp;
+	}
+	return numOfMoves;
+}
+
+/**
+ * This function is the thread of a configuration: it searches its copy of the board, and if it
+ * finishes first it cancels the searches of the others.
+ * input :
+ * 		void* workerStruct - the worker
+ * output :
+ * 		NULL
+ **/
+static void* searchConfig(void* workerStruct)
+{
+	PortfolioWorker* worker = (PortfolioWorker*)workerStruct;
+	SudukuPortfolioSearch* search = worker->search;
+	SudukuPortfolio* portfolio = search->portfolio;
+	int numOfSlots = worker->suduku->size * worker->suduku->size;
+	currentWorker = worker;
+	getBestInPlaceWithBudget(worker->suduku, \
+							 (worker->config->digitOrder == SUDUKU_DIGITS_RANDOM) ? \
+							 getRandomOrderMoves : worker->getMoves, worker->applyMove, \
+							 undoSudukuMoveFunc, getSudukuValFunc, NULL, NULL, numOfSlots, NULL, \
+							 &worker->budget);
+	currentWorker = NULL;
+	int expected = SUDUKU_NO_WINNER;
+	if (worker->budget.status == DFS_STATUS_DONE && \
+		atomic_compare_exchange_strong(&search->winner, &expected, worker->index))
+	{
+		int i;
+		for (i = 0; i < portfolio->numOfConfigs; i++)
+		{
+			if (i != worker->index)
+			{
+				cancelDfsSearch(&search->workers[i].budget);
+			}
+		}
+		atomic_fetch_add(&portfolio->wins[worker->index], 1);
+		atomic_fetch_add(&portfolio->winNanos[worker->index], readNanos() - search->start);
+		atomic_fetch_add(&portfolio->solves, 1);
+	}
+	return NULL;
+}
+
+/**
+ * This function sets the configurations of a portfolio and zeroes its win counters.
+ * input :
+ * 		SudukuPortfolio* portfolio - the portfolio
+ * 		const SudukuPortfolioConfig* configs - the configurations, kept by the portfolio
+ * 		int numOfConfigs - the number of configurations, from 1 to SUDUKU_PORTFOLIO_MAX_CONFIGS
+ * output :
+ * 		1 if the portfolio was set, 0 if the number of configurations is out of range.
+ **/
+int initSudukuPortfolio(SudukuPortfolio* portfolio, const SudukuPortfolioConfig* configs, \
+						int numOfConfigs)
+{
+	if (numOfConfigs < 1 || numOfConfigs > SUDUKU_PORTFOLIO_MAX_CONFIGS)
+	{
+		return FALSE;
+	}
+	portfolio->configs = configs;
+	portfolio->numOfConfigs = numOfConfigs;
+	atomic_init(&portfolio->solves, 0);
+	int i;
+	for (i = 0; i < SUDUKU_PORTFOLIO_MAX_CONFIGS; i++)
+	{
+		atomic_init(&portfolio->wins[i], 0);
+		atomic_init(&portfolio->winNanos[i], 0);
+	}
+	return TRUE;
+}
+
+/**
+ * This function creates the state of the searches of a portfolio, which solves any number of
+ * boards one after another.
+ * input :
+ * 		SudukuPortfolio* portfolio - the portfolio
+ * output :
+ * 		the state. NULL if memory allocation failed
+ **/
+SudukuPortfolioSearch* createSudukuPortfolioSearch(SudukuPortfolio* portfolio)
+{
+	// the search is big, so it's not kept on the stack
+	SudukuPortfolioSearch* search = (SudukuPortfolioSearch*)calloc(1, \
+																	sizeof(SudukuPortfolioSearch));
+	if (search == NULL)
+	{
+		return NULL;
+	}
+	search->portfolio = portfolio;
+	int i;
+	for (i = 0; i < portfolio->numOfConfigs; i++)
+	{
+		search->workers[i].config = &portfolio->configs[i];
+		search->workers[i].search = search;
+		search->workers[i].index = i;
+	}
+	return search;
+}
+
+/**
+ * This function frees the state of the searches of a portfolio, with the contexts of its workers.
+ * input :
+ * 		SudukuPortfolioSearch* search - the state
+ * output :
+ * 		void
+ **/
+void freeSudukuPortfolioSearch(SudukuPortfolioSearch* search)
+{
+	if (search == NULL)
+	{
+		return;
+	}
+	int i;
+	for (i = 0; i < search->portfolio->numOfConfigs; i++)
+	{
+		if (search->workers[i].context != NULL)
+		{
+			freeSudukuContext(search->workers[i].context);
+		}
+	}
+	free(search);
+}
+
+/**
+ * This function gives a worker its copy of a board, in a context of the board's size. the context
+ * of the last board is kept if it's of the same size, so its pool is warm.
+ * input :
+ * 		PortfolioWorker* worker - the worker
+ * 		SudukuBoardStruct* suduku - the board
+ * 		DfsBudget* limits - the budget every configuration gets, NULL for none
+ * output :
+ * 		1 if the worker is ready, 0 if memory allocation failed.
+ **/
+static int prepareWorker(PortfolioWorker* worker, SudukuBoardStruct* suduku, DfsBudget* limits)
+{
+	// every configuration gets its own context, since the in place moves use the context's trail
+	if (worker->context != NULL && worker->context->size != suduku->size)
+	{
+		freeSudukuContext(worker->context);
+		worker->context = NULL;
+	}
+	if (worker->context == NULL)
+	{
+		worker->context = createSudukuContext(suduku->size);
+		if (worker->context == NULL)
+		{
+			return FALSE;
+		}
+		worker->context->branchPolicy = worker->config->branchPolicy;
+		worker->context->tieBreak = worker->config->tieBreak;
+		getSudukuFixedMoveFuncs(worker->context, &worker->getMoves, &worker->applyMove);
+	}
+	worker->suduku = createSudukuBoard(worker->context);
+	if (worker->suduku == NULL)
+	{
+		return FALSE;
+	}
+	worker->context->propagate = suduku->context->propagate;
+	memcpy(worker->suduku->board, suduku->board, \
+		   suduku->size * suduku->size * sizeof(SudukuCell));
+	initSudukuMasks(worker->suduku);
+	worker->random = PORTFOLIO_SEED ^ (uint64_t)worker->index;
+	initDfsBudget(&worker->budget, (limits == NULL) ? DFS_NO_LIMIT : limits->maxNodes, \
+				  DFS_NO_LIMIT);
+	worker->budget.deadline = (limits == NULL) ? DFS_NO_LIMIT : limits->deadline;
+	return TRUE;
+}
+
+/**
+ * This function solves a board with every configuration of a portfolio at once, each with its own
+ * copy of the board: the first configuration on the calling thread and every other one on a
+ * thread of its own. the first configuration to finish its search (with a solution, or knowing
+ * there's none) wins, the searches of the others are cancelled, and the board is turned into the
+ * solution of the winner. the board's context decides whether the searches fill the forced slots.
+ * a configuration whose thread can't be started is left out.
+ * input :
+ * 		SudukuPortfolioSearch* search - the state of the searches of the portfolio
+ * 		SudukuBoardStruct* suduku - the board, with its used digits sets built
+ * 		DfsBudget* limits - the budget every configuration gets, NULL for none. it gets the status
+ * 							of the winner (or of the configuration that got furthest, if none
+ * 							won), the nodes all the configurations expanded and the highest value
+ * 							any of them visited
+ * output :
+ * 		the index of the winning configuration, SUDUKU_NO_WINNER if the budget ran out for all of
+ * 		them (the board is then turned into the fullest board any of them found), or
+ * 		SUDUKU_PORTFOLIO_FAILED if memory allocation failed. the board is solved if its value is
+ * 		size * size.
+ **/
+int runSudukuPortfolio(SudukuPortfolioSearch* search, SudukuBoardStruct* suduku, \
+					   DfsBudget* limits)
+{
+	SudukuPortfolio* portfolio = search->portfolio;
+	pthread_t threads[SUDUKU_PORTFOLIO_MAX_CONFIGS];
+	int i, failed = FALSE;
+	for (i = 0; i < portfolio->numOfConfigs; i++)
+	{
+		search->workers[i].suduku = NULL;
+		search->workers[i].started = FALSE;
+	}
+	for (i = 0; i < portfolio->numOfConfigs && !failed; i++)
+	{
+		failed = !prepareWorker(&search->workers[i], suduku, limits);
+	}
+	int winner = SUDUKU_PORTFOLIO_FAILED;
+	if (!failed)
+	{
+		atomic_init(&search->winner, SUDUKU_NO_WINNER);
+		search->start = readNanos();
+		for (i = 1; i < portfolio->numOfConfigs; i++)
+		{
+			search->workers[i].started = (pthread_create(&threads[i], NULL, searchConfig, \
+														 &search->workers[i]) == 0);
+		}
+		search->workers[0].started = TRUE;
+		searchConfig(&search->workers[0]);
+		for (i = 1; i < portfolio->numOfConfigs; i++)
+		{
+			if (search->workers[i].started)
+			{
+				pthread_join(threads[i], NULL);
+			}
+		}
+		winner = atomic_load(&search->winner);
+		// the board of the winner, or the fullest board of a configuration that was stopped
+		int furthest = winner;
+		unsigned long nodesExpanded = 0;
+		for (i = 0; i < portfolio->numOfConfigs; i++)
+		{
+			PortfolioWorker* worker = &search->workers[i];
+			if (!worker->started)
+			{
+				continue;
+			}
+			nodesExpanded += worker->budget.nodesExpanded;
+			if (winner == SUDUKU_NO_WINNER && (furthest == SUDUKU_NO_WINNER || \
+				worker->budget.bestValue > search->workers[furthest].budget.bestValue))
+			{
+				furthest = i;
+			}
+		}
+		memcpy(suduku->board, search->workers[furthest].suduku->board, \
+			   suduku->size * suduku->size * sizeof(SudukuCell));
+		initSudukuMasks(suduku);
+		if (limits != NULL)
+		{
+			limits->status = search->workers[furthest].budget.status;
+			limits->nodesExpanded = nodesExpanded;
+			limits->bestValue = search->workers[furthest].budget.bestValue;
+		}
+	}
+	// the boards go back to the pools of the workers' contexts, for the next board
+	for (i = 0; i < portfolio->numOfConfigs; i++)
+	{
+		if (search->workers[i].suduku != NULL)
+		{
+			freeSudukuFunc(search->workers[i].suduku);
+		}
+	}
+	return winner;
+}
+
+/**
+ * This function solves a board with every configuration of a portfolio at once, like
+ * runSudukuPortfolio with a state of its own.
+ * input :
+ * 		SudukuBoardStruct* suduku - the board, with its used digits sets built
+ * 		SudukuPortfolio* portfolio - the portfolio
+ * 		DfsBudget* limits - the budget every configuration gets, NULL for none, as in
+ * 							runSudukuPortfolio
+ * output :
+ * 		what runSudukuPortfolio returns.
+ **/
+int solveSudukuPortfolio(SudukuBoardStruct* suduku, SudukuPortfolio* portfolio, DfsBudget* limits)
+{
+	SudukuPortfolioSearch* search = createSudukuPortfolioSearch(portfolio);
+	if (search == NULL)
+	{
+		return SUDUKU_PORTFOLIO_FAILED;
+	}
+	int winner = runSudukuPortfolio(search, suduku, limits);
+	freeSudukuPortfolioSearch(search);
+	return winner;
+}
+
+/**
+ * This function prints the win rates of the configurations of a portfolio: the boards every
+ * configuration won, the part of all the finished boards they are, and the mean time it won in.
+ * input :
+ * 		FILE* output - the stream to print to
+ * 		SudukuPortfolio* portfolio - the portfolio
+ * output :
+ * 		void
+ **/
+void printSudukuPortfolio(FILE* output, SudukuPortfolio* portfolio)
+{
+	unsigned long solves = atomic_load(&portfolio->solves);
+	int i;
+	fprintf(output, "config wins win-rate mean-win-ms\n");
+	for (i = 0; i < portfolio->numOfConfigs; i++)
+	{
+		unsigned long wins = atomic_load(&portfolio->wins[i]);
+		fprintf(output, "%s %lu %.1f%% %.3f\n", portfolio->configs[i].name, wins, \
+				(solves == 0) ? 0.0 : PERCENT * wins / solves, \
+				(wins == 0) ? 0.0 : atomic_load(&portfolio->winNanos[i]) / NANOS_IN_MILLI / wins);
+	}
+}
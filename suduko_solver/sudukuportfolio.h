@@ -0,0 +1,155 @@
+/**
+ ===================================================================================================
+ Name        : sudukuportfolio.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukuportfolio.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukuportfolio_H
+#define sudukuportfolio_H
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include "genericdfs.h"
+#include "sudukutree.h"
+
+//********      consts
+// the order the moves of a board are tried in: by ascending digit (the order of
+// getSudukuMovesFunc), or in a random order of every board
+#define SUDUKU_DIGITS_ASCENDING 0
+#define SUDUKU_DIGITS_RANDOM 1
+// the most configurations of a portfolio
+#define SUDUKU_PORTFOLIO_MAX_CONFIGS 16
+// the number of configurations of sudukuDefaultPortfolio
+#define SUDUKU_DEFAULT_PORTFOLIO_CONFIGS 5
+// no configuration finished the search
+#define SUDUKU_NO_WINNER -1
+// the searches could not be run, since memory allocation failed
+#define SUDUKU_PORTFOLIO_FAILED -2
+
+//********      structs
+/**
+ * struct for a configuration of the search, that a portfolio runs on a thread of its own.
+ * const char* name - the name of the configuration, for the win rates
+ * int branchPolicy - one of the SUDUKU_BRANCH_ consts
+ * SudukuTieBreakFunc tieBreak - the tie break of SUDUKU_BRANCH_FEWEST_CANDIDATES, NULL for none
+ * int digitOrder - one of the SUDUKU_DIGITS_ consts
+ **/
+typedef struct SudukuPortfolioConfig
+{
+	const char* name;
+	int branchPolicy;
+	SudukuTieBreakFunc tieBreak;
+	int digitOrder;
+}SudukuPortfolioConfig;
+
+/**
+ * struct for a portfolio: the configurations it runs at once and how often each of them won. the
+ * counters are atomic, so one portfolio can solve boards on several threads at once.
+ * const SudukuPortfolioConfig* configs - the configurations
+ * int numOfConfigs - the number of configurations, up to SUDUKU_PORTFOLIO_MAX_CONFIGS
+ * atomic_ulong solves - the number of boards a configuration finished
+ * atomic_ulong wins - the number of boards every configuration finished first
+ * atomic_ulong winNanos - the nanoseconds every configuration took on the boards it won
+ **/
+typedef struct SudukuPortfolio
+{
+	const SudukuPortfolioConfig* configs;
+	int numOfConfigs;
+	atomic_ulong solves;
+	atomic_ulong wins[SUDUKU_PORTFOLIO_MAX_CONFIGS];
+	atomic_ulong winNanos[SUDUKU_PORTFOLIO_MAX_CONFIGS];
+}SudukuPortfolio;
+
+/**
+ * the state of the searches of a portfolio: a context and a copy of the board for every
+ * configuration. the contexts are kept from board to board, so solving many boards of one size
+ * allocates nothing after the first. one state solves one board at a time.
+ **/
+typedef struct SudukuPortfolioSearch SudukuPortfolioSearch;
+
+// the configurations sudukusolver runs: the fewest candidates and the first empty slot, each with
+// the digits ascending and in a random order, and the fewest candidates with the degree tie break
+extern const SudukuPortfolioConfig sudukuDefaultPortfolio[SUDUKU_DEFAULT_PORTFOLIO_CONFIGS];
+
+//********      functions
+/**
+ * This function sets the configurations of a portfolio and zeroes its win counters.
+ * input :
+ * 		SudukuPortfolio* portfolio - the portfolio
+ * 		const SudukuPortfolioConfig* configs - the configurations, kept by the portfolio
+ * 		int numOfConfigs - the number of configurations, from 1 to SUDUKU_PORTFOLIO_MAX_CONFIGS
+ * output :
+ * 		1 if the portfolio was set, 0 if the number of configurations is out of range.
+ **/
+int initSudukuPortfolio(SudukuPortfolio* portfolio, const SudukuPortfolioConfig* configs, \
+						int numOfConfigs);
+
+/**
+ * This function creates the state of the searches of a portfolio, which solves any number of
+ * boards one after another.
+ * input :
+ * 		SudukuPortfolio* portfolio - the portfolio
+ * output :
+ * 		the state. NULL if memory allocation failed
+ **/
+SudukuPortfolioSearch* createSudukuPortfolioSearch(SudukuPortfolio* portfolio);
+
+/**
+ * This function frees the state of the searches of a portfolio, with the contexts of its workers.
+ * input :
+ * 		SudukuPortfolioSearch* search - the state
+ * output :
+ * 		void
+ **/
+void freeSudukuPortfolioSearch(SudukuPortfolioSearch* search);
+
+/**
+ * This function solves a board with every configuration of a portfolio at once, each with its own
+ * copy of the board: the first configuration on the calling thread and every other one on a
+ * thread of its own. the first configuration to finish its search (with a solution, or knowing
+ * there's none) wins, the searches of the others are cancelled, and the board is turned into the
+ * solution of the winner. the board's context decides whether the searches fill the forced slots.
+ * a configuration whose thread can't be started is left out.
+ * input :
+ * 		SudukuPortfolioSearch* search - the state of the searches of the portfolio
+ * 		SudukuBoardStruct* suduku - the board, with its used digits sets built
+ * 		DfsBudget* limits - the budget every configuration gets, NULL for none. it gets the status
+ * 							of the winner (or of the configuration that got furthest, if none
+ * 							won), the nodes all the configurations expanded and the highest value
+ * 							any of them visited
+ * output :
+ * 		the index of the winning configuration, SUDUKU_NO_WINNER if the budget ran out for all of
+ * 		them (the board is then turned into the fullest board any of them found), or
+ * 		SUDUKU_PORTFOLIO_FAILED if memory allocation failed. the board is solved if its value is
+ * 		size * size.
+ **/
+int runSudukuPortfolio(SudukuPortfolioSearch* search, SudukuBoardStruct* suduku, \
+					   DfsBudget* limits);
+
+/**
+ * This function solves a board with every configuration of a portfolio at once, like
+ * runSudukuPortfolio with a state of its own.
+ * input :
+ * 		SudukuBoardStruct* suduku - the board, with its used digits sets built
+ * 		SudukuPortfolio* portfolio - the portfolio
+ * 		DfsBudget* limits - the budget every configuration gets, NULL for none, as in
+ * 							runSudukuPortfolio
+ * output :
+ * 		what runSudukuPortfolio returns.
+ **/
+int solveSudukuPortfolio(SudukuBoardStruct* suduku, SudukuPortfolio* portfolio, DfsBudget* limits);
+
+/**
+ * This function prints the win rates of the configurations of a portfolio: the boards every
+ * configuration won, the part of all the finished boards they are, and the mean time it won in.
+ * input :
+ * 		FILE* output - the stream to print to
+ * 		SudukuPortfolio* portfolio - the portfolio
+ * output :
+ * 		void
+ **/
+void printSudukuPortfolio(FILE* output, SudukuPortfolio* portfolio);
+
+#endif // sudukuportfolio_H
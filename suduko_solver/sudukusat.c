@@ -0,0 +1,1350 @@
+/**
+ ===================================================================================================
+ Name        : sudukusat.c
+ Author      : Yinnon Bratspiess
+ Description : This file solves a suduku board with a conflict driven clause learning SAT
+ * 			   solver: two watched literals, VSIDS branching with phase saving, first UIP
+ * 			   learning, Luby restarts and deletion of the learned clauses by their LBD.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "sudukutree.h"
+#include "sudukusat.h"
+
+// -------------------------- const definitions -------------------------
+#define TRUE 1
+#define FALSE 0
+#define EMPTY_SLOT 0
+#define NO_VAR -1
+#define NO_LIT -1
+// the value of a literal
+#define LIT_TRUE 1
+#define LIT_FALSE -1
+#define LIT_UNASSIGNED 0
+// the reason of an assignment: none (a decision, or a unit at level 0), a clause of the arena (by
+// its offset) or a binary clause, by its other literal
+#define NO_REASON -1
+#define BINARY_REASON(lit) (-2 - (lit))
+#define BINARY_LIT(reason) (-2 - (reason))
+// the result of a propagation: no conflict, a clause of the arena, or the binary clause of
+// conflictLits
+#define NO_CONFLICT -1
+#define BINARY_CONFLICT INT_MIN
+// the ints before the literals of a clause in the arena: its size and its LBD (0 for a clause of
+// the board, which is never deleted)
+#define CLAUSE_HEADER 2
+#define BOARD_CLAUSE_LBD 0
+// the search result
+#define SAT_UNKNOWN 0
+#define SAT_SOLVED 1
+#define SAT_NO_SOLUTION 2
+// VSIDS: the activity increment grows by 1 / VAR_DECAY after every conflict, and all the
+// activities are scaled down when one gets too big
+#define VAR_DECAY 0.95
+#define ACTIVITY_LIMIT 1e100
+#define ACTIVITY_RESCALE 1e-100
+// a restart comes after RESTART_UNIT times the next number of the Luby sequence of conflicts
+#define RESTART_UNIT 100
+// the learned clauses are first reduced after FIRST_REDUCE conflicts, and every reduction waits
+// REDUCE_INCREMENT conflicts more than the one before. clauses with an LBD up to GLUE_LBD are
+// always kept
+#define FIRST_REDUCE 2000
+#define REDUCE_INCREMENT 300
+#define GLUE_LBD 2
+#define INITIAL_CAPACITY 16
+// the kinds of units of a board
+#define UNIT_TYPES 3
+
+// -------------------------- macros ------------------------------------
+// a literal is a variable and a sign: 2 * var for the variable, 2 * var + 1 for its negation
+#define MAKE_LIT(var, negative) (((var) << 1) | (negative))
+#define LIT_VAR(lit) ((lit) >> 1)
+#define LIT_NEGATIVE(lit) ((lit) & 1)
+#define NOT(lit) ((lit) ^ 1)
+#define CLAUSE_SIZE(solver, ref) ((solver)->arena[ref])
+#define CLAUSE_LBD(solver, ref) ((solver)->arena[(ref) + 1])
+#define CLAUSE_LITS(solver, ref) ((solver)->arena + (ref) + CLAUSE_HEADER)
+// a bit of the levels of a clause, that tells the minimization which levels it can't be implied by
+#define LEVEL_BIT(level) (1u << ((level) & 31))
+
+// -------------------------- structs -----------------------------------
+/**
+ * a growing array of ints.
+ **/
+typedef struct IntVector
+{
+	int* items;
+	int length;
+	int capacity;
+}IntVector;
+
+/**
+ * a watch of a clause of the arena on one of its first two literals: the clause and another of its
+ * literals, which when it's true means the clause needs no visit.
+ **/
+typedef struct SatWatch
+{
+	int clause;
+	int blocker;
+}SatWatch;
+
+/**
+ * the watches of a literal.
+ **/
+typedef struct WatchList
+{
+	SatWatch* watches;
+	int length;
+	int capacity;
+}WatchList;
+
+/**
+ * the solver. the arrays by literal have 2 * numOfVars entries, the arrays by variable numOfVars.
+ **/
+typedef struct SatSolver
+{
+	int numOfVars;
+	// the clauses of three literals or more, one after the other, and their offsets
+	int* arena;
+	int arenaLength;
+	int arenaCapacity;
+	IntVector boardClauses;
+	IntVector learnedClauses;
+	// by literal: the other literals of its binary clauses, and the watches of the longer ones
+	IntVector* binaries;
+	WatchList* watches;
+	signed char* values;
+	// by variable
+	int* levels;
+	int* reasons;
+	double* activity;
+	char* polarity;
+	char* seen;
+	int* heapIndex;
+	// the assigned literals in their order, the first one not propagated yet, and where every
+	// decision level starts
+	int* trail;
+	int trailLength;
+	int propagated;
+	IntVector levelStarts;
+	// the variables by their activity, as a binary max heap
+	int* heap;
+	int heapLength;
+	double activityIncrement;
+	// the clause being learned, the literals its minimization visits and marks, and the stamps
+	// of the levels, for its LBD
+	IntVector learned;
+	IntVector visitStack;
+	IntVector visited;
+	unsigned int* levelStamps;
+	unsigned int stamp;
+	int conflictLits[2];
+	int failed;
+	SudukuSatStats* stats;
+}SatSolver;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function appends an int to a vector.
+ * input :
+ * 		IntVector* vector - the vector
+ * 		int item - the int
+ * output :
+ * 		1 if it was appended, 0 if memory allocation failed.
+ **/
+static int pushInt(IntVector* vector, int item)
+{
+	if (vector->length == vector->capacity)
+	{
+		int capacity = (vector->capacity == 0) ? INITIAL_CAPACITY : vector->capacity * 2;
+		int* items = (int*)realloc(vector->items, capacity * sizeof(int));
+		if (items == NULL)
+		{
+			return FALSE;
+		}
+		vector->items = items;
+		vector->capacity = capacity;
+	}
+	vector->items[vector->length] = item;
+	vector->length++;
+	return TRUE;
+}
+
+/**
+ * This function appends a watch to the watches of a literal.
+ * input :
+ * 		WatchList* list - the watches
+ * 		SatWatch watch - the watch
+ * output :
+ * 		1 if it was appended, 0 if memory allocation failed.
+ **/
+static int pushWatch(WatchList* list, SatWatch watch)
+{
+	if (list->length == list->capacity)
+	{
+		int capacity = (list->capacity == 0) ? INITIAL_CAPACITY : list->capacity * 2;
+		SatWatch* watches = (SatWatch*)realloc(list->watches, capacity * sizeof(SatWatch));
+		if (watches == NULL)
+		{
+			return FALSE;
+		}
+		list->watches = watches;
+		list->capacity = capacity;
+	}
+	list->watches[list->length] = watch;
+	list->length++;
+	return TRUE;
+}
+
+/**
+ * This function moves a variable of the heap up, to its place by its activity.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int position - the variable's position in the heap
+ * output :
+ * 		void
+ **/
+static void heapUp(SatSolver* solver, int position)
+{
+	int var = solver->heap[position];
+	while (position > 0)
+	{
+		int parent = (position - 1) / 2;
+		if (solver->activity[solver->heap[parent]] >= solver->activity[var])
+		{
+			break;
+		}
+		solver->heap[position] = solver->heap[parent];
+		solver->heapIndex[solver->heap[position]] = position;
+		position = parent;
+	}
+	solver->heap[position] = var;
+	solver->heapIndex[var] = position;
+}
+
+/**
+ * This function moves a variable of the heap down, to its place by its activity.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int position - the variable's position in the heap
+ * output :
+ * 		void
+ **/
+static void heapDown(SatSolver* solver, int position)
+{
+	int var = solver->heap[position];
+	while (TRUE)
+	{
+		int child = 2 * position + 1;
+		if (child >= solver->heapLength)
+		{
+			break;
+		}
+		if (child + 1 < solver->heapLength && \
+			solver->activity[solver->heap[child + 1]] > solver->activity[solver->heap[child]])
+		{
+			child++;
+		}
+		if (solver->activity[solver->heap[child]] <= solver->activity[var])
+		{
+			break;
+		}
+		solver->heap[position] = solver->heap[child];
+		solver->heapIndex[solver->heap[position]] = position;
+		position = child;
+	}
+	solver->heap[position] = var;
+	solver->heapIndex[var] = position;
+}
+
+/**
+ * This function puts a variable in the heap, if it's not there.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int var - the variable
+ * output :
+ * 		void
+ **/
+static void heapInsert(SatSolver* solver, int var)
+{
+	if (solver->heapIndex[var] != NO_VAR)
+	{
+		return;
+	}
+	solver->heap[solver->heapLength] = var;
+	solver->heapLength++;
+	heapUp(solver, solver->heapLength - 1);
+}
+
+/**
+ * This function takes the variable with the highest activity out of the heap.
+ * input :
+ * 		SatSolver* solver - the solver, with a heap that is not empty
+ * output :
+ * 		the variable
+ **/
+static int heapRemoveMax(SatSolver* solver)
+{
+	int var = solver->heap[0];
+	solver->heapIndex[var] = NO_VAR;
+	solver->heapLength--;
+	if (solver->heapLength > 0)
+	{
+		solver->heap[0] = solver->heap[solver->heapLength];
+		heapDown(solver, 0);
+	}
+	return var;
+}
+
+/**
+ * This function raises the activity of a variable that took part in a conflict.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int var - the variable
+ * output :
+ * 		void
+ **/
+static void bumpActivity(SatSolver* solver, int var)
+{
+	solver->activity[var] += solver->activityIncrement;
+	if (solver->activity[var] > ACTIVITY_LIMIT)
+	{
+		int i;
+		for (i = 0; i < solver->numOfVars; i++)
+		{
+			solver->activity[i] *= ACTIVITY_RESCALE;
+		}
+		solver->activityIncrement *= ACTIVITY_RESCALE;
+	}
+	if (solver->heapIndex[var] != NO_VAR)
+	{
+		heapUp(solver, solver->heapIndex[var]);
+	}
+}
+
+/**
+ * This function makes a literal true at the current decision level.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int lit - the literal, which is not assigned
+ * 		int reason - the reason of the assignment
+ * output :
+ * 		void
+ **/
+static void assign(SatSolver* solver, int lit, int reason)
+{
+	int var = LIT_VAR(lit);
+	solver->values[lit] = LIT_TRUE;
+	solver->values[NOT(lit)] = LIT_FALSE;
+	solver->levels[var] = solver->levelStarts.length;
+	solver->reasons[var] = reason;
+	solver->trail[solver->trailLength] = lit;
+	solver->trailLength++;
+}
+
+/**
+ * This function unassigns the literals of the levels above a decision level, saving their
+ * phases and putting their variables back in the heap.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int level - the level to go back to
+ * output :
+ * 		void
+ **/
+static void backtrack(SatSolver* solver, int level)
+{
+	if (solver->levelStarts.length <= level)
+	{
+		return;
+	}
+	int start = solver->levelStarts.items[level];
+	int i;
+	for (i = solver->trailLength - 1; i >= start; i--)
+	{
+		int lit = solver->trail[i];
+		int var = LIT_VAR(lit);
+		solver->values[lit] = LIT_UNASSIGNED;
+		solver->values[NOT(lit)] = LIT_UNASSIGNED;
+		solver->reasons[var] = NO_REASON;
+		solver->polarity[var] = (char)LIT_NEGATIVE(lit);
+		heapInsert(solver, var);
+	}
+	solver->trailLength = start;
+	solver->propagated = start;
+	solver->levelStarts.length = level;
+}
+
+/**
+ * This function attaches a clause of the arena to the watches of its first two literals.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int ref - the clause
+ * output :
+ * 		1 if it was attached, 0 if memory allocation failed.
+ **/
+static int attachClause(SatSolver* solver, int ref)
+{
+	int* lits = CLAUSE_LITS(solver, ref);
+	SatWatch first = {ref, lits[1]};
+	SatWatch second = {ref, lits[0]};
+	return pushWatch(&solver->watches[lits[0]], first) && \
+		   pushWatch(&solver->watches[lits[1]], second);
+}
+
+/**
+ * This function adds a clause of at least two literals: a binary clause to the binary lists of
+ * its literals, a longer one to the arena and the watches of its first two literals.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		const int* lits - the literals
+ * 		int numOfLits - the number of literals, at least 2
+ * 		int lbd - the LBD of a learned clause, BOARD_CLAUSE_LBD for a clause of the board
+ * output :
+ * 		the offset of the clause in the arena, NO_REASON for a binary clause or if memory
+ * 		allocation failed (the solver's failed flag is then set).
+ **/
+static int addClause(SatSolver* solver, const int* lits, int numOfLits, int lbd)
+{
+	if (numOfLits == 2)
+	{
+		if (!pushInt(&solver->binaries[lits[0]], lits[1]) || \
+			!pushInt(&solver->binaries[lits[1]], lits[0]))
+		{
+			solver->failed = TRUE;
+		}
+		return NO_REASON;
+	}
+	if (solver->arenaLength + CLAUSE_HEADER + numOfLits > solver->arenaCapacity)
+	{
+		int capacity = (solver->arenaCapacity == 0) ? INITIAL_CAPACITY : solver->arenaCapacity;
+		while (solver->arenaLength + CLAUSE_HEADER + numOfLits > capacity)
+		{
+			capacity *= 2;
+		}
+		int* arena = (int*)realloc(solver->arena, capacity * sizeof(int));
+		if (arena == NULL)
+		{
+			solver->failed = TRUE;
+			return NO_REASON;
+		}
+		solver->arena = arena;
+		solver->arenaCapacity = capacity;
+	}
+	int ref = solver->arenaLength;
+	solver->arena[ref] = numOfLits;
+	solver->arena[ref + 1] = lbd;
+	memcpy(CLAUSE_LITS(solver, ref), lits, numOfLits * sizeof(int));
+	solver->arenaLength += CLAUSE_HEADER + numOfLits;
+	IntVector* clauses = (lbd == BOARD_CLAUSE_LBD) ? &solver->boardClauses : \
+						 &solver->learnedClauses;
+	if (!pushInt(clauses, ref) || !attachClause(solver, ref))
+	{
+		solver->failed = TRUE;
+	}
+	return ref;
+}
+
+/**
+ * This function propagates the assigned literals that were not propagated yet: every binary
+ * clause and every watched clause that has all its literals but one false makes the last one true.
+ * input :
+ * 		SatSolver* solver - the solver
+ * output :
+ * 		NO_CONFLICT, or the clause whose literals are all false: its offset in the arena, or
+ * 		BINARY_CONFLICT for the binary clause put in conflictLits.
+ **/
+static int propagate(SatSolver* solver)
+{
+	signed char* values = solver->values;
+	while (solver->propagated < solver->trailLength)
+	{
+		int falseLit = NOT(solver->trail[solver->propagated]);
+		solver->propagated++;
+		solver->stats->propagations++;
+		IntVector* binaries = &solver->binaries[falseLit];
+		int i, j;
+		for (i = 0; i < binaries->length; i++)
+		{
+			int other = binaries->items[i];
+			if (values[other] == LIT_FALSE)
+			{
+				solver->conflictLits[0] = falseLit;
+				solver->conflictLits[1] = other;
+				return BINARY_CONFLICT;
+			}
+			if (values[other] == LIT_UNASSIGNED)
+			{
+				assign(solver, other, BINARY_REASON(falseLit));
+			}
+		}
+		// the watches are compacted as they're visited: a clause that found another literal to
+		// watch leaves the list
+		WatchList* list = &solver->watches[falseLit];
+		SatWatch* watches = list->watches;
+		int length = list->length;
+		for (i = 0, j = 0; i < length;)
+		{
+			SatWatch watch = watches[i];
+			if (values[watch.blocker] == LIT_TRUE)
+			{
+				watches[j++] = watches[i++];
+				continue;
+			}
+			int* lits = CLAUSE_LITS(solver, watch.clause);
+			// the false literal is kept second, so the first one is the other watched literal
+			if (lits[0] == falseLit)
+			{
+				lits[0] = lits[1];
+				lits[1] = falseLit;
+			}
+			i++;
+			int first = lits[0];
+			SatWatch kept = {watch.clause, first};
+			if (first != watch.blocker && values[first] == LIT_TRUE)
+			{
+				watches[j++] = kept;
+				continue;
+			}
+			int size = CLAUSE_SIZE(solver, watch.clause);
+			int k;
+			for (k = 2; k < size; k++)
+			{
+				if (values[lits[k]] != LIT_FALSE)
+				{
+					lits[1] = lits[k];
+					lits[k] = falseLit;
+					if (!pushWatch(&solver->watches[lits[1]], kept))
+					{
+						solver->failed = TRUE;
+					}
+					break;
+				}
+			}
+			if (k < size)
+			{
+				continue;
+			}
+			// no other literal to watch, so the clause is unit or all false
+			watches[j++] = kept;
+			if (values[first] == LIT_FALSE)
+			{
+				while (i < length)
+				{
+					watches[j++] = watches[i++];
+				}
+				list->length = j;
+				return watch.clause;
+			}
+			assign(solver, first, watch.clause);
+		}
+		list->length = j;
+	}
+	return NO_CONFLICT;
+}
+
+/**
+ * This function gets the literals of a reason or a conflict that made the search assign a
+ * literal: for a clause that implied a literal, all its literals but the implied one.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int reason - the reason, or a conflict
+ * 		int implied - 1 if the reason implied a literal (which is then left out), 0 for a
+ * 		conflict
+ * 		int* binary - an array of two ints for the literals of a binary clause
+ * 		int* numOfLits - a pointer to put the number of literals in
+ * output :
+ * 		the literals
+ **/
+static const int* reasonLits(SatSolver* solver, int reason, int implied, int* binary, \
+							 int* numOfLits)
+{
+	if (reason == BINARY_CONFLICT)
+	{
+		*numOfLits = 2;
+		return solver->conflictLits;
+	}
+	if (reason < NO_REASON)
+	{
+		binary[0] = BINARY_LIT(reason);
+		*numOfLits = 1;
+		return binary;
+	}
+	*numOfLits = CLAUSE_SIZE(solver, reason) - implied;
+	return CLAUSE_LITS(solver, reason) + implied;
+}
+
+/**
+ * This function checks if a literal of a learned clause is implied by the others: if every
+ * literal of its reason is false at level 0, in the clause, or implied by them in turn. the
+ * literals of the clause are marked as seen, and so are the literals found to be implied, which
+ * are put in visited. a literal of a level none of the clause's literals are in can't be implied.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int lit - the literal, which has a reason
+ * 		unsigned int levels - the LEVEL_BIT of every level of the clause's literals
+ * output :
+ * 		1 if the literal is implied, else 0.
+ **/
+static int isRedundant(SatSolver* solver, int lit, unsigned int levels)
+{
+	IntVector* stack = &solver->visitStack;
+	int firstVisited = solver->visited.length;
+	int binary[1];
+	int numOfLits, i;
+	stack->length = 0;
+	if (!pushInt(stack, lit))
+	{
+		solver->failed = TRUE;
+		return FALSE;
+	}
+	while (stack->length > 0)
+	{
+		stack->length--;
+		int reason = solver->reasons[LIT_VAR(stack->items[stack->length])];
+		const int* lits = reasonLits(solver, reason, TRUE, binary, &numOfLits);
+		for (i = 0; i < numOfLits; i++)
+		{
+			int var = LIT_VAR(lits[i]);
+			if (solver->seen[var] || solver->levels[var] == 0)
+			{
+				continue;
+			}
+			if (solver->reasons[var] == NO_REASON || \
+				(LEVEL_BIT(solver->levels[var]) & levels) == 0)
+			{
+				// the literals marked by this check are not all implied, so their marks go
+				for (i = firstVisited; i < solver->visited.length; i++)
+				{
+					solver->seen[LIT_VAR(solver->visited.items[i])] = FALSE;
+				}
+				solver->visited.length = firstVisited;
+				return FALSE;
+			}
+			solver->seen[var] = TRUE;
+			if (!pushInt(stack, lits[i]) || !pushInt(&solver->visited, lits[i]))
+			{
+				solver->failed = TRUE;
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * This function learns a clause from a conflict: it resolves the conflict with the reasons of
+ * the literals of the current level, from the last assigned, until one literal of the level is
+ * left (the first UIP), then drops the literals implied by the others (see isRedundant). the
+ * clause is put in learned, with the negation of the first UIP first and a literal of the level
+ * to go back to second.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int conflict - the conflict
+ * 		int* lbd - a pointer to put the number of levels of the clause's literals in
+ * output :
+ * 		the level to go back to, the highest level of the clause but the current one (0 if the
+ * 		clause has one literal)
+ **/
+static int analyze(SatSolver* solver, int conflict, int* lbd)
+{
+	IntVector* learned = &solver->learned;
+	int level = solver->levelStarts.length;
+	int binary[1];
+	int pathCount = 0;
+	int lit = NO_LIT;
+	int index = solver->trailLength - 1;
+	int reason = conflict;
+	int i, j, numOfLits;
+	learned->length = 0;
+	*lbd = 0;
+	// the place of the first UIP
+	if (!pushInt(learned, NO_LIT))
+	{
+		solver->failed = TRUE;
+		return 0;
+	}
+	do
+	{
+		const int* lits = reasonLits(solver, reason, lit != NO_LIT, binary, &numOfLits);
+		for (i = 0; i < numOfLits; i++)
+		{
+			int var = LIT_VAR(lits[i]);
+			if (solver->seen[var] || solver->levels[var] == 0)
+			{
+				continue;
+			}
+			bumpActivity(solver, var);
+			solver->seen[var] = TRUE;
+			if (solver->levels[var] == level)
+			{
+				pathCount++;
+			}
+			else if (!pushInt(learned, lits[i]))
+			{
+				solver->failed = TRUE;
+			}
+		}
+		// the last assigned literal of the clause so far
+		while (!solver->seen[LIT_VAR(solver->trail[index])])
+		{
+			index--;
+		}
+		lit = solver->trail[index];
+		index--;
+		reason = solver->reasons[LIT_VAR(lit)];
+		solver->seen[LIT_VAR(lit)] = FALSE;
+		pathCount--;
+	} while (pathCount > 0);
+	learned->items[0] = NOT(lit);
+	// a literal implied by the other literals of the clause is dropped. the dropped literals are
+	// swapped to the end, and keep their marks until all the literals were checked
+	int length = learned->length;
+	unsigned int levels = 0;
+	for (i = 1; i < length; i++)
+	{
+		levels |= LEVEL_BIT(solver->levels[LIT_VAR(learned->items[i])]);
+	}
+	solver->visited.length = 0;
+	for (i = 1, j = 1; i < length; i++)
+	{
+		if (solver->reasons[LIT_VAR(learned->items[i])] == NO_REASON || \
+			!isRedundant(solver, learned->items[i], levels))
+		{
+			int temp = learned->items[j];
+			learned->items[j] = learned->items[i];
+			learned->items[i] = temp;
+			j++;
+		}
+	}
+	for (i = 1; i < length; i++)
+	{
+		solver->seen[LIT_VAR(learned->items[i])] = FALSE;
+	}
+	for (i = 0; i < solver->visited.length; i++)
+	{
+		solver->seen[LIT_VAR(solver->visited.items[i])] = FALSE;
+	}
+	learned->length = j;
+	// the level to go back to, with its literal second
+	int backLevel = 0;
+	int backIndex = 1;
+	for (i = 1; i < learned->length; i++)
+	{
+		int litLevel = solver->levels[LIT_VAR(learned->items[i])];
+		if (litLevel > backLevel)
+		{
+			backLevel = litLevel;
+			backIndex = i;
+		}
+	}
+	if (learned->length > 1)
+	{
+		int temp = learned->items[1];
+		learned->items[1] = learned->items[backIndex];
+		learned->items[backIndex] = temp;
+	}
+	// the LBD - the number of different levels
+	solver->stamp++;
+	for (i = 0; i < learned->length; i++)
+	{
+		int litLevel = solver->levels[LIT_VAR(learned->items[i])];
+		if (solver->levelStamps[litLevel] != solver->stamp)
+		{
+			solver->levelStamps[litLevel] = solver->stamp;
+			(*lbd)++;
+		}
+	}
+	return backLevel;
+}
+
+/**
+ * This function compares two learned clauses by their LBD and then by their size, for qsort.
+ * a key is the LBD, the size and the offset of a clause.
+ **/
+static int compareLearned(const void* first, const void* second)
+{
+	const int* a = (const int*)first;
+	const int* b = (const int*)second;
+	if (a[0] != b[0])
+	{
+		return a[0] - b[0];
+	}
+	return a[1] - b[1];
+}
+
+/**
+ * This function copies a clause to a new arena at level 0, without its false literals. a
+ * satisfied clause is dropped, and a clause left with two literals becomes a binary clause.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		int ref - the clause in the old arena
+ * 		int* arena - the new arena
+ * 		int* arenaLength - a pointer to the length of the new arena
+ * 		IntVector* clauses - the offsets of the clauses of its kind in the new arena
+ * output :
+ * 		void
+ **/
+static void copyClause(SatSolver* solver, int ref, int* arena, int* arenaLength, \
+					   IntVector* clauses)
+{
+	int* lits = CLAUSE_LITS(solver, ref);
+	int size = CLAUSE_SIZE(solver, ref);
+	int* newLits = arena + *arenaLength + CLAUSE_HEADER;
+	int i, numOfLits = 0;
+	for (i = 0; i < size; i++)
+	{
+		if (solver->values[lits[i]] == LIT_TRUE)
+		{
+			return;
+		}
+		if (solver->values[lits[i]] == LIT_UNASSIGNED)
+		{
+			newLits[numOfLits++] = lits[i];
+		}
+	}
+	// a clause left with one literal or none would have been propagated at level 0 already
+	if (numOfLits == 2)
+	{
+		if (!pushInt(&solver->binaries[newLits[0]], newLits[1]) || \
+			!pushInt(&solver->binaries[newLits[1]], newLits[0]))
+		{
+			solver->failed = TRUE;
+		}
+		return;
+	}
+	arena[*arenaLength] = numOfLits;
+	arena[*arenaLength + 1] = CLAUSE_LBD(solver, ref);
+	if (!pushInt(clauses, *arenaLength))
+	{
+		solver->failed = TRUE;
+	}
+	*arenaLength += CLAUSE_HEADER + numOfLits;
+}
+
+/**
+ * This function deletes the learned clauses with the highest LBD, but the ones with an LBD up to
+ * GLUE_LBD, and keeps half of the rest. it's called at level 0 with every assignment propagated,
+ * so every clause is copied to a new arena without its false literals, the satisfied ones are
+ * dropped, and the watches are made again.
+ * input :
+ * 		SatSolver* solver - the solver
+ * output :
+ * 		void
+ **/
+static void reduceLearned(SatSolver* solver)
+{
+	int numOfLearned = solver->learnedClauses.length;
+	int* keys = (int*)malloc(numOfLearned * 3 * sizeof(int));
+	int* arena = (int*)malloc(solver->arenaCapacity * sizeof(int));
+	if (keys == NULL || arena == NULL)
+	{
+		free(keys);
+		free(arena);
+		solver->failed = TRUE;
+		return;
+	}
+	int i;
+	for (i = 0; i < numOfLearned; i++)
+	{
+		int ref = solver->learnedClauses.items[i];
+		keys[3 * i] = CLAUSE_LBD(solver, ref);
+		keys[3 * i + 1] = CLAUSE_SIZE(solver, ref);
+		keys[3 * i + 2] = ref;
+	}
+	qsort(keys, numOfLearned, 3 * sizeof(int), compareLearned);
+	int numOfGlue = 0;
+	while (numOfGlue < numOfLearned && keys[3 * numOfGlue] <= GLUE_LBD)
+	{
+		numOfGlue++;
+	}
+	int numOfKept = numOfGlue + (numOfLearned - numOfGlue) / 2;
+	solver->stats->deleted += numOfLearned - numOfKept;
+	int arenaLength = 0;
+	int numOfBoard = solver->boardClauses.length;
+	solver->boardClauses.length = 0;
+	solver->learnedClauses.length = 0;
+	// the board's clauses are first in the old arena, so they can be copied in place of the old
+	// offsets list
+	for (i = 0; i < numOfBoard; i++)
+	{
+		copyClause(solver, solver->boardClauses.items[i], arena, &arenaLength, \
+				   &solver->boardClauses);
+	}
+	for (i = 0; i < numOfKept; i++)
+	{
+		copyClause(solver, keys[3 * i + 2], arena, &arenaLength, &solver->learnedClauses);
+	}
+	free(keys);
+	free(solver->arena);
+	solver->arena = arena;
+	solver->arenaLength = arenaLength;
+	for (i = 0; i < 2 * solver->numOfVars; i++)
+	{
+		solver->watches[i].length = 0;
+	}
+	for (i = 0; i < solver->boardClauses.length && !solver->failed; i++)
+	{
+		solver->failed = !attachClause(solver, solver->boardClauses.items[i]);
+	}
+	for (i = 0; i < solver->learnedClauses.length && !solver->failed; i++)
+	{
+		solver->failed = !attachClause(solver, solver->learnedClauses.items[i]);
+	}
+	// the reasons of level 0 are never looked at, and their clauses may be gone
+	for (i = 0; i < solver->trailLength; i++)
+	{
+		solver->reasons[LIT_VAR(solver->trail[i])] = NO_REASON;
+	}
+}
+
+/**
+ * This function returns a number of the Luby sequence: 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+ * input :
+ * 		int index - the index of the number, from 0
+ * output :
+ * 		the number
+ **/
+static int luby(int index)
+{
+	int size = 1, power = 0;
+	while (size < index + 1)
+	{
+		power++;
+		size = 2 * size + 1;
+	}
+	while (size - 1 != index)
+	{
+		size = (size - 1) / 2;
+		power--;
+		index = index % size;
+	}
+	return 1 << power;
+}
+
+/**
+ * This function searches for an assignment that satisfies every clause.
+ * input :
+ * 		SatSolver* solver - the solver, with its clauses added and the units of level 0 assigned
+ * output :
+ * 		SAT_SOLVED or SAT_NO_SOLUTION, SAT_UNKNOWN if memory allocation failed.
+ **/
+static int search(SatSolver* solver)
+{
+	SudukuSatStats* stats = solver->stats;
+	int restarts = 0;
+	long conflictsLeft = (long)RESTART_UNIT * luby(restarts);
+	long reduceInterval = FIRST_REDUCE;
+	long reduceLeft = reduceInterval;
+	while (!solver->failed)
+	{
+		int conflict = propagate(solver);
+		if (solver->failed)
+		{
+			break;
+		}
+		if (conflict != NO_CONFLICT)
+		{
+			stats->conflicts++;
+			conflictsLeft--;
+			reduceLeft--;
+			if (solver->levelStarts.length == 0)
+			{
+				return SAT_NO_SOLUTION;
+			}
+			int lbd;
+			int backLevel = analyze(solver, conflict, &lbd);
+			backtrack(solver, backLevel);
+			IntVector* learned = &solver->learned;
+			int reason = NO_REASON;
+			if (learned->length == 2)
+			{
+				addClause(solver, learned->items, learned->length, lbd);
+				reason = BINARY_REASON(learned->items[1]);
+			}
+			else if (learned->length > 2)
+			{
+				reason = addClause(solver, learned->items, learned->length, lbd);
+			}
+			if (!solver->failed)
+			{
+				assign(solver, learned->items[0], reason);
+			}
+			solver->activityIncrement /= VAR_DECAY;
+			continue;
+		}
+		// a restart, and the deletion of learned clauses, which happens at level 0 only
+		if (conflictsLeft <= 0 || reduceLeft <= 0)
+		{
+			backtrack(solver, 0);
+			if (propagate(solver) != NO_CONFLICT)
+			{
+				return SAT_NO_SOLUTION;
+			}
+			if (reduceLeft <= 0)
+			{
+				reduceLearned(solver);
+				reduceInterval += REDUCE_INCREMENT;
+				reduceLeft = reduceInterval;
+			}
+			if (conflictsLeft <= 0)
+			{
+				restarts++;
+				stats->restarts++;
+				conflictsLeft = (long)RESTART_UNIT * luby(restarts);
+			}
+			continue;
+		}
+		// the unassigned variable with the highest activity, with its saved phase
+		int var = NO_VAR;
+		while (solver->heapLength > 0 && var == NO_VAR)
+		{
+			var = heapRemoveMax(solver);
+			if (solver->values[MAKE_LIT(var, 0)] != LIT_UNASSIGNED)
+			{
+				var = NO_VAR;
+			}
+		}
+		if (var == NO_VAR)
+		{
+			return SAT_SOLVED;
+		}
+		stats->decisions++;
+		if (!pushInt(&solver->levelStarts, solver->trailLength))
+		{
+			break;
+		}
+		assign(solver, MAKE_LIT(var, solver->polarity[var]), NO_REASON);
+	}
+	return SAT_UNKNOWN;
+}
+
+/**
+ * This function returns the slot of a unit of the board.
+ * input :
+ * 		SudukuBoardStruct* suduku - the board
+ * 		int type - 0 for a row, 1 for a col, 2 for a little board
+ * 		int unit - the index of the unit
+ * 		int k - the index of the slot in the unit
+ * output :
+ * 		the slot, as row * size + col
+ **/
+static int unitSlot(SudukuBoardStruct* suduku, int type, int unit, int k)
+{
+	int size = suduku->size;
+	int boxSize = suduku->boxSize;
+	if (type == 0)
+	{
+		return unit * size + k;
+	}
+	if (type == 1)
+	{
+		return k * size + unit;
+	}
+	return ((unit / boxSize) * boxSize + k / boxSize) * size + (unit % boxSize) * boxSize + \
+		   k % boxSize;
+}
+
+/**
+ * This function returns the variable of a digit of an empty slot: the slot's first variable plus
+ * the number of its legal digits below the digit.
+ * input :
+ * 		SudukuBoardStruct* suduku - the board
+ * 		int* firstVars - the first variable of every slot, NO_VAR for a filled slot
+ * 		SudukuMask* candidates - the legal digits of every slot, maskWords words per slot
+ * 		int slot - the slot
+ * 		int digit - the digit
+ * output :
+ * 		the variable, NO_VAR if the slot is filled or the digit is not legal in it.
+ **/
+static int slotVar(SudukuBoardStruct* suduku, int* firstVars, SudukuMask* candidates, int slot, \
+				   int digit)
+{
+	if (firstVars[slot] == NO_VAR)
+	{
+		return NO_VAR;
+	}
+	SudukuMask* words = candidates + slot * suduku->maskWords;
+	int word = (digit - 1) / SUDUKU_MASK_BITS;
+	int bit = (digit - 1) % SUDUKU_MASK_BITS;
+	if (((words[word] >> bit) & 1) == 0)
+	{
+		return NO_VAR;
+	}
+	int rank = __builtin_popcountll(words[word] & (((SudukuMask)1 << bit) - 1));
+	int i;
+	for (i = 0; i < word; i++)
+	{
+		rank += __builtin_popcountll(words[i]);
+	}
+	return firstVars[slot] + rank;
+}
+
+/**
+ * This function adds a constraint that exactly one of some variables is true: a clause of all of
+ * them and a binary clause for every two. a constraint with one variable makes it a unit.
+ * input :
+ * 		SatSolver* solver - the solver
+ * 		IntVector* lits - the positive literals of the variables
+ * 		IntVector* units - the units to assign once all the clauses are added
+ * output :
+ * 		0 if there are no variables, so the board has no solution, else 1.
+ **/
+static int addExactlyOne(SatSolver* solver, IntVector* lits, IntVector* units)
+{
+	int i, j;
+	if (lits->length == 0)
+	{
+		return FALSE;
+	}
+	if (lits->length == 1)
+	{
+		solver->failed = solver->failed || !pushInt(units, lits->items[0]);
+		return TRUE;
+	}
+	addClause(solver, lits->items, lits->length, BOARD_CLAUSE_LBD);
+	solver->stats->clauses++;
+	for (i = 0; i < lits->length; i++)
+	{
+		for (j = i + 1; j < lits->length; j++)
+		{
+			int pair[2] = {NOT(lits->items[i]), NOT(lits->items[j])};
+			addClause(solver, pair, 2, BOARD_CLAUSE_LBD);
+			solver->stats->clauses++;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * This function frees the memory of a solver.
+ * input :
+ * 		SatSolver* solver - the solver
+ * output :
+ * 		void
+ **/
+static void freeSolver(SatSolver* solver)
+{
+	int i;
+	for (i = 0; i < 2 * solver->numOfVars; i++)
+	{
+		if (solver->binaries != NULL)
+		{
+			free(solver->binaries[i].items);
+		}
+		if (solver->watches != NULL)
+		{
+			free(solver->watches[i].watches);
+		}
+	}
+	free(solver->binaries);
+	free(solver->watches);
+	free(solver->values);
+	free(solver->levels);
+	free(solver->reasons);
+	free(solver->activity);
+	free(solver->polarity);
+	free(solver->seen);
+	free(solver->heapIndex);
+	free(solver->heap);
+	free(solver->trail);
+	free(solver->levelStamps);
+	free(solver->arena);
+	free(solver->boardClauses.items);
+	free(solver->learnedClauses.items);
+	free(solver->levelStarts.items);
+	free(solver->learned.items);
+	free(solver->visitStack.items);
+	free(solver->visited.items);
+}
+
+/**
+ * This function solves a suduku board with a conflict driven clause learning SAT solver. every
+ * legal digit of every empty slot is a variable, and the clauses are: every empty slot has at
+ * least one of its digits and no two of them, and every digit missing in a row, col or little
+ * board is in at least one of its empty slots that can take it and in no two of them. the solver
+ * propagates with two watched literals (binary clauses are kept in lists of their own), branches
+ * on the variable with the highest VSIDS activity with its saved phase, learns a first UIP clause
+ * from every conflict, restarts by the Luby sequence and deletes half of the learned clauses with
+ * the highest LBD from time to time. every decision is counted in the context's nodesExpanded.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct with its used digits sets built. it's filled
+ * 		with the solution if there is one, else left as it was
+ * 		SudukuSatStats* stats - a struct to put the statistics of the solve in, NULL if they're
+ * 		not needed
+ * output :
+ * 		1 if the board was solved, 0 if it has no solution, SUDUKU_SAT_FAILED if memory
+ * 		allocation failed.
+ **/
+int solveSudukuSat(SudukuBoardStruct* suduku, SudukuSatStats* stats)
+{
+	SudukuSatStats localStats;
+	if (stats == NULL)
+	{
+		stats = &localStats;
+	}
+	memset(stats, 0, sizeof(SudukuSatStats));
+	int size = suduku->size;
+	int numOfSlots = size * size;
+	int slot, digit, i;
+	// a variable for every legal digit of every empty slot, in the order of the slots
+	int* firstVars = (int*)malloc(numOfSlots * sizeof(int));
+	SudukuMask* candidates = (SudukuMask*)malloc(numOfSlots * suduku->maskWords * \
+												 sizeof(SudukuMask));
+	if (firstVars == NULL || candidates == NULL)
+	{
+		free(firstVars);
+		free(candidates);
+		return SUDUKU_SAT_FAILED;
+	}
+	int numOfVars = 0;
+	for (slot = 0; slot < numOfSlots; slot++)
+	{
+		firstVars[slot] = NO_VAR;
+		if (suduku->board[slot] == EMPTY_SLOT)
+		{
+			firstVars[slot] = numOfVars;
+			numOfVars += getSudukuCandidates(suduku, slot / size, slot % size, \
+											 candidates + slot * suduku->maskWords);
+		}
+	}
+	stats->variables = numOfVars;
+	SatSolver solver;
+	memset(&solver, 0, sizeof(SatSolver));
+	solver.numOfVars = numOfVars;
+	solver.stats = stats;
+	solver.activityIncrement = 1.0;
+	solver.binaries = (IntVector*)calloc(2 * numOfVars + 1, sizeof(IntVector));
+	solver.watches = (WatchList*)calloc(2 * numOfVars + 1, sizeof(WatchList));
+	solver.values = (signed char*)calloc(2 * numOfVars + 1, sizeof(signed char));
+	solver.levels = (int*)calloc(numOfVars + 1, sizeof(int));
+	solver.reasons = (int*)malloc((numOfVars + 1) * sizeof(int));
+	solver.activity = (double*)calloc(numOfVars + 1, sizeof(double));
+	// every variable starts false, as all the digits but one of every slot are
+	solver.polarity = (char*)malloc(numOfVars + 1);
+	solver.seen = (char*)calloc(numOfVars + 1, sizeof(char));
+	solver.heapIndex = (int*)malloc((numOfVars + 1) * sizeof(int));
+	solver.heap = (int*)malloc((numOfVars + 1) * sizeof(int));
+	solver.trail = (int*)malloc((numOfVars + 1) * sizeof(int));
+	solver.levelStamps = (unsigned int*)calloc(numOfVars + 2, sizeof(unsigned int));
+	int result = SAT_UNKNOWN;
+	IntVector lits = {NULL, 0, 0};
+	IntVector units = {NULL, 0, 0};
+	if (solver.binaries != NULL && solver.watches != NULL && solver.values != NULL && \
+		solver.levels != NULL && solver.reasons != NULL && solver.activity != NULL && \
+		solver.polarity != NULL && solver.seen != NULL && solver.heapIndex != NULL && \
+		solver.heap != NULL && solver.trail != NULL && solver.levelStamps != NULL)
+	{
+		int var;
+		for (var = 0; var < numOfVars; var++)
+		{
+			solver.reasons[var] = NO_REASON;
+			solver.polarity[var] = TRUE;
+			solver.heap[var] = var;
+			solver.heapIndex[var] = var;
+		}
+		solver.heapLength = numOfVars;
+		int consistent = TRUE;
+		// every empty slot has exactly one of its legal digits
+		for (slot = 0; slot < numOfSlots && consistent; slot++)
+		{
+			if (firstVars[slot] == NO_VAR)
+			{
+				continue;
+			}
+			lits.length = 0;
+			for (digit = 1; digit <= size; digit++)
+			{
+				var = slotVar(suduku, firstVars, candidates, slot, digit);
+				if (var != NO_VAR)
+				{
+					solver.failed = solver.failed || !pushInt(&lits, MAKE_LIT(var, 0));
+				}
+			}
+			consistent = addExactlyOne(&solver, &lits, &units);
+		}
+		// every digit missing in a unit is in exactly one of the unit's empty slots
+		SudukuMask* usedSets[UNIT_TYPES] = {suduku->rowUsed, suduku->colUsed, suduku->boxUsed};
+		int type, unit, k;
+		for (type = 0; type < UNIT_TYPES && consistent; type++)
+		{
+			for (unit = 0; unit < size && consistent; unit++)
+			{
+				for (digit = 1; digit <= size && consistent; digit++)
+				{
+					SudukuMask word = usedSets[type][unit * suduku->maskWords + \
+													 (digit - 1) / SUDUKU_MASK_BITS];
+					if ((word >> ((digit - 1) % SUDUKU_MASK_BITS)) & 1)
+					{
+						continue;
+					}
+					lits.length = 0;
+					for (k = 0; k < size; k++)
+					{
+						var = slotVar(suduku, firstVars, candidates, \
+									  unitSlot(suduku, type, unit, k), digit);
+						if (var != NO_VAR)
+						{
+							solver.failed = solver.failed || !pushInt(&lits, MAKE_LIT(var, 0));
+						}
+					}
+					consistent = addExactlyOne(&solver, &lits, &units);
+				}
+			}
+		}
+		// the units of the board are the first assignments of level 0
+		for (i = 0; i < units.length && consistent; i++)
+		{
+			int lit = units.items[i];
+			if (solver.values[lit] == LIT_FALSE)
+			{
+				consistent = FALSE;
+			}
+			else if (solver.values[lit] == LIT_UNASSIGNED)
+			{
+				assign(&solver, lit, NO_REASON);
+			}
+		}
+		if (solver.failed)
+		{
+			result = SAT_UNKNOWN;
+		}
+		else if (!consistent)
+		{
+			result = SAT_NO_SOLUTION;
+		}
+		else
+		{
+			result = search(&solver);
+		}
+	}
+	if (result == SAT_SOLVED)
+	{
+		for (slot = 0; slot < numOfSlots; slot++)
+		{
+			for (digit = 1; digit <= size; digit++)
+			{
+				int var = slotVar(suduku, firstVars, candidates, slot, digit);
+				if (var != NO_VAR && solver.values[MAKE_LIT(var, 0)] == LIT_TRUE)
+				{
+					setSudukuSlot(suduku, slot / size, slot % size, digit);
+				}
+			}
+		}
+	}
+	suduku->context->nodesExpanded += stats->decisions;
+	free(lits.items);
+	free(units.items);
+	freeSolver(&solver);
+	free(firstVars);
+	free(candidates);
+	if (result == SAT_UNKNOWN)
+	{
+		return SUDUKU_SAT_FAILED;
+	}
+	return result == SAT_SOLVED;
+}
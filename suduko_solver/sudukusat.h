@@ -0,0 +1,62 @@
+/**
+ ===================================================================================================
+ Name        : sudukusat.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukusat.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukusat_H
+#define sudukusat_H
+
+#include "sudukutree.h"
+
+//********      consts
+// the board could not be solved, since memory allocation failed
+#define SUDUKU_SAT_FAILED -1
+
+//********      structs
+/**
+ * struct for the statistics of a SAT solve.
+ * int variables - the number of variables: a (slot, digit) pair for every legal digit of every
+ * empty slot
+ * unsigned long clauses - the number of clauses of the board, binary ones included
+ * unsigned long decisions - the number of variables the search picked a value for
+ * unsigned long conflicts - the number of conflicts, which is the number of learned clauses
+ * unsigned long propagations - the number of assignments whose clauses were visited
+ * unsigned long restarts - the number of times the search went back to the top
+ * unsigned long deleted - the number of learned clauses that were deleted
+ **/
+typedef struct SudukuSatStats
+{
+	int variables;
+	unsigned long clauses;
+	unsigned long decisions;
+	unsigned long conflicts;
+	unsigned long propagations;
+	unsigned long restarts;
+	unsigned long deleted;
+}SudukuSatStats;
+
+//********      functions
+/**
+ * This function solves a suduku board with a conflict driven clause learning SAT solver. every
+ * legal digit of every empty slot is a variable, and the clauses are: every empty slot has at
+ * least one of its digits and no two of them, and every digit missing in a row, col or little
+ * board is in at least one of its empty slots that can take it and in no two of them. the solver
+ * propagates with two watched literals (binary clauses are kept in lists of their own), branches
+ * on the variable with the highest VSIDS activity with its saved phase, learns a first UIP clause
+ * from every conflict, restarts by the Luby sequence and deletes half of the learned clauses with
+ * the highest LBD from time to time. every decision is counted in the context's nodesExpanded.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct with its used digits sets built. it's filled
+ * 		with the solution if there is one, else left as it was
+ * 		SudukuSatStats* stats - a struct to put the statistics of the solve in, NULL if they're
+ * 		not needed
+ * output :
+ * 		1 if the board was solved, 0 if it has no solution, SUDUKU_SAT_FAILED if memory
+ * 		allocation failed.
+ **/
+int solveSudukuSat(SudukuBoardStruct* suduku, SudukuSatStats* stats);
+
+#endif // sudukusat_H
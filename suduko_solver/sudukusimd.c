@@ -0,0 +1,378 @@
+/**
+ ===================================================================================================
+ Name        : sudukusimd.c
+ Author      : Yinnon Bratspiess
+ Description : This file implements vectorized kernels for small suduku boards: the legal digits
+ * 			   of all the slots in one pass, and the number of filled slots. the kernel level
+ * 			   (plain C, SSE2 or AVX2) is picked at run time by what the processor supports.
+ ===================================================================================================
+ **/
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "sudukutree.h"
+#include "sudukusimd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define X86_KERNELS 1
+#endif
+
+// -------------------------- const definitions -------------------------
+#define EMPTY_SLOT 0
+#define NOT_PICKED -1
+// the most little boards in a row of little boards (a band) of a board up to SUDUKU_SIMD_MAX_SIZE
+#define MAX_BANDS 4
+#define SSE2_BYTES 16
+#define AVX2_BYTES 32
+#define SSE2_LANES 8
+
+// -------------------------- structs -----------------------------------
+/**
+ * the used digits sets of a board up to SUDUKU_SIMD_MAX_SIZE, in 16 bit lanes padded with 0, so a
+ * kernel can load the sets of all the cols, or of the little boards under all the cols, at once.
+ **/
+typedef struct SmallBoardSets
+{
+	uint16_t rows[SUDUKU_SIMD_MAX_SIZE];
+	uint16_t cols[SUDUKU_SIMD_MAX_SIZE];
+	// bandBoxes[band][col] is the set of the little board of the band that holds col
+	uint16_t bandBoxes[MAX_BANDS][SUDUKU_SIMD_MAX_SIZE];
+	// the sets of all the digits of the board
+	uint16_t full;
+}SmallBoardSets;
+
+// ------------------------------ globals -------------------------------
+// the kernel level in use, picked on the first call. it's atomic since the first calls may come
+// from several threads at once (they all pick the same level)
+static atomic_int simdLevel = NOT_PICKED;
+
+// ------------------------------ functions -----------------------------
+/**
+ * This function returns the best kernel level the processor supports.
+ * input :
+ * 		void
+ * output :
+ * 		one of the SUDUKU_SIMD_ levels
+ **/
+static int supportedSimdLevel(void)
+{
+#ifdef X86_KERNELS
+	__builtin_cpu_init();
+	// the compiler may count bits with popcnt in the AVX2 kernels, since it comes with AVX2
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+	{
+		return SUDUKU_SIMD_AVX2;
+	}
+	if (__builtin_cpu_supports("sse2"))
+	{
+		return SUDUKU_SIMD_SSE2;
+	}
+#endif
+	return SUDUKU_SIMD_SCALAR;
+}
+
+/**
+ * This function returns the kernel level the functions of this file use. the first call picks the
+ * best level the processor supports.
+ * input :
+ * 		void
+ * output :
+ * 		one of the SUDUKU_SIMD_ levels
+ **/
+int getSudukuSimdLevel(void)
+{
+	int level = atomic_load_explicit(&simdLevel, memory_order_relaxed);
+	if (level == NOT_PICKED)
+	{
+		level = supportedSimdLevel();
+		atomic_store_explicit(&simdLevel, level, memory_order_relaxed);
+	}
+	return level;
+}
+
+/**
+ * This function sets the kernel level the functions of this file use, for benchmarks and tests.
+ * a level the processor (or the build) doesn't support is lowered to the best supported one.
+ * input :
+ * 		int level - one of the SUDUKU_SIMD_ levels
+ * output :
+ * 		the level that was set
+ **/
+int setSudukuSimdLevel(int level)
+{
+	int supported = supportedSimdLevel();
+	level = (level < supported) ? level : supported;
+	atomic_store_explicit(&simdLevel, level, memory_order_relaxed);
+	return level;
+}
+
+/**
+ * This function copies the used digits sets of a board into 16 bit lanes.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct of size up to SUDUKU_SIMD_MAX_SIZE
+ * 		SmallBoardSets* sets - the struct to fill
+ * output :
+ * 		void
+ **/
+static void gatherSets(SudukuBoardStruct* suduku, SmallBoardSets* sets)
+{
+	int i, band;
+	memset(sets, 0, sizeof(SmallBoardSets));
+	for (i = 0; i < suduku->size; i++)
+	{
+		sets->rows[i] = (uint16_t)suduku->rowUsed[i];
+		sets->cols[i] = (uint16_t)suduku->colUsed[i];
+	}
+	for (band = 0; band < suduku->boxSize; band++)
+	{
+		for (i = 0; i < suduku->size; i++)
+		{
+			sets->bandBoxes[band][i] = (uint16_t)suduku->boxUsed[band * suduku->boxSize + \
+																 i / suduku->boxSize];
+		}
+	}
+	sets->full = (uint16_t)((1u << suduku->size) - 1);
+}
+
+/**
+ * This function returns a pointer to SUDUKU_SIMD_MAX_SIZE bytes that start with a row of slots,
+ * so a kernel can load the whole row at once. the bytes after the row are the next rows, or a
+ * zero padded copy of the row near the end of the board, so nothing past the board is read.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct of size up to SUDUKU_SIMD_MAX_SIZE
+ * 		int row - the row
+ * 		SudukuCell* padded - an array of SUDUKU_SIMD_MAX_SIZE bytes for the copy
+ * output :
+ * 		the bytes of the row
+ **/
+static SudukuCell* paddedRow(SudukuBoardStruct* suduku, int row, SudukuCell* padded)
+{
+	if (row * suduku->size + SUDUKU_SIMD_MAX_SIZE <= suduku->size * suduku->size)
+	{
+		return suduku->board + row * suduku->size;
+	}
+	memset(padded, 0, SUDUKU_SIMD_MAX_SIZE);
+	memcpy(padded, suduku->board + row * suduku->size, suduku->size);
+	return padded;
+}
+
+/**
+ * This function is the plain C kernel of getSudukuCandidateMasks.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct of size up to SUDUKU_SIMD_MAX_SIZE
+ * 		SmallBoardSets* sets - its sets
+ * 		uint16_t* candidates - an array of size * SUDUKU_SIMD_MAX_SIZE sets to put the sets in
+ * output :
+ * 		void
+ **/
+static void candidatesScalar(SudukuBoardStruct* suduku, SmallBoardSets* sets, uint16_t* candidates)
+{
+	int row, col;
+	for (row = 0; row < suduku->size; row++)
+	{
+		uint16_t* bandBoxes = sets->bandBoxes[row / suduku->boxSize];
+		for (col = 0; col < suduku->size; col++)
+		{
+			candidates[row * SUDUKU_SIMD_MAX_SIZE + col] = \
+				(suduku->board[row * suduku->size + col] != EMPTY_SLOT) ? 0 : \
+				(uint16_t)(sets->full & ~(sets->rows[row] | sets->cols[col] | bandBoxes[col]));
+		}
+	}
+}
+
+/**
+ * This function is the plain C kernel of countSudukuFilledSlots.
+ * input :
+ * 		SudukuCell* slots - the slots
+ * 		int numOfSlots - the number of slots
+ * output :
+ * 		the number of slots that are not 0
+ **/
+static int countScalar(SudukuCell* slots, int numOfSlots)
+{
+	int i, counter = 0;
+	for (i = 0; i < numOfSlots; i++)
+	{
+		counter += (slots[i] != EMPTY_SLOT);
+	}
+	return counter;
+}
+
+#ifdef X86_KERNELS
+/**
+ * This function is the SSE2 kernel of getSudukuCandidateMasks. every row is two vectors of 8 sets.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct of size up to SUDUKU_SIMD_MAX_SIZE
+ * 		SmallBoardSets* sets - its sets
+ * 		uint16_t* candidates - an array of size * SUDUKU_SIMD_MAX_SIZE sets to put the sets in
+ * output :
+ * 		void
+ **/
+__attribute__((target("sse2")))
+static void candidatesSse2(SudukuBoardStruct* suduku, SmallBoardSets* sets, uint16_t* candidates)
+{
+	SudukuCell padded[SUDUKU_SIMD_MAX_SIZE];
+	__m128i zero = _mm_setzero_si128();
+	__m128i full = _mm_set1_epi16((short)sets->full);
+	__m128i colsLow = _mm_loadu_si128((__m128i*)sets->cols);
+	__m128i colsHigh = _mm_loadu_si128((__m128i*)(sets->cols + SSE2_LANES));
+	int row;
+	for (row = 0; row < suduku->size; row++)
+	{
+		uint16_t* bandBoxes = sets->bandBoxes[row / suduku->boxSize];
+		__m128i rowSet = _mm_set1_epi16((short)sets->rows[row]);
+		__m128i cells = _mm_loadu_si128((__m128i*)paddedRow(suduku, row, padded));
+		// used = row | col | little board, and only the empty slots keep their candidates
+		__m128i usedLow = _mm_or_si128(_mm_or_si128(rowSet, colsLow), \
+									   _mm_loadu_si128((__m128i*)bandBoxes));
+		__m128i usedHigh = _mm_or_si128(_mm_or_si128(rowSet, colsHigh), \
+										_mm_loadu_si128((__m128i*)(bandBoxes + SSE2_LANES)));
+		__m128i emptyLow = _mm_cmpeq_epi16(_mm_unpacklo_epi8(cells, zero), zero);
+		__m128i emptyHigh = _mm_cmpeq_epi16(_mm_unpackhi_epi8(cells, zero), zero);
+		uint16_t* rowCandidates = candidates + row * SUDUKU_SIMD_MAX_SIZE;
+		_mm_storeu_si128((__m128i*)rowCandidates, \
+						 _mm_and_si128(_mm_andnot_si128(usedLow, full), emptyLow));
+		_mm_storeu_si128((__m128i*)(rowCandidates + SSE2_LANES), \
+						 _mm_and_si128(_mm_andnot_si128(usedHigh, full), emptyHigh));
+	}
+}
+
+/**
+ * This function is the AVX2 kernel of getSudukuCandidateMasks. every row is one vector of 16 sets.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct of size up to SUDUKU_SIMD_MAX_SIZE
+ * 		SmallBoardSets* sets - its sets
+ * 		uint16_t* candidates - an array of size * SUDUKU_SIMD_MAX_SIZE sets to put the sets in
+ * output :
+ * 		void
+ **/
+__attribute__((target("avx2")))
+static void candidatesAvx2(SudukuBoardStruct* suduku, SmallBoardSets* sets, uint16_t* candidates)
+{
+	SudukuCell padded[SUDUKU_SIMD_MAX_SIZE];
+	__m256i zero = _mm256_setzero_si256();
+	__m256i full = _mm256_set1_epi16((short)sets->full);
+	__m256i cols = _mm256_loadu_si256((__m256i*)sets->cols);
+	int row;
+	for (row = 0; row < suduku->size; row++)
+	{
+		__m256i boxes = _mm256_loadu_si256((__m256i*)sets->bandBoxes[row / suduku->boxSize]);
+		__m256i used = _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi16((short)sets->rows[row]), \
+													   cols), boxes);
+		__m256i cells = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i*)paddedRow(suduku, row, \
+																				  padded)));
+		__m256i empty = _mm256_cmpeq_epi16(cells, zero);
+		_mm256_storeu_si256((__m256i*)(candidates + row * SUDUKU_SIMD_MAX_SIZE), \
+							_mm256_and_si256(_mm256_andnot_si256(used, full), empty));
+	}
+}
+
+/**
+ * This function is the SSE2 kernel of countSudukuFilledSlots: 16 slots compared with 0 at a time.
+ * input :
+ * 		SudukuCell* slots - the slots
+ * 		int numOfSlots - the number of slots
+ * output :
+ * 		the number of slots that are not 0
+ **/
+__attribute__((target("sse2")))
+static int countSse2(SudukuCell* slots, int numOfSlots)
+{
+	__m128i zero = _mm_setzero_si128();
+	int i, empty = 0;
+	for (i = 0; i + SSE2_BYTES <= numOfSlots; i += SSE2_BYTES)
+	{
+		__m128i cells = _mm_loadu_si128((__m128i*)(slots + i));
+		empty += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(cells, zero)));
+	}
+	return (i - empty) + countScalar(slots + i, numOfSlots - i);
+}
+
+/**
+ * This function is the AVX2 kernel of countSudukuFilledSlots: 32 slots compared with 0 at a time.
+ * input :
+ * 		SudukuCell* slots - the slots
+ * 		int numOfSlots - the number of slots
+ * output :
+ * 		the number of slots that are not 0
+ **/
+__attribute__((target("avx2")))
+static int countAvx2(SudukuCell* slots, int numOfSlots)
+{
+	__m256i zero = _mm256_setzero_si256();
+	int i, empty = 0;
+	for (i = 0; i + AVX2_BYTES <= numOfSlots; i += AVX2_BYTES)
+	{
+		__m256i cells = _mm256_loadu_si256((__m256i*)(slots + i));
+		empty += __builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(cells, zero)));
+	}
+	// the rest is shorter than a vector, so up to 16 of it are counted with one SSE2 step
+	if (i + SSE2_BYTES <= numOfSlots)
+	{
+		__m128i cells = _mm_loadu_si128((__m128i*)(slots + i));
+		empty += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(cells, \
+																	 _mm_setzero_si128())));
+		i += SSE2_BYTES;
+	}
+	return (i - empty) + countScalar(slots + i, numOfSlots - i);
+}
+#endif
+
+/**
+ * This function calculates in one pass the legal digits of every slot of a board of size up to
+ * SUDUKU_SIMD_MAX_SIZE: bit (num - 1) of a slot's set is on if num is not used in the slot's row,
+ * col or little board. the set of a filled slot is 0.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct of size up to SUDUKU_SIMD_MAX_SIZE
+ * 		uint16_t* candidates - an array of size * SUDUKU_SIMD_MAX_SIZE sets to put the sets in.
+ * 		the set of the slot (row, col) is put in candidates[row * SUDUKU_SIMD_MAX_SIZE + col], the
+ * 		sets past col size - 1 of a row are scratch
+ * output :
+ * 		void
+ **/
+void getSudukuCandidateMasks(SudukuBoardStruct* suduku, uint16_t* candidates)
+{
+	SmallBoardSets sets;
+	gatherSets(suduku, &sets);
+	switch (getSudukuSimdLevel())
+	{
+#ifdef X86_KERNELS
+		case SUDUKU_SIMD_AVX2:
+			candidatesAvx2(suduku, &sets, candidates);
+			break;
+		case SUDUKU_SIMD_SSE2:
+			candidatesSse2(suduku, &sets, candidates);
+			break;
+#endif
+		default:
+			candidatesScalar(suduku, &sets, candidates);
+			break;
+	}
+}
+
+/**
+ * This function counts the slots of a board that are not empty. it works for any size.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * output :
+ * 		the number of slots that are not 0
+ **/
+int countSudukuFilledSlots(SudukuBoardStruct* suduku)
+{
+	int numOfSlots = suduku->size * suduku->size;
+	switch (getSudukuSimdLevel())
+	{
+#ifdef X86_KERNELS
+		case SUDUKU_SIMD_AVX2:
+			return countAvx2(suduku->board, numOfSlots);
+		case SUDUKU_SIMD_SSE2:
+			return countSse2(suduku->board, numOfSlots);
+#endif
+		default:
+			return countScalar(suduku->board, numOfSlots);
+	}
+}
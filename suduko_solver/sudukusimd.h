@@ -0,0 +1,67 @@
+/**
+ ===================================================================================================
+ Name        : sudukusimd.h
+ Author      : Yinnon Bratspiess
+ Description : This is the header for sudukusimd.c
+ ===================================================================================================
+ **/
+
+#ifndef sudukusimd_H
+#define sudukusimd_H
+
+#include <stdint.h>
+#include "sudukutree.h"
+
+//********      consts
+// the biggest board the candidate kernels handle: every candidates set fits in 16 bits
+#define SUDUKU_SIMD_MAX_SIZE 16
+// the kernel levels, from the plain C fallback to the widest vectors
+#define SUDUKU_SIMD_SCALAR 0
+#define SUDUKU_SIMD_SSE2 1
+#define SUDUKU_SIMD_AVX2 2
+
+//********      functions
+/**
+ * This function returns the kernel level the functions of this file use. the first call picks the
+ * best level the processor supports.
+ * input :
+ * 		void
+ * output :
+ * 		one of the SUDUKU_SIMD_ levels
+ **/
+int getSudukuSimdLevel(void);
+
+/**
+ * This function sets the kernel level the functions of this file use, for benchmarks and tests.
+ * a level the processor (or the build) doesn't support is lowered to the best supported one.
+ * input :
+ * 		int level - one of the SUDUKU_SIMD_ levels
+ * output :
+ * 		the level that was set
+ **/
+int setSudukuSimdLevel(int level);
+
+/**
+ * This function calculates in one pass the legal digits of every slot of a board of size up to
+ * SUDUKU_SIMD_MAX_SIZE: bit (num - 1) of a slot's set is on if num is not used in the slot's row,
+ * col or little board. the set of a filled slot is 0.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct of size up to SUDUKU_SIMD_MAX_SIZE
+ * 		uint16_t* candidates - an array of size * SUDUKU_SIMD_MAX_SIZE sets to put the sets in.
+ * 		the set of the slot (row, col) is put in candidates[row * SUDUKU_SIMD_MAX_SIZE + col], the
+ * 		sets past col size - 1 of a row are scratch
+ * output :
+ * 		void
+ **/
+void getSudukuCandidateMasks(SudukuBoardStruct* suduku, uint16_t* candidates);
+
+/**
+ * This function counts the slots of a board that are not empty. it works for any size.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * output :
+ * 		the number of slots that are not 0
+ **/
+int countSudukuFilledSlots(SudukuBoardStruct* suduku);
+
+#endif // sudukusimd_H
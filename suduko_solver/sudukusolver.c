@@ -9,177 +9,103 @@
 #include <stdio.h>
 #include <string.h> 
 #include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
 #include "genericdfs.h"
 #include "sudukutree.h"
+#include "sudukudlx.h"
+#include "sudukusat.h"
+#include "sudukubatch.h"
+#include "sudukugenerator.h"
+#include "sudukufixed.h"
+#include "sudukuloader.h"
+#include "sudukuportfolio.h"
+#include "sudukudaemon.h"
 
 // -------------------------- const definitions -------------------------
-#define LEGAL_COMMAND_LINE_SIZE 2
+// command line options
+#define NO_PROPAGATION_OPTION "--no-propagation"
+#define NODES_OPTION "--nodes"
+#define DLX_OPTION "--dlx"
+#define SAT_OPTION "--sat"
+#define THREADS_OPTION "--threads"
+#define BATCH_OPTION "--batch"
+#define BEST_FIRST_OPTION "--best-first"
+#define MAX_NODES_OPTION "--max-nodes"
+#define BEAM_OPTION "--beam"
+#define TABLE_OPTION "--table"
+#define COUNT_OPTION "--count"
+#define GENERATE_OPTION "--generate"
+#define SIZE_OPTION "--size"
+#define CLUES_OPTION "--clues"
+#define SEED_OPTION "--seed"
+#define STATS_OPTION "--stats"
+#define TIMEOUT_OPTION "--timeout"
+#define NODE_BUDGET_OPTION "--node-budget"
+#define PORTFOLIO_OPTION "--portfolio"
+#define DAEMON_OPTION "--daemon"
+#define MAX_SIZE_OPTION "--max-size"
+// the file name of the standard input in batch mode
+#define STDIN_NAME "-"
+// no limit on the nodes waiting in the best first search, and no beam search
+#define NO_MAX_NODES 0
+#define NO_BEAM 0
+#define NO_TABLE 0
+#define NO_COUNT -1
+#define NO_COUNT_LIMIT 0
+// no timeout and no budget of nodes for the in place search
+#define NO_BUDGET 0
+// the defaults of the generator: no puzzles (solving a file instead), 9x9 boards and as few clues
+// as the unique solution allows
+#define NO_GENERATE 0
+#define DEFAULT_GENERATE_SIZE 9
+#define FEWEST_CLUES 0
+// the biggest boards the daemon solves by default
+#define DEFAULT_DAEMON_MAX_SIZE 25
+#define NO_DAEMON_MAX_SIZE 0
+#define PERCENT 100.0
+// the default number of search threads of a single board, and of a batch (one per processor)
+#define ONE_THREAD 1
+#define ALL_PROCESSORS 0
+#define THREADS_NOT_GIVEN -1
+#define OPTION_PREFIX "--"
 #define TRUE 1
 #define FALSE 0
-// the number in the input board that indicates the slot is empty
-#define EMPTY_SLOT 0
-#define EPOSITIVE_NUMBER 0
-//indicates for an incomplete number returned from the sqrtCheck function
-#define INCOMPLETE_NUMBER -1
 // place in the command line for file's name
 #define FILE_NAME 1
 
 
 // ------------------------------ functions -----------------------------
 /**
- * This function checks for a given slot in the board if it's legal, means it doesn't exist in 
- * the same row, col or "little board" (sqrt of board's size)
- * input :
- * 		SudukuBoardStruct* sudukuBoard - a struct of suduku board
- * 		int row - the given row of the slot
- * 		int col - the given col of the slot
- * 		int sizeOfBoard - the size of the board
- * output :
- * 		0 if not legal and else 1.
- **/
-int slotLegalityCheck(SudukuBoardStruct* sudukuBoard, int row, int col, int sizeOfBoard)
-{
-	// indicator for the output. set by default to true
-	int indicator = TRUE;
-	int innerCounter;
-	// a for loop running on the size of the array (num of rows and cols)
-	for (innerCounter = 0; innerCounter < sizeOfBoard; innerCounter++)
-	{
-		// if the given slot's adress is not equal to the checked slots' adress  in the same 
-		// row and col (we dont want to give false when we check the same slot as given as input
-		// because it will always have the same value and therefore only checks for differ slots) 
-		if ((&(sudukuBoard)->board[row][col] != &(sudukuBoard)->board[row][innerCounter]) \
-			&& (&(sudukuBoard)->board[row][col] != &(sudukuBoard)->board[innerCounter][col]))
-		{
-				// if the checked slot is not 0 and it's value is equal to one of the slots in the
-				// in the same row and col than change indicator to false and return false, since
-				// the value is illegal. 
-				if ((sudukuBoard->board[row][col] != EMPTY_SLOT) && ((sudukuBoard->board[row][col] \
-					== sudukuBoard->board[row][innerCounter]) || (sudukuBoard->board[row][col] == \
-					sudukuBoard->board[innerCounter][col])))
-				{
-						indicator = FALSE;
-						return indicator;
-				}
-		}
-	}
-	// setting start points to start check in the little board. 
-	int startRowPoint = row / sqrtCheck(sizeOfBoard) * sqrtCheck(sizeOfBoard);
-	int startColPoint = col / sqrtCheck(sizeOfBoard) * sqrtCheck(sizeOfBoard);
-	// 2 counters for the loops
-	int rowCounter, colCounter;
-	// setting finish points to start check in the little board.
-	int rowFinishPoint = startRowPoint + sqrtCheck(sizeOfBoard);
-	int colFinishPoint = startColPoint + sqrtCheck(sizeOfBoard);
-	// a for loop inside a for loop checking again if the adress of the checkd slot is not equal 
-	// to the adress of the current slot and if theire values are equal return false.
-	for (rowCounter = startRowPoint; rowCounter < rowFinishPoint; rowCounter++)
-	{
-		for (colCounter = startColPoint; colCounter < colFinishPoint; colCounter++)
-		{
-			if ((&(sudukuBoard)->board[row][col] != \
-				&(sudukuBoard)->board[rowCounter][colCounter]) && \
-				((sudukuBoard)->board[row][col] == \
-				(sudukuBoard)->board[rowCounter][colCounter]) && \
-				((sudukuBoard)->board[row][col] != EMPTY_SLOT))
-			{
-				indicator = FALSE;
-				return indicator;
-			}
-		}
-	}
-	// if finished all the checks without returning false return true.
-	return indicator;
-}
-
-/**
- * This function checks for the whole board if it's values are legal or not.
- * input :
- * 		SudukuBoardStruct* sudukuBoard - a struct of suduku board
- * 		sizeOfBoard - size of the board.
- * output :
- * 		0 if not legal and else 1.
- **/
-int boardLegalityCheck(SudukuBoardStruct* sudukuBoard, int sizeOfBoard)
-{
-	// indicator for the output. set by default to true
-	int indicator = TRUE;
-	int row, col;
-	// a for loop inside a for loop running on all the slots in the board
-	for (row = 0; row < sizeOfBoard; row++)
-	{
-		for (col = 0; col < sizeOfBoard; col++)
-		{
-			// if the legality check for the current slot is false return false 
-			if (slotLegalityCheck(sudukuBoard, row, col, sizeOfBoard) == FALSE)
-			{
-				indicator = FALSE;
-				return indicator;
-			}
-		}
-	}
-	// if passed on the whole board and didnt found an illegal slot return true
-	return indicator;
-}
-
-/**
- * This function is the parser of the program. getting as input a file and a suduku struct, 
- * reading the lines of it and put it in the board in the matching place.
+ * This function is the parser of the program. getting as input a file, loading it with
+ * loadSudukuBoard and exiting with the matching error message if it's not a legal board.
  * input :
  * 		FILE *file - a given file
- * 		SudukuBoardStruct* suduku - a suduku board struct.
+ * 		char* fileName - the name of the file, for the error messages
  * output :
- * 		int which is the board size (number of rows / cols).
+ * 		the board. its size is the board size (number of rows / cols).
  **/
-int parser(FILE *file, SudukuBoardStruct* suduku, char* fileName)
+SudukuBoardStruct* parser(FILE *file, char* fileName)
 {
-	int i, j;
-	// reading the size of the board, if the size is not a positive number print error and exit
-	fscanf(file, "%d", &suduku->size);
-	// if the size is smaller than 0 print error message and exit
-	if (suduku->size <= EPOSITIVE_NUMBER)
-	{
-		printf("%s:not a valid suduku file\n", fileName);
-		exit(EXIT_FAILURE);
-	}
-	// check if the sqrt is int. if it's not print error and exit
-	int sqrtSize = sqrtCheck(suduku->size);
-	if (sqrtSize ==  INCOMPLETE_NUMBER)
+	int status;
+	SudukuBoardStruct* suduku = loadSudukuBoard(file, &status);
+	// a bad size, a missing num or a num that is negative or bigger than the size
+	if (status == SUDUKU_LOAD_NOT_VALID)
 	{
-		
 		printf("%s:not a valid suduku file\n", fileName);
 		exit(EXIT_FAILURE);
 	}
-	suduku->board = (int**)malloc(suduku->size*sizeof(int*));
-	if (suduku->board == NULL)
+	// if the given board is illegal print no solution and exit
+	if (status == SUDUKU_LOAD_NO_SOLUTION)
 	{
-		free(suduku->board);
+		printf("no solution!\n");
 		exit(EXIT_FAILURE);
 	}
-	// a for inside for loop running on the size of the board, reading the current num checks if 
-	//it's a positive number and not bigger than the size and if it does enters it to the board,
-	//else print error and exit.
-	for (i = 0; i < suduku->size; i++)
-	{
-		suduku->board[i] = (int*)malloc(sizeof(int) * suduku->size);
-		for (j = 0; j < suduku->size; j++)
-		{
-			fscanf(file, "%d", &suduku->board[i][j]);
-			if (suduku->board[i][j] < EPOSITIVE_NUMBER || suduku->board[i][j] > suduku->size)
-			{
-				printf("%s:not a valid suduku file\n", fileName);
-				exit(EXIT_FAILURE);
-			}
-		}
-	}
-	// if the given board is illegal print no solution and exit
-	if (boardLegalityCheck(suduku, suduku->size) == FALSE)
+	if (suduku == NULL)
 	{
-		printf("no solution!\n");
 		exit(EXIT_FAILURE);
 	}
-	return suduku->size;
-
+	return suduku;
 }
 
 
@@ -202,20 +128,129 @@ void sudukuBoardPrinter (SudukuBoardStruct* sudukuBoard, int sizeOfBoard)
 			// if it's the last num in row dont print space after it, else print
 			if ( col == (sizeOfBoard -1))
 			{
-				printf("%d", sudukuBoard->board[row][col]);
+				printf("%d", SUDUKU_SLOT(sudukuBoard, row, col));
 			}
 			else
 			{
-				printf("%d ", sudukuBoard->board[row][col]);
+				printf("%d ", SUDUKU_SLOT(sudukuBoard, row, col));
 			}
 		}
 		printf("\n");
 	}
 }
 
+/**
+ * This function prints the allocation counters of the pool of a context to stderr: the slabs it
+ * allocated, the boards it handed out and the most boards that were in use at once.
+ * input :
+ * 		SudukuContext* context - the context of the searched board
+ * output :
+ * 		void.
+ **/
+void printSudukuAllocations(SudukuContext* context)
+{
+	fprintf(stderr, "slab allocations: %lu\nnode acquisitions: %lu\npeak nodes in use: %lu\n", \
+			context->slabAllocations, context->nodeAcquisitions, context->peakNodesInUse);
+}
+
+/**
+ * This function returns what stopped a search, for the message of a stopped search.
+ * input :
+ * 		int status - the DFS_STATUS_ the search ended with, not DFS_STATUS_DONE
+ * output :
+ * 		the name of what stopped it
+ **/
+const char* stopReason(int status)
+{
+	switch (status)
+	{
+		case DFS_STATUS_NODE_LIMIT:
+			return "node budget";
+		case DFS_STATUS_DEADLINE:
+			return "timeout";
+		case DFS_STATUS_CANCELLED:
+			return "cancellation";
+		default:
+			return "unknown status";
+	}
+}
+
+/**
+ * This function prints the usage message of the program and exits.
+ * input :
+ * 		void
+ * output :
+ * 		void.
+ **/
+void usageError(void)
+{
+	printf("please supply a file!\n");
+	printf("boards are up to %dx%d\n", SUDUKU_MAX_BOARD_SIZE, SUDUKU_MAX_BOARD_SIZE);
+	printf("usage: sudukusolver [--no-propagation] [--nodes] [--dlx] [--sat] [--threads <n>] " \
+		   "[--best-first [--max-nodes <n>]] [--beam <width>] [--table <entries>] " \
+		   "[--count <limit>] [--stats] [--timeout <ms>] [--node-budget <n>] [--portfolio] " \
+		   "[--batch] <filename>\n");
+	printf("       sudukusolver --generate <n> [--size <size>] [--clues <n>] [--seed <n>] " \
+		   "[--threads <n>]\n");
+	printf("       sudukusolver --daemon <socket> [--max-size <size>] [--threads <n>] " \
+		   "[--timeout <ms>] [--node-budget <n>]\n");
+	exit(EXIT_FAILURE);
+}
+
 /**
  * This function is the main function of the program. responsible of getting the file, make the 
  * check if it's legal and print the board if it does, else exit with the matching error message.
+ * the options are:
+ * 		--no-propagation - branch without filling the forced slots of every node first
+ * 		--nodes - print the number of nodes the search expanded to stderr, the slabs and
+ * 				  boards the pool of the board's size handed out, and for the in place search
+ * 				  the peak depth and live nodes of its stack
+ * 		--dlx - solve with the exact cover (Dancing Links) solver instead of the DFS
+ * 		--sat - solve with the CDCL SAT solver instead of the DFS. with --nodes, its decisions,
+ * 				conflicts, propagations, restarts and clauses are printed too. it takes no --dlx
+ * 		--threads <n> - search with n threads (0 for one per processor) instead of in place
+ * 		--best-first - search best first, by the number of filled slots, instead of in place
+ * 		--max-nodes <n> - the most nodes the best first search keeps waiting at once
+ * 		--beam <width> - search with a beam of the given width instead of in place. the beam can
+ * 						 miss the solution, and then there's no solution
+ * 		--table <entries> - search in place with a transposition table of the given number of
+ * 							entries, which skips the boards that were already searched. the
+ * 							tree of a suduku has every board once, so it never hits. it takes
+ * 							no other search option
+ * 		--count <limit> - print the number of solutions instead of a solution, counting up to
+ * 						  the limit (0 for no limit). a limit of 2 checks if the solution is unique.
+ * 						  the count searches in place, so it takes no other search option
+ * 		--stats - print the trace of the in place search or count to stderr: the nodes and the
+ * 				  branching factor of every depth and the cycles spent in every callback. it
+ * 				  takes a build with make TRACE=1, and no other search option
+ * 		--timeout <ms> - stop the in place search when the given milliseconds passed since the
+ * 						 program started. a stopped search prints how far it got to stderr and
+ * 						 the fullest board it found, with 0 in its empty slots
+ * 		--node-budget <n> - stop the in place search when it expanded n nodes, like --timeout
+ * 		--portfolio - search with the configurations of sudukuDefaultPortfolio at once, one
+ * 					  thread each, and take the first to finish. --threads <n> runs only the
+ * 					  first n of them. the win rate of every configuration is printed to
+ * 					  stderr. with --batch, every puzzle is solved this way and the win rates
+ * 					  are over all of them, and the threads (one per processor by default)
+ * 					  are shared between the configurations and the puzzles. it takes no
+ * 					  table and no other search option
+ * 		--generate <n> - instead of solving a file, print n puzzles with a unique solution, made
+ * 						 on a pool of --threads threads (one per processor by default), with:
+ * 		--size <size> - the size of the puzzles: 4, 9 (the default), 16 or 25
+ * 		--clues <n> - the number of clues to stop removing clues at (by default as few as possible)
+ * 		--seed <n> - the seed of the puzzles (by default the time)
+ * 		--batch - the file (- for the standard input) is a stream of puzzles, solved on a pool of
+ * 				  --threads threads (one per processor by default). see solveSudukuBatch.
+ * 				  it solves in place, or with --dlx, --sat or --portfolio, and takes no
+ * 				  --nodes
+ * 		--daemon <socket> - instead of solving a file, solve the boards sent to the Unix domain
+ * 							socket at the given path until SIGINT or SIGTERM, on a pool of
+ * 							--threads threads (one per processor by default), every board in
+ * 							place with the --timeout and --node-budget given. see
+ * 							runSudukuDaemon
+ * 		--max-size <size> - the biggest size of the boards the daemon solves (25 by default)
+ * the boards are up to SUDUKU_MAX_BOARD_SIZE x SUDUKU_MAX_BOARD_SIZE, a bigger one is not a valid
+ * file.
  * input :
  * 		int argc - number of arguments 
  * 		char* argv[] - the arguments in the command line
@@ -226,37 +261,535 @@ int main(int argc, char* argv[])
 {
 	FILE *file;
 	int boardSize;
+	SudukuBoardStruct *suduku;
+	char* fileName = NULL;
+	int propagate = TRUE;
+	int printNodes = FALSE;
+	int printStats = FALSE;
+	// the trace is big, so it's not kept on the stack
+	static DfsTrace trace;
+	int useDlx = FALSE;
+	int useSat = FALSE;
+	SudukuSatStats satStats;
+	int numOfThreads = THREADS_NOT_GIVEN;
+	int batch = FALSE;
+	int bestFirst = FALSE;
+	unsigned long maxNodes = NO_MAX_NODES;
+	int beamWidth = NO_BEAM;
+	unsigned long tableEntries = NO_TABLE;
+	long countLimit = NO_COUNT;
+	unsigned long timeoutMillis = NO_BUDGET;
+	unsigned long nodeBudget = NO_BUDGET;
+	DfsBudget budget;
+	int usePortfolio = FALSE;
+	SudukuPortfolio portfolio;
+	TranspositionTable* table = NULL;
+	char* daemonSocket = NULL;
+	int daemonMaxSize = NO_DAEMON_MAX_SIZE;
+	SudukuGeneratorOptions generator;
+	generator.size = DEFAULT_GENERATE_SIZE;
+	generator.numOfPuzzles = NO_GENERATE;
+	generator.targetClues = FEWEST_CLUES;
+	generator.seed = (uint64_t)time(NULL);
+	int i;
+	// the options can come before or after the file's name, but there's exactly one file
+	for (i = FILE_NAME; i < argc; i++)
+	{
+		if (strcmp(argv[i], NO_PROPAGATION_OPTION) == 0)
+		{
+			propagate = FALSE;
+		}
+		else if (strcmp(argv[i], NODES_OPTION) == 0)
+		{
+			printNodes = TRUE;
+		}
+		else if (strcmp(argv[i], STATS_OPTION) == 0)
+		{
+			printStats = TRUE;
+		}
+		else if (strcmp(argv[i], PORTFOLIO_OPTION) == 0)
+		{
+			usePortfolio = TRUE;
+		}
+		else if (strcmp(argv[i], DLX_OPTION) == 0)
+		{
+			useDlx = TRUE;
+		}
+		else if (strcmp(argv[i], SAT_OPTION) == 0)
+		{
+			useSat = TRUE;
+		}
+		else if (strcmp(argv[i], THREADS_OPTION) == 0)
+		{
+			// the option's value is the next argument
+			if (i + 1 == argc || sscanf(argv[i + 1], "%d", &numOfThreads) != 1)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], BATCH_OPTION) == 0)
+		{
+			batch = TRUE;
+		}
+		else if (strcmp(argv[i], BEST_FIRST_OPTION) == 0)
+		{
+			bestFirst = TRUE;
+		}
+		else if (strcmp(argv[i], MAX_NODES_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%lu", &maxNodes) != 1)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], GENERATE_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%d", &generator.numOfPuzzles) != 1 || \
+				generator.numOfPuzzles <= NO_GENERATE)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], SIZE_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%d", &generator.size) != 1)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], CLUES_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%d", &generator.targetClues) != 1)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], SEED_OPTION) == 0)
+		{
+			unsigned long long seed;
+			if (i + 1 == argc || sscanf(argv[i + 1], "%llu", &seed) != 1)
+			{
+				usageError();
+			}
+			generator.seed = seed;
+			i++;
+		}
+		else if (strcmp(argv[i], COUNT_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%ld", &countLimit) != 1 || countLimit < 0)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], TABLE_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%lu", &tableEntries) != 1 || \
+				tableEntries == NO_TABLE)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], TIMEOUT_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%lu", &timeoutMillis) != 1 || \
+				timeoutMillis == NO_BUDGET)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], NODE_BUDGET_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%lu", &nodeBudget) != 1 || \
+				nodeBudget == NO_BUDGET)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], DAEMON_OPTION) == 0)
+		{
+			if (i + 1 == argc)
+			{
+				usageError();
+			}
+			daemonSocket = argv[i + 1];
+			i++;
+		}
+		else if (strcmp(argv[i], MAX_SIZE_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%d", &daemonMaxSize) != 1 || \
+				daemonMaxSize <= 0 || daemonMaxSize > SUDUKU_MAX_SIZE || \
+				sqrtCheck(daemonMaxSize) < 0)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], BEAM_OPTION) == 0)
+		{
+			if (i + 1 == argc || sscanf(argv[i + 1], "%d", &beamWidth) != 1 || beamWidth < 1)
+			{
+				usageError();
+			}
+			i++;
+		}
+		else if (strncmp(argv[i], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0 || fileName != NULL)
+		{
+			usageError();
+		}
+		else
+		{
+			fileName = argv[i];
+		}
+	}
+	// the most nodes waiting only limit the best first search
+	if (maxNodes != NO_MAX_NODES && !bestFirst)
+	{
+		usageError();
+	}
+	// and the biggest size only limits the daemon
+	if (daemonMaxSize != NO_DAEMON_MAX_SIZE && daemonSocket == NULL)
+	{
+		usageError();
+	}
+	// generating puzzles takes no file
+	if (generator.numOfPuzzles != NO_GENERATE)
+	{
+		if (fileName != NULL)
+		{
+			usageError();
+		}
+		if (generator.size < SUDUKU_GENERATOR_MIN_SIZE || \
+			generator.size > SUDUKU_GENERATOR_MAX_SIZE || sqrtCheck(generator.size) < 0)
+		{
+			fprintf(stderr, "can't generate puzzles of size %d, the size is 4, 9, 16 or 25\n", \
+					generator.size);
+			return EXIT_FAILURE;
+		}
+		if (generator.targetClues < FEWEST_CLUES || \
+			generator.targetClues > generator.size * generator.size)
+		{
+			fprintf(stderr, "can't generate puzzles with %d clues, a puzzle of size %d has up to " \
+					"%d clues\n", generator.targetClues, generator.size, \
+					generator.size * generator.size);
+			return EXIT_FAILURE;
+		}
+		generator.numOfThreads = (numOfThreads == THREADS_NOT_GIVEN) ? ALL_PROCESSORS : \
+								 numOfThreads;
+		if (generateSudukuPuzzles(stdout, &generator) != EXIT_SUCCESS)
+		{
+			fprintf(stderr, "can't generate puzzles, memory allocation or a thread failed\n");
+			return EXIT_FAILURE;
+		}
+		return 0;
+	}
+	// the daemon takes no file, and solves in place with the default configuration only
+	if (daemonSocket != NULL)
+	{
+		if (fileName != NULL || batch || usePortfolio || useDlx || useSat || bestFirst || \
+			beamWidth != NO_BEAM || countLimit != NO_COUNT || tableEntries != NO_TABLE || \
+			!propagate)
+		{
+			usageError();
+		}
+		SudukuDaemonOptions options;
+		options.numOfThreads = (numOfThreads == THREADS_NOT_GIVEN) ? ALL_PROCESSORS : numOfThreads;
+		options.maxSize = (daemonMaxSize == NO_DAEMON_MAX_SIZE) ? DEFAULT_DAEMON_MAX_SIZE : \
+						  daemonMaxSize;
+		options.nodeBudget = nodeBudget;
+		options.timeoutMillis = timeoutMillis;
+		int result = runSudukuDaemon(daemonSocket, &options);
+		if (result != EXIT_SUCCESS)
+		{
+			fprintf(stderr, "can't run a daemon at %s\n", daemonSocket);
+		}
+		return result;
+	}
+	// illeagl input line
+	if (fileName == NULL)
+	{
+		usageError();
+	}
+	// only the in place search and the portfolio have a budget. the timeout counts from here, so
+	// loading the board is in it
+	int budgeted = (timeoutMillis != NO_BUDGET || nodeBudget != NO_BUDGET);
+	int otherSearch = (useDlx || useSat || bestFirst || beamWidth != NO_BEAM || \
+					   countLimit != NO_COUNT);
+	// one search solves the board, and the batch has no best first or beam search and no counts
+	// of nodes
+	if ((useDlx && useSat) || (batch && (bestFirst || beamWidth != NO_BEAM || printNodes)))
+	{
+		usageError();
+	}
+	// the threads of the portfolio run its configurations, which all keep the budget
+	if ((budgeted && (batch || otherSearch || (!usePortfolio && numOfThreads != THREADS_NOT_GIVEN \
+		&& numOfThreads != ONE_THREAD))) || (usePortfolio && otherSearch))
+	{
+		usageError();
+	}
+	// only the in place search keeps a table
+	if (tableEntries != NO_TABLE && (batch || otherSearch || usePortfolio || \
+		(numOfThreads != THREADS_NOT_GIVEN && numOfThreads != ONE_THREAD)))
+	{
+		usageError();
+	}
+	// only the in place search and the count are traced
+	if (printStats && (batch || useDlx || useSat || usePortfolio || bestFirst || \
+		beamWidth != NO_BEAM || (numOfThreads != THREADS_NOT_GIVEN && numOfThreads != ONE_THREAD)))
+	{
+		usageError();
+	}
+	// the solutions are counted by the in place search on one board only
+	if (countLimit != NO_COUNT && (batch || useDlx || useSat || bestFirst || beamWidth != NO_BEAM \
+		|| tableEntries != NO_TABLE || (numOfThreads != THREADS_NOT_GIVEN && \
+		numOfThreads != ONE_THREAD)))
+	{
+		usageError();
+	}
+	initDfsBudget(&budget, nodeBudget, timeoutMillis);
+	// a board is solved by as many configurations as there are threads, the first ones of the
+	// portfolio, or by all of them if the threads were not given
+	int numOfConfigs = SUDUKU_DEFAULT_PORTFOLIO_CONFIGS;
+	int totalThreads = numOfThreads;
+	if (usePortfolio && numOfThreads != THREADS_NOT_GIVEN)
+	{
+		if (totalThreads <= ALL_PROCESSORS)
+		{
+			totalThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		}
+		if (totalThreads < numOfConfigs)
+		{
+			numOfConfigs = (totalThreads < ONE_THREAD) ? ONE_THREAD : totalThreads;
+		}
+	}
+	initSudukuPortfolio(&portfolio, sudukuDefaultPortfolio, numOfConfigs);
 	// oppening the file with reading permission
-	file = fopen(argv[FILE_NAME], "r");
+	file = (batch && strcmp(fileName, STDIN_NAME) == 0) ? stdin : fopen(fileName, "r");
 	//in case of NULL means no file was given or wrong location
 	if (file == NULL) 
 	{
-		printf("please supply a file!\n");
-		printf("usage: sudukusolver <filename>\n");
+		usageError();
+	}
+	if (batch)
+	{
+		SudukuBatchOptions options;
+		options.numOfThreads = (numOfThreads == THREADS_NOT_GIVEN) ? ALL_PROCESSORS : numOfThreads;
+		if (usePortfolio)
+		{
+			// every puzzle takes a thread per configuration, so the given threads are shared
+			// between the configurations and the puzzles
+			if (numOfThreads == THREADS_NOT_GIVEN)
+			{
+				totalThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+			}
+			options.numOfThreads = totalThreads / numOfConfigs;
+			if (options.numOfThreads < ONE_THREAD)
+			{
+				options.numOfThreads = ONE_THREAD;
+			}
+		}
+		options.propagate = propagate;
+		options.useDlx = useDlx;
+		options.useSat = useSat;
+		options.portfolio = usePortfolio ? &portfolio : NULL;
+		int result = solveSudukuBatch(file, fileName, stdout, &options);
+		if (file != stdin)
+		{
+			fclose(file);
+		}
+		if (usePortfolio)
+		{
+			printSudukuPortfolio(stderr, &portfolio);
+		}
+		return result;
+	}
+	if (numOfThreads == THREADS_NOT_GIVEN)
+	{
+		numOfThreads = ONE_THREAD;
+	}
+	// sending the file to the parser and put in boardSize the size of the Board
+	suduku = parser(file, fileName);
+	boardSize = suduku->size;
+	suduku->context->propagate = propagate;
+	// the forced slots of the root are filled once here, every other node fills its own
+	propagateSudukuRoot(suduku);
+	if (printStats && !startDfsTrace(&trace))
+	{
+		fprintf(stderr, "the search statistics are compiled out, build with make TRACE=1\n");
+		printStats = FALSE;
+	}
+	// the in place searches use the solver specialized for the size, if there is one
+	getNodeMovesFunc getMoves;
+	applyMoveFunc applyMove;
+	getSudukuFixedMoveFuncs(suduku->context, &getMoves, &applyMove);
+	// counting the solutions in place, as many as the limit
+	if (countLimit != NO_COUNT)
+	{
+		unsigned long solutions = countBest(suduku, getMoves, applyMove, \
+											undoSudukuMoveFunc, getSudukuValFunc, \
+											(boardSize * boardSize), countLimit);
+		if (printNodes)
+		{
+			fprintf(stderr, "nodes expanded: %lu\n", suduku->context->nodesExpanded);
+			printSudukuAllocations(suduku->context);
+		}
+		if (printStats)
+		{
+			printDfsTrace(stderr, &trace);
+		}
+		if (countLimit != NO_COUNT_LIMIT && solutions == (unsigned long)countLimit)
+		{
+			printf("at least ");
+		}
+		printf("%lu %s\n", solutions, (solutions == 1) ? "solution" : "solutions");
+		freeSudukuContext(suduku->context);
+		fclose(file);
+		return 0;
+	}
+	// solving the board in place. the returned node is the board itself, solved
+	SudukuBoardStruct *finalSuduku;
+	DfsStats stats;
+	if (useDlx)
+	{
+		int dlxResult = solveSudukuDlx(suduku);
+		if (dlxResult == SUDUKU_DLX_FAILED)
+		{
+			fprintf(stderr, "memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		finalSuduku = dlxResult ? suduku : NULL;
+	}
+	else if (useSat)
+	{
+		int satResult = solveSudukuSat(suduku, &satStats);
+		if (satResult == SUDUKU_SAT_FAILED)
+		{
+			fprintf(stderr, "memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		finalSuduku = satResult ? suduku : NULL;
+	}
+	else if (usePortfolio)
+	{
+		// the board is turned into the solution of the configuration that finished first
+		if (solveSudukuPortfolio(suduku, &portfolio, &budget) == SUDUKU_PORTFOLIO_FAILED)
+		{
+			fprintf(stderr, "memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		finalSuduku = suduku;
+		printSudukuPortfolio(stderr, &portfolio);
+	}
+	else if (bestFirst)
+	{
+		finalSuduku = (SudukuBoardStruct*) getBestFirst(suduku, getSudukuChildrenFunc, \
+								getSudukuValFunc, freeSudukuFunc, copySudukuFunc, \
+								(boardSize * boardSize), maxNodes);
+	}
+	else if (beamWidth != NO_BEAM)
+	{
+		finalSuduku = (SudukuBoardStruct*) getBestBeam(suduku, getSudukuChildrenFunc, \
+								getSudukuValFunc, freeSudukuFunc, copySudukuFunc, \
+								(boardSize * boardSize), beamWidth);
+	}
+	else if (numOfThreads != ONE_THREAD)
+	{
+		// the threads copy the boards of the same pool at once
+		setSudukuContextShared(suduku->context, TRUE);
+		finalSuduku = (SudukuBoardStruct*) getBestParallel(suduku, getSudukuChildrenFunc, \
+								getSudukuValFunc, freeSudukuFunc, copySudukuFunc, \
+								(boardSize * boardSize), numOfThreads);
+	}
+	else
+	{
+		// without a table getBestWithTable is getBestIterative
+		if (tableEntries != NO_TABLE)
+		{
+			table = createTranspositionTable(tableEntries, getSudukuKeyFunc, \
+											 boardSize * boardSize * sizeof(SudukuCell));
+			if (table == NULL)
+			{
+				fprintf(stderr, "memory allocation failed\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+		finalSuduku = (SudukuBoardStruct*) getBestInPlaceWithBudget(suduku, getMoves, \
+								applyMove, undoSudukuMoveFunc, getSudukuValFunc, \
+								(table == NULL) ? NULL : getSudukuHashFunc, table, \
+								(boardSize * boardSize), &stats, budgeted ? &budget : NULL);
+	}
+	if (printNodes)
+	{
+		// the configurations of the portfolio count their nodes in their own contexts
+		fprintf(stderr, "nodes expanded: %lu\n", usePortfolio ? budget.nodesExpanded : \
+				suduku->context->nodesExpanded);
+		if (!usePortfolio)
+		{
+			printSudukuAllocations(suduku->context);
+		}
+		// only the in place search keeps the statistics of its stack
+		if (!useDlx && !useSat && !usePortfolio && !bestFirst && beamWidth == NO_BEAM && \
+			numOfThreads == ONE_THREAD)
+		{
+			fprintf(stderr, "peak depth: %lu\npeak live nodes: %lu\n", stats.peakDepth, \
+					stats.peakLiveNodes);
+		}
+		if (useSat)
+		{
+			fprintf(stderr, "variables: %d\nclauses: %lu\nconflicts: %lu\npropagations: %lu\n" \
+					"restarts: %lu\nlearned clauses deleted: %lu\n", satStats.variables, \
+					satStats.clauses, satStats.conflicts, satStats.propagations, \
+					satStats.restarts, satStats.deleted);
+		}
+		if (table != NULL)
+		{
+			TranspositionStats tableStats = getTranspositionStats(table);
+			fprintf(stderr, "table lookups: %lu\ntable hits: %lu (%.2f%%)\n" \
+					"table collisions: %lu\ntable replaced: %lu\n", tableStats.lookups, \
+					tableStats.hits, (tableStats.lookups == 0) ? 0.0 : \
+					PERCENT * tableStats.hits / tableStats.lookups, tableStats.collisions, \
+					tableStats.replaced);
+		}
+	}
+	if (printStats)
+	{
+		printDfsTrace(stderr, &trace);
+	}
+	if (budgeted && budget.status == DFS_STATUS_FAILED)
+	{
+		fprintf(stderr, "memory allocation failed\n");
 		exit(EXIT_FAILURE);
 	}
-	// illeagl input line
-	if (argc != LEGAL_COMMAND_LINE_SIZE) 
-	{	
-		printf("please supply a file!\n");
-		printf("usage: sudukusolver <filename>\n");
+	// the search was stopped, so it tells how far it got and prints the fullest board it found
+	if (budgeted && budget.status != DFS_STATUS_DONE)
+	{
+		fprintf(stderr, "search stopped by the %s after %lu nodes, the fullest board has %u of " \
+				"%d slots filled\n", stopReason(budget.status), budget.nodesExpanded, \
+				budget.bestValue, boardSize * boardSize);
+		printf("%d\n", boardSize);
+		sudukuBoardPrinter(finalSuduku, finalSuduku->size);
 		exit(EXIT_FAILURE);
 	}
-	SudukuBoardStruct *suduku = (SudukuBoardStruct*) malloc(sizeof(SudukuBoardStruct));
-	// sending the file and the suduku to the parser and put in boardSize the size of the Board
-	boardSize = parser(file, suduku, argv[FILE_NAME]);	
-	SudukuBoardStruct *finalSuduku = (SudukuBoardStruct*) getBest(suduku, getSudukuChildrenFunc, \
-								getSudukuValFunc, freeSudukuFunc, copySudukuFunc, \
-								(boardSize * boardSize));
-	if (finalSuduku == NULL)
+	// the best first and beam searches return the fullest board they found
+	if (finalSuduku == NULL || \
+		getSudukuValFunc(finalSuduku) != (unsigned int)(boardSize * boardSize))
 	{
 		printf("no solution!\n");
 		exit(EXIT_FAILURE);
 	}
 	printf("%d\n", boardSize);
 	sudukuBoardPrinter(finalSuduku, finalSuduku->size);
-	freeSudukuFunc(finalSuduku);
-	freeSudukuFunc(suduku);
+	// freeing the context frees every board of its pool
+	freeSudukuContext(suduku->context);
+	freeTranspositionTable(table);
 	fclose(file);
 	return 0;
 }
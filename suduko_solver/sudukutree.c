@@ -11,7 +11,10 @@
 #include <stdio.h>
 #include <string.h> 
 #include <stdlib.h>
+#include <pthread.h>
 #include "genericdfs.h"
+#include "sudukutree.h"
+#include "sudukusimd.h"
 
 // -------------------------- const definitions -------------------------
 // not an int number indicator
@@ -21,13 +24,65 @@
 #define TRUE 1
 #define FALSE 0
 #define NO_CHILDREN 0
+#define EMPTY_SLOT 0
+// the slot returned by findBranchSlot for a full board
+#define NO_EMPTY_SLOT -1
+// the cursor of getNextSudukuChildFunc before the first child and after the last one
+#define CURSOR_START 0
+#define CURSOR_DONE -1
+// the kinds of units - groups of slots a digit appears in once - in the order of usedSets
+#define UNIT_ROW 0
+#define UNIT_COL 1
+#define UNIT_BOX 2
+#define UNIT_TYPES 3
+// every node and slab is aligned to the size of a SudukuMask word
+#define NODE_ALIGNMENT sizeof(SudukuMask)
+// the pool carves slabs of about this many bytes, and at least MIN_NODES_PER_SLAB nodes
+#define SLAB_BYTES 65536
+#define MIN_NODES_PER_SLAB 16
+// the nodes a thread moves between its own free list and the list of a shared context at once
+#define LOCAL_POOL_BATCH 32
+// the seed the Zobrist keys are mixed from (the golden ratio, as splitmix64 uses)
+#define ZOBRIST_SEED 0x9e3779b97f4a7c15ULL
+
+// -------------------------- macros ------------------------------------
+// the index of the little board a slot belongs to
+#define BOX_INDEX(suduku, row, col) \
+	(((row) / (suduku)->boxSize) * (suduku)->boxSize + (col) / (suduku)->boxSize)
+// the word and the bit of a num in a used digits set
+#define MASK_WORD(num) (((num) - 1) / SUDUKU_MASK_BITS)
+#define MASK_BIT(num) ((SudukuMask)1 << (((num) - 1) % SUDUKU_MASK_BITS))
+// a move puts a num in a slot. it's the index of the slot (row * size + col) and the num packed in
+// one int, which fits since a num is never bigger than SUDUKU_MAX_SIZE
+#define MOVE_NUM_BITS 8
+#define MAKE_MOVE(slot, num) (((slot) << MOVE_NUM_BITS) | (num))
+#define MOVE_SLOT(move) ((move) >> MOVE_NUM_BITS)
+#define MOVE_NUM(move) ((move) & ((1 << MOVE_NUM_BITS) - 1))
+// rounds a number of bytes up to NODE_ALIGNMENT
+#define ALIGN_UP(bytes) (((bytes) + NODE_ALIGNMENT - 1) / NODE_ALIGNMENT * NODE_ALIGNMENT)
 
 // -------------------------- structs -----------------------------------
-typedef struct SudukuBoardStruct 
+/**
+ * the free list a thread keeps of the nodes of a shared context, so copying and freeing boards
+ * takes no lock. it takes nodes from the context's list and gives them back in batches, and all of
+ * them when the thread binds another context or ends. the id of the context tells a list of a
+ * freed context from one of a new context at the same address.
+ **/
+typedef struct LocalPool
 {
-	int** board;
-	int size; 
-}SudukuBoardStruct;
+	SudukuContext* context;
+	unsigned long contextId;
+	void* freeNodes;
+	int count;
+}LocalPool;
+
+// -------------------------- globals -----------------------------------
+// the local pool of the calling thread, and the id of the last context created
+static _Thread_local LocalPool localPool = {NULL, 0, NULL, 0};
+static unsigned long lastContextId = 0;
+// the key whose destructor gives the local pool of a thread back when the thread ends
+static pthread_key_t localPoolKey;
+static pthread_once_t localPoolKeyOnce = PTHREAD_ONCE_INIT;
 
 // ------------------------------ functions -----------------------------
 void freeSudukuFunc(void* sudukuStruct);
@@ -44,7 +99,7 @@ int sqrtCheck(int size)
 	int i;
 	// running from 0 to the num and checks if i * i is the requested num. if it does returns it
 	// because it's is sqrt
-	for (i = 0; i <= size; i++)
+	for (i = 0; i * i <= size; i++)
 	{
 		if (i * i == size)
 		{
@@ -56,7 +111,7 @@ int sqrtCheck(int size)
 }
 
 /**
- * This function returns the number of numbers in the board that are not 0
+ * This function returns the number of numbers in the board that are not 0, in O(1)
  * input :
  * 		void* sudukuStruct - a pNode struct
  * output :
@@ -68,27 +123,391 @@ unsigned int getSudukuValFunc(void* sudukuStruct)
 	{
 		return ILLEGAL_VALUE;
 	}
-	// casting the pNode to a SudukuBoardStruct
-	SudukuBoardStruct* suduku = (SudukuBoardStruct*) sudukuStruct;
-	int i, j;
-	int counter = 0;
-	// running on each and every slot in the board and if it's not 0 add it to a counter
-	for (i = 0; i < suduku->size; i++)
+	// the count is kept up to date by setSudukuSlot
+	return ((SudukuBoardStruct*) sudukuStruct)->filled;
+}
+
+/**
+ * this function points the board and the used digits sets of a node to their place in the node.
+ * input :
+ * 		SudukuBoardStruct* suduku - a node of the context's pool
+ * 		SudukuContext* context - the context
+ * output :
+ * 		void
+ **/
+static void pointNodeFields(SudukuBoardStruct* suduku, SudukuContext* context)
+{
+	int setWords = context->size * context->maskWords;
+	suduku->board = (SudukuCell*)((char*)suduku + context->cellsOffset);
+	suduku->rowUsed = (SudukuMask*)((char*)suduku + context->masksOffset);
+	suduku->colUsed = suduku->rowUsed + setWords;
+	suduku->boxUsed = suduku->colUsed + setWords;
+}
+
+/**
+ * this function allocates a new slab for a context's pool and carves it into nodes on the free
+ * list of the context. a shared context must be locked.
+ * input :
+ * 		SudukuContext* context - a context
+ * output :
+ * 		1 if the slab was allocated, 0 if memory allocation failed.
+ **/
+static int addSlab(SudukuContext* context)
+{
+	// the first NODE_ALIGNMENT bytes of a slab link it to the next slab
+	char* slab = (char*)malloc(NODE_ALIGNMENT + context->nodesPerSlab * context->nodeBytes);
+	if (slab == NULL)
+	{
+		return FALSE;
+	}
+	context->slabAllocations++;
+	*(void**)slab = context->slabs;
+	context->slabs = slab;
+	int i;
+	for (i = context->nodesPerSlab - 1; i >= 0; i--)
 	{
-		for (j = 0; j < suduku->size; j++)
+		void* node = slab + NODE_ALIGNMENT + i * context->nodeBytes;
+		*(void**)node = context->freeNodes;
+		context->freeNodes = node;
+	}
+	return TRUE;
+}
+
+/**
+ * this function gives all the nodes of the calling thread's local pool back to the free list of
+ * its context, and unbinds it.
+ * input :
+ * 		void
+ * output :
+ * 		void
+ **/
+static void giveBackLocalPool(void)
+{
+	SudukuContext* context = localPool.context;
+	if (context != NULL && localPool.freeNodes != NULL)
+	{
+		pthread_mutex_lock(&context->poolLock);
+		while (localPool.freeNodes != NULL)
 		{
-			if (suduku->board[i][j] != 0)
+			void* node = localPool.freeNodes;
+			localPool.freeNodes = *(void**)node;
+			*(void**)node = context->freeNodes;
+			context->freeNodes = node;
+		}
+		pthread_mutex_unlock(&context->poolLock);
+	}
+	localPool.context = NULL;
+	localPool.freeNodes = NULL;
+	localPool.count = 0;
+}
+
+/**
+ * the destructor of localPoolKey: it gives the local pool of an ending thread back.
+ **/
+static void localPoolDestructor(void* pool)
+{
+	(void)pool;
+	giveBackLocalPool();
+}
+
+/**
+ * this function creates localPoolKey, once.
+ **/
+static void createLocalPoolKey(void)
+{
+	pthread_key_create(&localPoolKey, localPoolDestructor);
+}
+
+/**
+ * this function points the calling thread's local pool to a shared context. the nodes the list
+ * kept for another context are given back to it first, and the pool is given back when the
+ * thread ends.
+ * input :
+ * 		SudukuContext* context - a shared context
+ * output :
+ * 		void
+ **/
+static void bindLocalPool(SudukuContext* context)
+{
+	if (localPool.context == context && localPool.contextId == context->id)
+	{
+		return;
+	}
+	// a list of a freed context at the same address is dropped, its nodes were freed with it
+	if (localPool.context == context)
+	{
+		localPool.context = NULL;
+	}
+	giveBackLocalPool();
+	pthread_once(&localPoolKeyOnce, createLocalPoolKey);
+	pthread_setspecific(localPoolKey, &localPool);
+	localPool.context = context;
+	localPool.contextId = context->id;
+}
+
+/**
+ * this function takes a node out of the calling thread's local pool of a shared context. if the
+ * local pool is empty, a batch of nodes is moved to it from the context's list first, under the
+ * context's lock.
+ * input :
+ * 		SudukuContext* context - a shared context
+ * output :
+ * 		the node. its content is undefined. NULL if memory allocation failed
+ **/
+static SudukuBoardStruct* acquireSharedNode(SudukuContext* context)
+{
+	bindLocalPool(context);
+	if (localPool.freeNodes == NULL)
+	{
+		pthread_mutex_lock(&context->poolLock);
+		if (context->freeNodes == NULL && !addSlab(context))
+		{
+			pthread_mutex_unlock(&context->poolLock);
+			return NULL;
+		}
+		while (localPool.count < LOCAL_POOL_BATCH && context->freeNodes != NULL)
+		{
+			void* node = context->freeNodes;
+			context->freeNodes = *(void**)node;
+			*(void**)node = localPool.freeNodes;
+			localPool.freeNodes = node;
+			localPool.count++;
+		}
+		pthread_mutex_unlock(&context->poolLock);
+	}
+	SudukuBoardStruct* node = (SudukuBoardStruct*)localPool.freeNodes;
+	localPool.freeNodes = *(void**)node;
+	localPool.count--;
+	return node;
+}
+
+/**
+ * this function puts a node of a shared context in the calling thread's local pool. a thread that
+ * frees more nodes than it takes, like a thief of subtrees, gives a batch back to the context's
+ * list when its local pool grows past two batches.
+ * input :
+ * 		SudukuContext* context - a shared context
+ * 		void* node - the node
+ * output :
+ * 		void
+ **/
+static void releaseSharedNode(SudukuContext* context, void* node)
+{
+	bindLocalPool(context);
+	*(void**)node = localPool.freeNodes;
+	localPool.freeNodes = node;
+	localPool.count++;
+	if (localPool.count > 2 * LOCAL_POOL_BATCH)
+	{
+		pthread_mutex_lock(&context->poolLock);
+		while (localPool.count > LOCAL_POOL_BATCH)
+		{
+			node = localPool.freeNodes;
+			localPool.freeNodes = *(void**)node;
+			*(void**)node = context->freeNodes;
+			context->freeNodes = node;
+			localPool.count--;
+		}
+		pthread_mutex_unlock(&context->poolLock);
+	}
+}
+
+/**
+ * this function takes a node out of a context's pool: out of the free list of the context, or of
+ * the calling thread's local pool if the context is shared. if the list is empty a new slab is
+ * allocated and carved into nodes first.
+ * input :
+ * 		SudukuContext* context - a context
+ * output :
+ * 		the node. its content is undefined. NULL if memory allocation failed
+ **/
+static SudukuBoardStruct* acquireNode(SudukuContext* context)
+{
+	if (context->shared)
+	{
+		SudukuBoardStruct* node = acquireSharedNode(context);
+		if (node != NULL)
+		{
+			// the counters are atomic, so no thread waits for another to count its node
+			__atomic_fetch_add(&context->nodeAcquisitions, 1, __ATOMIC_RELAXED);
+			unsigned long inUse = __atomic_add_fetch(&context->nodesInUse, 1, __ATOMIC_RELAXED);
+			unsigned long peak = __atomic_load_n(&context->peakNodesInUse, __ATOMIC_RELAXED);
+			while (inUse > peak && !__atomic_compare_exchange_n(&context->peakNodesInUse, &peak, \
+								inUse, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
 			{
-				counter++;
 			}
 		}
+		return node;
 	}
-	return counter;
+	if (context->freeNodes == NULL && !addSlab(context))
+	{
+		return NULL;
+	}
+	SudukuBoardStruct* node = (SudukuBoardStruct*)context->freeNodes;
+	context->freeNodes = *(void**)node;
+	context->nodeAcquisitions++;
+	context->nodesInUse++;
+	if (context->nodesInUse > context->peakNodesInUse)
+	{
+		context->peakNodesInUse = context->nodesInUse;
+	}
+	return node;
 }
 
 /**
- * this function checks if a number is valid in the board in the sent slot. 
- * returns 0 if the number already exist in the little board, row or col and 1 if its not exist
+ * this function counts a node whose children or moves were asked for in the context's
+ * nodesExpanded, atomically if the context is shared between threads.
+ * input :
+ * 		SudukuContext* context - a context
+ * output :
+ * 		void
+ **/
+static void countExpandedNode(SudukuContext* context)
+{
+	if (context->shared)
+	{
+		__atomic_fetch_add(&context->nodesExpanded, 1, __ATOMIC_RELAXED);
+	}
+	else
+	{
+		context->nodesExpanded++;
+	}
+}
+
+/**
+ * this function creates a context for boards of a given size, with an empty pool.
+ * input :
+ * 		int size - the size of the boards
+ * output :
+ * 		the context. NULL if the size is not a square, bigger than SUDUKU_MAX_SIZE or memory
+ * 		allocation failed.
+ **/
+SudukuContext* createSudukuContext(int size)
+{
+	int boxSize = sqrtCheck(size);
+	if (size <= 0 || size > SUDUKU_MAX_SIZE || boxSize == NOT_AN_INT)
+	{
+		return NULL;
+	}
+	SudukuContext* context = (SudukuContext*)calloc(1, sizeof(SudukuContext));
+	if (context == NULL)
+	{
+		return NULL;
+	}
+	context->size = size;
+	context->boxSize = boxSize;
+	context->maskWords = (size + SUDUKU_MASK_BITS - 1) / SUDUKU_MASK_BITS;
+	context->branchPolicy = SUDUKU_BRANCH_FEWEST_CANDIDATES;
+	context->tieBreak = NULL;
+	context->propagate = TRUE;
+	context->shared = FALSE;
+	context->id = __atomic_add_fetch(&lastContextId, 1, __ATOMIC_RELAXED);
+	pthread_mutex_init(&context->poolLock, NULL);
+	// every applied move fills at least one slot, so neither the trail nor the marks can grow
+	// past the number of slots
+	context->trail = (int*)malloc(size * size * sizeof(int));
+	context->trailMarks = (int*)malloc(size * size * sizeof(int));
+	if (context->trail == NULL || context->trailMarks == NULL)
+	{
+		freeSudukuContext(context);
+		return NULL;
+	}
+	// a node is the struct, then the slots, then the row, col and little board sets
+	context->cellsOffset = ALIGN_UP(sizeof(SudukuBoardStruct));
+	context->masksOffset = context->cellsOffset + ALIGN_UP(size * size * sizeof(SudukuCell));
+	context->nodeBytes = context->masksOffset + \
+						 3 * size * context->maskWords * sizeof(SudukuMask);
+	context->nodesPerSlab = SLAB_BYTES / context->nodeBytes;
+	if (context->nodesPerSlab < MIN_NODES_PER_SLAB)
+	{
+		context->nodesPerSlab = MIN_NODES_PER_SLAB;
+	}
+	return context;
+}
+
+/**
+ * this function frees a context and every node of its pool, including nodes still in use.
+ * input :
+ * 		SudukuContext* context - a context
+ * output :
+ * 		void
+ **/
+void freeSudukuContext(SudukuContext* context)
+{
+	// the nodes of the calling thread's local pool are in the slabs
+	if (localPool.context == context)
+	{
+		localPool.context = NULL;
+		localPool.freeNodes = NULL;
+		localPool.count = 0;
+	}
+	while (context->slabs != NULL)
+	{
+		void* slab = context->slabs;
+		context->slabs = *(void**)slab;
+		free(slab);
+	}
+	free(context->trail);
+	free(context->trailMarks);
+	pthread_mutex_destroy(&context->poolLock);
+	free(context);
+}
+
+/**
+ * this function sets whether the boards of a context are used by more than one thread at a time.
+ * every thread takes the boards of a shared context from a local pool of its own, which only
+ * locks the context to move a batch of nodes, and the counters are atomic, so its boards can be
+ * copied, freed and expanded from any thread (in place moves still need one thread per context,
+ * since the trail is shared). a thread gives the nodes of its local pool back to the context when
+ * it ends or uses another shared context, and the calling thread gives its own back when the
+ * context stops being shared, so a shared context must be freed after the other threads that used
+ * it ended.
+ * input :
+ * 		SudukuContext* context - a context
+ * 		int shared - 1 if the context is shared, else 0
+ * output :
+ * 		void
+ **/
+void setSudukuContextShared(SudukuContext* context, int shared)
+{
+	if (!shared && localPool.context == context && localPool.contextId == context->id)
+	{
+		giveBackLocalPool();
+	}
+	context->shared = shared;
+}
+
+/**
+ * this function takes a new board with all its slots empty out of a context's pool. it also
+ * clears the context's trail, since the new board starts a new in place search.
+ * input :
+ * 		SudukuContext* context - a context
+ * output :
+ * 		the board. NULL if memory allocation failed
+ **/
+SudukuBoardStruct* createSudukuBoard(SudukuContext* context)
+{
+	SudukuBoardStruct* suduku = acquireNode(context);
+	if (suduku == NULL)
+	{
+		return NULL;
+	}
+	memset(suduku, 0, context->nodeBytes);
+	suduku->size = context->size;
+	suduku->boxSize = context->boxSize;
+	suduku->maskWords = context->maskWords;
+	suduku->context = context;
+	pointNodeFields(suduku, context);
+	// a new board starts a new in place search, so the trail of the last one is dropped
+	context->trailLength = 0;
+	context->trailDepth = 0;
+	return suduku;
+}
+
+/**
+ * this function checks if a number is valid in the board in the sent slot by scanning the row,
+ * col and little board. it's used for nums that are not digits of the board and therefore have
+ * no bit in the used digits sets.
  * input :
  * 		SudukuBoardStruct* suduku - a suduku struct 
  * 		int num - the given num
@@ -98,7 +517,7 @@ unsigned int getSudukuValFunc(void* sudukuStruct)
  * 		0 if the number already exits, 1 else.
  * 		
  **/
-int isValid(SudukuBoardStruct* suduku, int num, int numRow, int numCol)
+static int isValidScan(SudukuBoardStruct* suduku, int num, int numRow, int numCol)
 {
 	// an indicator. set by default to true
 	int indicator = TRUE;
@@ -109,27 +528,27 @@ int isValid(SudukuBoardStruct* suduku, int num, int numRow, int numCol)
 	for (i = 0; i < (*suduku).size; i++)
 	{
 
-		if (((*suduku).board[numRow][i] == num || (*suduku).board[i][numCol] == num))
+		if ((SUDUKU_SLOT(suduku, numRow, i) == num || SUDUKU_SLOT(suduku, i, numCol) == num))
 		{
 			indicator = FALSE;
 			return indicator;
 		}
 	}
 	// setting start points to start check in the little board. 
-	int startRowPoint = (numRow / sqrtCheck((*suduku).size)) * sqrtCheck((*suduku).size);
-	int startColPoint = (numCol / sqrtCheck((*suduku).size)) * sqrtCheck((*suduku).size);
+	int startRowPoint = (numRow / suduku->boxSize) * suduku->boxSize;
+	int startColPoint = (numCol / suduku->boxSize) * suduku->boxSize;
 	// 2 counters for the loops
 	int rowCounter, colCounter;
 	// setting finish points to start check in the little board.
-	int rowFinishPoint = startRowPoint + sqrtCheck((*suduku).size);
-	int colFinishPoint = startColPoint + sqrtCheck((*suduku).size);
+	int rowFinishPoint = startRowPoint + suduku->boxSize;
+	int colFinishPoint = startColPoint + suduku->boxSize;
 	// a for loop inside a for loop checks if the number exists in the little board and if it does
 	// return false
 	for (rowCounter = startRowPoint; rowCounter < (rowFinishPoint); rowCounter++)
 	{
 		for (colCounter = startColPoint; colCounter < (colFinishPoint); colCounter++)
 		{
-			if ((*suduku).board[rowCounter][colCounter] == num)
+			if (SUDUKU_SLOT(suduku, rowCounter, colCounter) == num)
 			{
 				indicator = FALSE;
 				return indicator;
@@ -141,6 +560,485 @@ int isValid(SudukuBoardStruct* suduku, int num, int numRow, int numCol)
 	return indicator;	
 }
 
+/**
+ * this function checks if a number is valid in the board in the sent slot. 
+ * returns 0 if the number already exist in the little board, row or col and 1 if its not exist
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct 
+ * 		int num - the given num
+ * 		int numRow - the num's row in the board
+ * 		int numCol - the num's col in the board
+ * output :
+ * 		0 if the number already exits, 1 else.
+ * 		
+ **/
+int isValid(SudukuBoardStruct* suduku, int num, int numRow, int numCol)
+{
+	if (num < 1 || num > suduku->size)
+	{
+		return isValidScan(suduku, num, numRow, numCol);
+	}
+	int word = MASK_WORD(num);
+	SudukuMask used = suduku->rowUsed[numRow * suduku->maskWords + word] | \
+					  suduku->colUsed[numCol * suduku->maskWords + word] | \
+					  suduku->boxUsed[BOX_INDEX(suduku, numRow, numCol) * suduku->maskWords + word];
+	if (used & MASK_BIT(num))
+	{
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * this function returns the Zobrist key of a num in a slot. the keys are not kept in a table of
+ * size^3 keys, which is too big for the big boards, but mixed out of the slot and the num with the
+ * splitmix64 finalizer, which makes them as good as random. the key of an empty slot is 0.
+ * input :
+ * 		int slot - the slot (row * size + col)
+ * 		int num - the num
+ * output :
+ * 		the key
+ **/
+static uint64_t zobristKey(int slot, int num)
+{
+	if (num == EMPTY_SLOT)
+	{
+		return 0;
+	}
+	uint64_t key = ((uint64_t)MAKE_MOVE(slot, num)) + ZOBRIST_SEED;
+	key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+	return key ^ (key >> 31);
+}
+
+/**
+ * this function builds the used digits sets, the filled slots count and the hash of a suduku
+ * struct from its board. it has to be called once after the board was filled directly (as the
+ * parser does) and before the struct is used by any other function of this file.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct with a filled board and size
+ * output :
+ * 		1 if the sets were built, 0 if the size is not a square or memory allocation failed.
+ **/
+int initSudukuMasks(SudukuBoardStruct* suduku)
+{
+	int indicator = TRUE;
+	int setWords = suduku->size * suduku->maskWords;
+	// all the sets start empty
+	memset(suduku->rowUsed, 0, 3 * setWords * sizeof(SudukuMask));
+	suduku->filled = countSudukuFilledSlots(suduku);
+	suduku->hash = 0;
+	int row, col;
+	for (row = 0; row < suduku->size; row++)
+	{
+		for (col = 0; col < suduku->size; col++)
+		{
+			int num = SUDUKU_SLOT(suduku, row, col);
+			if (num == EMPTY_SLOT)
+			{
+				continue;
+			}
+			suduku->hash ^= zobristKey(row * suduku->size + col, num);
+			int word = MASK_WORD(num);
+			SudukuMask* rowSet = &suduku->rowUsed[row * suduku->maskWords + word];
+			SudukuMask* colSet = &suduku->colUsed[col * suduku->maskWords + word];
+			SudukuMask* boxSet = &suduku->boxUsed[BOX_INDEX(suduku, row, col) * \
+												  suduku->maskWords + word];
+			// a digit that is already in one of the sets is repeated
+			if ((*rowSet | *colSet | *boxSet) & MASK_BIT(num))
+			{
+				indicator = FALSE;
+			}
+			*rowSet |= MASK_BIT(num);
+			*colSet |= MASK_BIT(num);
+			*boxSet |= MASK_BIT(num);
+		}
+	}
+	return indicator;
+}
+
+/**
+ * this function puts a num in a slot of the board and updates the used digits sets. a num of 0
+ * empties the slot.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int row - the slot's row in the board
+ * 		int col - the slot's col in the board
+ * 		int num - the num to put in the slot, 0 to empty it
+ * output :
+ * 		void
+ **/
+void setSudukuSlot(SudukuBoardStruct* suduku, int row, int col, int num)
+{
+	int box = BOX_INDEX(suduku, row, col);
+	int oldNum = SUDUKU_SLOT(suduku, row, col);
+	// take the old num out of the sets before putting the new one in
+	if (oldNum != EMPTY_SLOT)
+	{
+		int word = MASK_WORD(oldNum);
+		suduku->rowUsed[row * suduku->maskWords + word] &= ~MASK_BIT(oldNum);
+		suduku->colUsed[col * suduku->maskWords + word] &= ~MASK_BIT(oldNum);
+		suduku->boxUsed[box * suduku->maskWords + word] &= ~MASK_BIT(oldNum);
+	}
+	if (num != EMPTY_SLOT)
+	{
+		int word = MASK_WORD(num);
+		suduku->rowUsed[row * suduku->maskWords + word] |= MASK_BIT(num);
+		suduku->colUsed[col * suduku->maskWords + word] |= MASK_BIT(num);
+		suduku->boxUsed[box * suduku->maskWords + word] |= MASK_BIT(num);
+	}
+	suduku->filled += (num != EMPTY_SLOT) - (oldNum != EMPTY_SLOT);
+	suduku->hash ^= zobristKey(row * suduku->size + col, oldNum) ^ \
+					zobristKey(row * suduku->size + col, num);
+	SUDUKU_SLOT(suduku, row, col) = num;
+}
+
+/**
+ * this function calculates one word of the set of digits that can be legally put in a slot: the
+ * digits that are not used in the slot's row, col or little board.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int row - the slot's row in the board
+ * 		int col - the slot's col in the board
+ * 		int word - the index of the word in the set
+ * output :
+ * 		the word of the legal digits set
+ **/
+static SudukuMask candidateWord(SudukuBoardStruct* suduku, int row, int col, int word)
+{
+	int box = BOX_INDEX(suduku, row, col);
+	SudukuMask candidates = ~(suduku->rowUsed[row * suduku->maskWords + word] | \
+							  suduku->colUsed[col * suduku->maskWords + word] | \
+							  suduku->boxUsed[box * suduku->maskWords + word]);
+	// the digits of the last word stop at size, the rest of its bits are not digits
+	int digitsInWord = suduku->size - word * SUDUKU_MASK_BITS;
+	if (digitsInWord < SUDUKU_MASK_BITS)
+	{
+		candidates &= ((SudukuMask)1 << digitsInWord) - 1;
+	}
+	return candidates;
+}
+
+/**
+ * this function calculates the digits that can be legally put in a slot, as a set of maskWords
+ * words. the slot's own value is not taken out of the sets, so it should be called for empty
+ * slots.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int row - the slot's row in the board
+ * 		int col - the slot's col in the board
+ * 		SudukuMask* candidates - an array of maskWords words to put the set in
+ * output :
+ * 		the number of legal digits for the slot
+ **/
+int getSudukuCandidates(SudukuBoardStruct* suduku, int row, int col, SudukuMask* candidates)
+{
+	int counter = 0;
+	int word;
+	for (word = 0; word < suduku->maskWords; word++)
+	{
+		candidates[word] = candidateWord(suduku, row, col, word);
+		counter += __builtin_popcountll(candidates[word]);
+	}
+	return counter;
+}
+
+/**
+ * a tie break policy for SUDUKU_BRANCH_FEWEST_CANDIDATES that prefers the slot with more empty
+ * slots in its row, col and little board, since filling it constrains more of the board.
+ * input :
+ * 		struct SudukuBoardStruct* suduku - a suduku struct
+ * 		int firstSlot - the slot found first
+ * 		int secondSlot - the slot found second
+ * output :
+ * 		1 if secondSlot has more empty peers than firstSlot, 0 else.
+ **/
+int sudukuDegreeTieBreak(struct SudukuBoardStruct* suduku, int firstSlot, int secondSlot)
+{
+	int slots[2] = {firstSlot, secondSlot};
+	int emptyPeers[2] = {0, 0};
+	int k, i;
+	for (k = 0; k < 2; k++)
+	{
+		int row = slots[k] / suduku->size;
+		int col = slots[k] % suduku->size;
+		int startRow = row / suduku->boxSize * suduku->boxSize;
+		int startCol = col / suduku->boxSize * suduku->boxSize;
+		// the row and the col, then the little board. slots of the little board in the same row
+		// or col are counted twice, which doesn't change the order much and keeps it cheap
+		for (i = 0; i < suduku->size; i++)
+		{
+			emptyPeers[k] += (SUDUKU_SLOT(suduku, row, i) == EMPTY_SLOT);
+			emptyPeers[k] += (SUDUKU_SLOT(suduku, i, col) == EMPTY_SLOT);
+			emptyPeers[k] += (SUDUKU_SLOT(suduku, startRow + i / suduku->boxSize, \
+										  startCol + i % suduku->boxSize) == EMPTY_SLOT);
+		}
+	}
+	return emptyPeers[1] > emptyPeers[0];
+}
+
+/**
+ * this function is findBranchSlot for SUDUKU_BRANCH_FEWEST_CANDIDATES on a board of size up to
+ * SUDUKU_SIMD_MAX_SIZE, with the legal digits of all the slots calculated at once by the vectorized
+ * kernel of sudukusimd.c.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct of size up to SUDUKU_SIMD_MAX_SIZE
+ * 		int* numCandidates - a pointer to put the number of legal digits of the slot in
+ * output :
+ * 		the slot (row * size + col). NO_EMPTY_SLOT if the board is full
+ **/
+static int findSmallBranchSlot(SudukuBoardStruct* suduku, int* numCandidates)
+{
+	SudukuContext* context = suduku->context;
+	uint16_t candidates[SUDUKU_SIMD_MAX_SIZE * SUDUKU_SIMD_MAX_SIZE];
+	int bestSlot = NO_EMPTY_SLOT;
+	int bestCount = suduku->size + 1;
+	int row, col;
+	getSudukuCandidateMasks(suduku, candidates);
+	for (row = 0; row < suduku->size; row++)
+	{
+		for (col = 0; col < suduku->size; col++)
+		{
+			int slot = row * suduku->size + col;
+			if (suduku->board[slot] != EMPTY_SLOT)
+			{
+				continue;
+			}
+			int count = __builtin_popcount(candidates[row * SUDUKU_SIMD_MAX_SIZE + col]);
+			if (count < bestCount || (count == bestCount && context->tieBreak != NULL && \
+				context->tieBreak(suduku, bestSlot, slot)))
+			{
+				bestSlot = slot;
+				bestCount = count;
+			}
+			// a slot with no legal digit is a dead end, and no slot has less than one otherwise
+			if (bestCount == 0 || (bestCount == 1 && context->tieBreak == NULL))
+			{
+				*numCandidates = bestCount;
+				return bestSlot;
+			}
+		}
+	}
+	*numCandidates = (bestSlot == NO_EMPTY_SLOT) ? 0 : bestCount;
+	return bestSlot;
+}
+
+/**
+ * this function picks the empty slot the children of a board fill, by the context's branch policy.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int* numCandidates - a pointer to put the number of legal digits of the slot in
+ * output :
+ * 		the slot (row * size + col). NO_EMPTY_SLOT if the board is full
+ **/
+static int findBranchSlot(SudukuBoardStruct* suduku, int* numCandidates)
+{
+	SudukuContext* context = suduku->context;
+	int bestSlot = NO_EMPTY_SLOT;
+	int bestCount = suduku->size + 1;
+	int slot, word;
+	// a small board has the legal digits of all its slots calculated in one vectorized pass
+	if (context->branchPolicy == SUDUKU_BRANCH_FEWEST_CANDIDATES && \
+		suduku->size <= SUDUKU_SIMD_MAX_SIZE)
+	{
+		return findSmallBranchSlot(suduku, numCandidates);
+	}
+	for (slot = 0; slot < suduku->size * suduku->size; slot++)
+	{
+		if (suduku->board[slot] != EMPTY_SLOT)
+		{
+			continue;
+		}
+		int row = slot / suduku->size;
+		int col = slot % suduku->size;
+		int count = 0;
+		for (word = 0; word < suduku->maskWords; word++)
+		{
+			count += __builtin_popcountll(candidateWord(suduku, row, col, word));
+		}
+		if (count < bestCount || (count == bestCount && context->tieBreak != NULL && \
+			context->tieBreak(suduku, bestSlot, slot)))
+		{
+			bestSlot = slot;
+			bestCount = count;
+		}
+		// the first empty slot is the one for SUDUKU_BRANCH_FIRST_EMPTY. a slot with no legal
+		// digit is a dead end, and no slot has less than one legal digit otherwise
+		if (context->branchPolicy == SUDUKU_BRANCH_FIRST_EMPTY || bestCount == 0 || \
+			(bestCount == 1 && context->tieBreak == NULL))
+		{
+			break;
+		}
+	}
+	*numCandidates = (bestSlot == NO_EMPTY_SLOT) ? 0 : bestCount;
+	return bestSlot;
+}
+
+/**
+ * this function returns the slot (row * size + col) of the k-th slot of a row, col or little board.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int unitType - UNIT_ROW, UNIT_COL or UNIT_BOX
+ * 		int unit - the index of the row, col or little board
+ * 		int k - the index of the slot in it
+ * output :
+ * 		the slot
+ **/
+static int unitSlot(SudukuBoardStruct* suduku, int unitType, int unit, int k)
+{
+	if (unitType == UNIT_ROW)
+	{
+		return unit * suduku->size + k;
+	}
+	if (unitType == UNIT_COL)
+	{
+		return k * suduku->size + unit;
+	}
+	int row = unit / suduku->boxSize * suduku->boxSize + k / suduku->boxSize;
+	int col = unit % suduku->boxSize * suduku->boxSize + k % suduku->boxSize;
+	return row * suduku->size + col;
+}
+
+/**
+ * this function puts a num in an empty slot, recording the slot on the context's trail if asked.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int slot - the slot (row * size + col)
+ * 		int num - the num
+ * 		int recordTrail - 1 to record the slot on the trail, else 0
+ * output :
+ * 		void
+ **/
+static void fillSlot(SudukuBoardStruct* suduku, int slot, int num, int recordTrail)
+{
+	setSudukuSlot(suduku, slot / suduku->size, slot % suduku->size, num);
+	if (recordTrail)
+	{
+		SudukuContext* context = suduku->context;
+		context->trail[context->trailLength] = slot;
+		context->trailLength++;
+	}
+}
+
+/**
+ * this function fills the forced slots of a board until there are none left: empty slots with
+ * only one legal digit (naked singles), and digits that have only one slot left in a row, col or
+ * little board (hidden singles).
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int recordTrail - 1 to record the filled slots on the context's trail, else 0
+ * output :
+ * 		0 if it found the board can't be solved - an empty slot with no legal digit, or a digit
+ * 		with no slot left in a row, col or little board - else 1.
+ **/
+static int propagateSuduku(SudukuBoardStruct* suduku, int recordTrail)
+{
+	SudukuMask* usedSets[UNIT_TYPES] = {suduku->rowUsed, suduku->colUsed, suduku->boxUsed};
+	SudukuMask seenOnce[SUDUKU_MAX_MASK_WORDS];
+	SudukuMask seenTwice[SUDUKU_MAX_MASK_WORDS];
+	int numOfSlots = suduku->size * suduku->size;
+	int changed = TRUE;
+	int slot, word, unitType, unit, k;
+	// every round fills at least one slot, or it's the last round
+	while (changed)
+	{
+		changed = FALSE;
+		// naked singles
+		for (slot = 0; slot < numOfSlots; slot++)
+		{
+			if (suduku->board[slot] != EMPTY_SLOT)
+			{
+				continue;
+			}
+			int count = 0;
+			int num = EMPTY_SLOT;
+			for (word = 0; word < suduku->maskWords; word++)
+			{
+				SudukuMask candidates = candidateWord(suduku, slot / suduku->size, \
+													  slot % suduku->size, word);
+				if (candidates != 0)
+				{
+					count += __builtin_popcountll(candidates);
+					num = word * SUDUKU_MASK_BITS + __builtin_ctzll(candidates) + 1;
+				}
+			}
+			if (count == 0)
+			{
+				return FALSE;
+			}
+			if (count == 1)
+			{
+				fillSlot(suduku, slot, num, recordTrail);
+				changed = TRUE;
+			}
+		}
+		// hidden singles. for every row, col and little board the digits that are legal in at
+		// least one of its empty slots and in at least two of them
+		for (unitType = 0; unitType < UNIT_TYPES; unitType++)
+		{
+			for (unit = 0; unit < suduku->size; unit++)
+			{
+				memset(seenOnce, 0, sizeof(seenOnce));
+				memset(seenTwice, 0, sizeof(seenTwice));
+				for (k = 0; k < suduku->size; k++)
+				{
+					slot = unitSlot(suduku, unitType, unit, k);
+					if (suduku->board[slot] != EMPTY_SLOT)
+					{
+						continue;
+					}
+					for (word = 0; word < suduku->maskWords; word++)
+					{
+						SudukuMask candidates = candidateWord(suduku, slot / suduku->size, \
+															  slot % suduku->size, word);
+						seenTwice[word] |= seenOnce[word] & candidates;
+						seenOnce[word] |= candidates;
+					}
+				}
+				for (word = 0; word < suduku->maskWords; word++)
+				{
+					// the digits still missing in the unit must each have a slot
+					SudukuMask missing = ~usedSets[unitType][unit * suduku->maskWords + word];
+					int digitsInWord = suduku->size - word * SUDUKU_MASK_BITS;
+					if (digitsInWord < SUDUKU_MASK_BITS)
+					{
+						missing &= ((SudukuMask)1 << digitsInWord) - 1;
+					}
+					if ((missing & ~seenOnce[word]) != 0)
+					{
+						return FALSE;
+					}
+					SudukuMask singles = seenOnce[word] & ~seenTwice[word];
+					while (singles != 0)
+					{
+						int num = word * SUDUKU_MASK_BITS + __builtin_ctzll(singles) + 1;
+						singles &= singles - 1;
+						// the only slot of the digit may have been filled by an earlier single
+						// of this unit, and then the digit has no slot left
+						int placed = FALSE;
+						for (k = 0; k < suduku->size && !placed; k++)
+						{
+							slot = unitSlot(suduku, unitType, unit, k);
+							if (suduku->board[slot] == EMPTY_SLOT && isValid(suduku, num, \
+								slot / suduku->size, slot % suduku->size))
+							{
+								fillSlot(suduku, slot, num, recordTrail);
+								placed = TRUE;
+							}
+						}
+						if (!placed)
+						{
+							return FALSE;
+						}
+						changed = TRUE;
+					}
+				}
+			}
+		}
+	}
+	return TRUE;
+}
+
 /**
  * This function copies a suduku struct to another one and returns it
  * input :
@@ -152,43 +1050,98 @@ void* copySudukuFunc(void* originalSuduku)
 {
 	//casting the given suduku to a SudukuBoardStruct 
 	SudukuBoardStruct* suduku = (SudukuBoardStruct*)originalSuduku;
-	//creating a new suduku 
-	SudukuBoardStruct* newSuduku = (SudukuBoardStruct*)malloc(sizeof(SudukuBoardStruct));
+	//taking a new node out of the pool 
+	SudukuBoardStruct* newSuduku = acquireNode(suduku->context);
 	if (newSuduku == NULL)
 	{
 		return NULL;
 	}
-	// copies the size
-	newSuduku->size = suduku->size;
-	//malloc the size of the board as needed by the size that was copied
-	newSuduku->board = (int**)malloc(newSuduku->size * sizeof(int*));
-	if (newSuduku->board == NULL)
+	// the struct, the slots and the used digits sets are one node, so they're copied at once. the
+	// pointers of the copy are then moved to its own node
+	memcpy(newSuduku, suduku, suduku->context->nodeBytes);
+	pointNodeFields(newSuduku, suduku->context);
+	return (void*)newSuduku;
+}
+
+/**
+ * this is a function that gets a node and a cursor over its children, and makes the next child:
+ * a copy of the node with the next digit that is not used in the row, col or little board of the
+ * slot picked by the branch policy put in the slot. a child whose forced slots can't all be
+ * filled has no solution, so it's skipped. the node must not change between the calls.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		long* cursor - 0 for the first child, then the value the last call left in it
+ * output :
+ * 		the child, NULL if there are no more children or memory allocation failed
+ **/
+void* getNextSudukuChildFunc(void* sudukuStruct, long* cursor)
+{
+	SudukuBoardStruct* suduku = (SudukuBoardStruct*) sudukuStruct;
+	int slot, num, word;
+	if (*cursor == CURSOR_DONE)
 	{
 		return NULL;
 	}
-	int i, j;
-	// a for loop inside a for loop running on each slot in the original suduku and copy it's
-	// value to the new suduku board exactly in the same slot
-	for (i = 0; i < newSuduku->size; i++)
+	// the first call picks the slot. the cursor then holds the move of the last child plus one,
+	// so it's never 0 again
+	if (*cursor == CURSOR_START)
 	{
-		newSuduku->board[i] = (int*)malloc(sizeof(int) * newSuduku->size);
-		if (newSuduku->board[i] == NULL)
+		int numCandidates;
+		countExpandedNode(suduku->context);
+		// a full board has no children, and neither does a board with an empty slot no digit
+		// fits in
+		slot = findBranchSlot(suduku, &numCandidates);
+		if (slot == NO_EMPTY_SLOT || numCandidates == 0)
 		{
+			*cursor = CURSOR_DONE;
 			return NULL;
 		}
-		for (j = 0; j < newSuduku->size; j++)
+		num = 0;
+	}
+	else
+	{
+		slot = MOVE_SLOT(*cursor - 1);
+		num = MOVE_NUM(*cursor - 1);
+	}
+	int i = slot / suduku->size;
+	int j = slot % suduku->size;
+	// the digits after the last child's digit, num + 1 being bit num of the set
+	for (word = num / SUDUKU_MASK_BITS; word < suduku->maskWords; word++)
+	{
+		SudukuMask candidates = candidateWord(suduku, i, j, word);
+		if (word == num / SUDUKU_MASK_BITS)
+		{
+			candidates &= ~(SudukuMask)0 << (num % SUDUKU_MASK_BITS);
+		}
+		while (candidates != 0)
 		{
-			newSuduku->board[i][j] = suduku->board[i][j];
-			
+			num = word * SUDUKU_MASK_BITS + __builtin_ctzll(candidates) + 1;
+			candidates &= candidates - 1;
+			*cursor = (long)MAKE_MOVE(slot, num) + 1;
+			SudukuBoardStruct* child = copySudukuFunc(suduku);
+			if (child == NULL)
+			{
+				*cursor = CURSOR_DONE;
+				return NULL;
+			}
+			setSudukuSlot(child, i, j, num);
+			if (suduku->context->propagate && propagateSuduku(child, FALSE) == FALSE)
+			{
+				freeSudukuFunc(child);
+				continue;
+			}
+			return (void*)child;
 		}
 	}
-	return (void*)newSuduku;
+	*cursor = CURSOR_DONE;
+	return NULL;
 }
 
 /**
  * this is a function that gets a node and a pointer to an array of nodes.
  * The function allocates memory for an array of all the children of the node, populate it,
  * and returns it using the second parameter. The returned value is the number of children.
+ * the children are the ones getNextSudukuChildFunc makes, one after the other.
  * input :
  * 		void* sudukuStruct - a pNode struct
  * 		void*** childrenListStruct - a pointer to an array of pNodes
@@ -203,49 +1156,175 @@ int getSudukuChildrenFunc(void* sudukuStruct, void*** childrenListStruct)
 	// if it's null return -1 which is the output for illegal value
 	if (childrenList == NULL)
 	{
-		free(childrenList);
 		return ILLEGAL_VALUE;
 	}
 	*childrenListStruct = (void**)childrenList;
-	int check;
-	int i, j, k;
 	// a counter for the children
 	int currentChild = 0;
-	// a for loop inside a for loop running on each slot in the board
-	for (i = 0; i < (*suduku).size; i++)
+	long cursor = CURSOR_START;
+	SudukuBoardStruct* child;
+	while ((child = getNextSudukuChildFunc(suduku, &cursor)) != NULL)
 	{
-		for (j = 0; j < (*suduku).size; j++)
+		childrenList[currentChild] = child;
+		currentChild++;
+	}
+	return currentChild;
+}
+
+/**
+ * this is a function that gets a node and a pointer to an array of moves.
+ * The function allocates memory for an array of the moves to all the children of the node (the
+ * same children getSudukuChildrenFunc makes), populate it, and returns it using the second
+ * parameter. The returned value is the number of moves.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int** movesList - a pointer to an array of moves
+ * output :
+ * 		the number of moves. -1 indicates illeagal value
+ **/
+int getSudukuMovesFunc(void* sudukuStruct, int** movesList)
+{
+	SudukuBoardStruct* suduku = (SudukuBoardStruct*) sudukuStruct;
+	int* moves = (int*)malloc(sizeof(int) * suduku->size);
+	// if it's null return -1 which is the output for illegal value
+	if (moves == NULL)
+	{
+		return ILLEGAL_VALUE;
+	}
+	*movesList = moves;
+	return fillSudukuMovesFunc(sudukuStruct, moves);
+}
+
+/**
+ * this is getSudukuMovesFunc that puts the moves in a given array instead of allocating one.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int* moves - an array of size moves
+ * output :
+ * 		the number of moves.
+ **/
+int fillSudukuMovesFunc(void* sudukuStruct, int* moves)
+{
+	SudukuBoardStruct* suduku = (SudukuBoardStruct*) sudukuStruct;
+	int word;
+	// a counter for the moves
+	int currentMove = 0;
+	int numCandidates;
+	countExpandedNode(suduku->context);
+	// the slot to fill, picked by the branch policy, and a move for each digit that is not used
+	// in its row, col or little board. a dead end has no moves
+	int slot = findBranchSlot(suduku, &numCandidates);
+	if (suduku->deadEnd || slot == NO_EMPTY_SLOT || numCandidates == 0)
+	{
+		return NO_CHILDREN;
+	}
+	int i = slot / suduku->size;
+	int j = slot % suduku->size;
+	for (word = 0; word < suduku->maskWords; word++)
+	{
+		SudukuMask candidates = candidateWord(suduku, i, j, word);
+		while (candidates != 0)
 		{
-			if ((*suduku).board[i][j] != 0)
-			{
-				continue;
-			}
-			// if the value of the current slot is 0 than run on each number from 1 to the legal
-			// size of the board and checks if this number is legal to put in this slot.
-			for (k = 1; k < ((*suduku).size + 1); k++)
-			{
-				// if this value is valid for this slot than put it in this slot, and copy the 
-				// suduku to childrenList in the place of the counter and increase the counter by 
-				//one
-				if ((check = isValid(suduku, k, i, j)) == 1)
-				{
-					(*suduku).board[i][j] = k;						
-					childrenList[currentChild] = copySudukuFunc(suduku);
-					currentChild++;
-				}
-			}
-			return currentChild;
+			int num = word * SUDUKU_MASK_BITS + __builtin_ctzll(candidates) + 1;
+			candidates &= candidates - 1;
+			moves[currentMove] = MAKE_MOVE(slot, num);
+			currentMove++;
 		}
 	}
-	// count how much numbers are not 0 in the board
-	int numbersCounter = getSudukuValFunc(suduku);
-	// if the counter is 0 means no children and the board is full of numbers that are not 0 return 
-	// no children
-	if (currentChild == 0 && numbersCounter == (suduku->size * suduku->size))
+	return currentMove;
+}
+
+/**
+ * this function fills the forced slots of a board before it's searched, if its context
+ * propagates, like applySudukuMoveFunc does for every child. the slots are not recorded on the
+ * trail, since no move is undone past the root.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct with its used digits sets built
+ * output :
+ * 		0 if it found the board can't be solved (and marked it as a dead end), else 1.
+ **/
+int propagateSudukuRoot(SudukuBoardStruct* suduku)
+{
+	if (suduku->context->propagate && propagateSuduku(suduku, FALSE) == FALSE)
 	{
-		return NO_CHILDREN;
+		suduku->deadEnd = TRUE;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * this is a function that applies a move returned by getSudukuMovesFunc to a node, putting the
+ * move's num in its slot and then, if the context propagates, filling the forced slots. the
+ * filled slots are recorded on the context's trail.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int move - the move
+ * output :
+ * 		void
+ **/
+void applySudukuMoveFunc(void* sudukuStruct, int move)
+{
+	SudukuBoardStruct* suduku = (SudukuBoardStruct*) sudukuStruct;
+	SudukuContext* context = suduku->context;
+	context->trailMarks[context->trailDepth] = context->trailLength;
+	context->trailDepth++;
+	fillSlot(suduku, MOVE_SLOT(move), MOVE_NUM(move), TRUE);
+	if (context->propagate && propagateSuduku(suduku, TRUE) == FALSE)
+	{
+		suduku->deadEnd = TRUE;
+	}
+}
+
+/**
+ * this is a function that undoes the last move applied to a node, emptying every slot the move
+ * filled.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int move - the move
+ * output :
+ * 		void
+ **/
+void undoSudukuMoveFunc(void* sudukuStruct, int move)
+{
+	SudukuBoardStruct* suduku = (SudukuBoardStruct*) sudukuStruct;
+	SudukuContext* context = suduku->context;
+	(void)move;
+	context->trailDepth--;
+	while (context->trailLength > context->trailMarks[context->trailDepth])
+	{
+		context->trailLength--;
+		int slot = context->trail[context->trailLength];
+		setSudukuSlot(suduku, slot / suduku->size, slot % suduku->size, EMPTY_SLOT);
 	}
-	return ILLEGAL_VALUE;		
+	// moves are only applied to boards that are not dead ends
+	suduku->deadEnd = FALSE;
+}
+
+/**
+ * This function returns the Zobrist hash of a board, in O(1)
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * output :
+ * 		the hash
+ **/
+uint64_t getSudukuHashFunc(void* sudukuStruct)
+{
+	// the hash is kept up to date by setSudukuSlot
+	return ((SudukuBoardStruct*) sudukuStruct)->hash;
+}
+
+/**
+ * This function returns the key of a board for a transposition table: its slots, size * size
+ * bytes.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * output :
+ * 		a pointer to the slots of the board
+ **/
+const void* getSudukuKeyFunc(void* sudukuStruct)
+{
+	return ((SudukuBoardStruct*) sudukuStruct)->board;
 }
 
 /**
@@ -259,14 +1338,15 @@ void freeSudukuFunc(void* sudukuStruct)
 {
 	//casting to SudukuBoardStruct*
 	SudukuBoardStruct* suduku = (SudukuBoardStruct*)sudukuStruct; 
-	int i;
-	// a loop running on the size of the board and frees each array
-	for (i = 0; i < (*suduku).size; i++)
+	SudukuContext* context = suduku->context;
+	// put the node back in the free list of its pool
+	if (context->shared)
 	{
-		free((*suduku).board[i]);
+		releaseSharedNode(context, suduku);
+		__atomic_fetch_sub(&context->nodesInUse, 1, __ATOMIC_RELAXED);
+		return;
 	}
-	// free the board and the struct
-	free((*suduku).board);
-	free(suduku);
-	
+	*(void**)suduku = context->freeNodes;
+	context->freeNodes = suduku;
+	context->nodesInUse--;
 }
@@ -7,14 +7,134 @@
  **/
 
 #ifndef sudukutree_H
-#define suduketree_H
+#define sudukutree_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+//********      consts
+// the biggest supported board size, so every slot fits in a SudukuCell
+#define SUDUKU_MAX_SIZE 255
+// the size of a board is a square, so the biggest valid board is of the biggest little board that
+// fits in SUDUKU_MAX_SIZE
+#define SUDUKU_MAX_BOX_SIZE 15
+#define SUDUKU_MAX_BOARD_SIZE (SUDUKU_MAX_BOX_SIZE * SUDUKU_MAX_BOX_SIZE)
+
+// branching policies - which empty slot the children of a board fill.
+// the first empty slot in row major order
+#define SUDUKU_BRANCH_FIRST_EMPTY 0
+// the empty slot with the fewest legal digits (ties are broken by the context's tieBreak)
+#define SUDUKU_BRANCH_FEWEST_CANDIDATES 1
+
 //********      structs
+struct SudukuBoardStruct;
+
+/**
+ * a tie break policy for SUDUKU_BRANCH_FEWEST_CANDIDATES. it gets a board and two empty slots
+ * (as row * size + col) with the same number of legal digits, the first of them found earlier in
+ * row major order, and returns 1 if the second one should be filled instead of the first, else 0.
+ **/
+typedef int(*SudukuTieBreakFunc)(struct SudukuBoardStruct* suduku, int firstSlot, int secondSlot);
+
+/**
+ * a slot of the board. 0 is an empty slot, else the digit in it.
+ **/
+typedef uint8_t SudukuCell;
+
+/**
+ * a bitset word of the "used digits" sets. bit (num - 1) of a set stands for the digit num, so a
+ * board of size n needs (n + SUDUKU_MASK_BITS - 1) / SUDUKU_MASK_BITS words per set.
+ **/
+typedef uint64_t SudukuMask;
+#define SUDUKU_MASK_BITS 64
+// the most words a used digits set of a board up to SUDUKU_MAX_SIZE can take
+#define SUDUKU_MAX_MASK_WORDS ((SUDUKU_MAX_SIZE + SUDUKU_MASK_BITS - 1) / SUDUKU_MASK_BITS)
+
+/**
+ * struct for the state shared by all the boards of one size: the sizes of a board node and a pool
+ * of fixed size nodes. nodes are carved out of slabs of nodes and freed nodes are kept in a free
+ * list, so copying a board takes no malloc once the pool is warm.
+ * the in place moves keep their trail in the context, so only one thread at a time may apply and
+ * undo moves on the boards of a context: every thread that searches in place needs its own.
+ **/
+typedef struct SudukuContext
+{
+	int size;
+	int boxSize;
+	int maskWords;
+	// bytes of a whole node, and the offsets of its slots and used digits sets in it
+	size_t nodeBytes;
+	size_t cellsOffset;
+	size_t masksOffset;
+	// number of nodes carved out of every slab
+	int nodesPerSlab;
+	// list of the slabs (linked through their first word) and of the free nodes
+	void* slabs;
+	void* freeNodes;
+	// how to pick the slot to branch on - one of the SUDUKU_BRANCH_ consts - and the tie break
+	// policy. a NULL tieBreak keeps the first slot in row major order
+	int branchPolicy;
+	SudukuTieBreakFunc tieBreak;
+	// 1 to fill the forced slots (naked and hidden singles) of every child, 0 to leave them
+	int propagate;
+	// the slots filled by the in place moves, in the order they were filled, and the length of the
+	// trail before each applied move, so undoSudukuMoveFunc can empty exactly the slots its move
+	// filled. both can take size * size entries
+	int* trail;
+	int trailLength;
+	int* trailMarks;
+	int trailDepth;
+	// number of nodes whose children or moves were asked for
+	unsigned long nodesExpanded;
+	// 1 if the boards are used by more than one thread, and the lock of the pool then, which is
+	// only taken to move batches of nodes between the pool and the local pools of the threads
+	int shared;
+	pthread_mutex_t poolLock;
+	// unique among the contexts of the process, so a local pool knows which context it's of
+	unsigned long id;
+	// allocation counters
+	unsigned long slabAllocations;
+	unsigned long nodeAcquisitions;
+	unsigned long nodesInUse;
+	unsigned long peakNodesInUse;
+}SudukuContext;
+
+/**
+ * struct for a suduku board. besides the board itself it holds for each row, col and little
+ * board the set of digits already used in it. the sets are kept in sync with the board by
+ * setSudukuSlot, so they must never be changed directly.
+ * the struct, its slots and its sets are one node of the context's pool.
+ **/
 typedef struct SudukuBoardStruct 
 {
-	int** board;
+	// size * size slots, row after row. use SUDUKU_SLOT to get to a slot
+	SudukuCell* board;
 	int size; 
+	// sqrt of size - the size of a little board
+	int boxSize;
+	// number of SudukuMask words in every used digits set
+	int maskWords;
+	// size * maskWords words each. the sets of row i, col i and little board i start at word
+	// i * maskWords
+	SudukuMask* rowUsed;
+	SudukuMask* colUsed;
+	SudukuMask* boxUsed;
+	// the context the node belongs to
+	SudukuContext* context;
+	// 1 if filling the forced slots found the board can't be solved, so it has no children
+	int deadEnd;
+	// number of slots that are not empty - the value of the node. kept by setSudukuSlot and
+	// initSudukuMasks
+	int filled;
+	// the Zobrist hash of the board: the xor of the keys of the (slot, digit) pairs of its filled
+	// slots. kept by setSudukuSlot and initSudukuMasks
+	uint64_t hash;
 }SudukuBoardStruct;
 
+// the slot in a given row and col of a board
+#define SUDUKU_SLOT(suduku, row, col) ((suduku)->board[(row) * (suduku)->size + (col)])
+
 
 //********      types and functions types
 /**
@@ -40,6 +160,102 @@ int sqrtCheck(int size);
  **/
 int isValid(SudukuBoardStruct* suduku, int num, int numRow, int numCol);
 
+/**
+ * this function creates a context for boards of a given size, with an empty pool.
+ * input :
+ * 		int size - the size of the boards
+ * output :
+ * 		the context. NULL if the size is not a square, bigger than SUDUKU_MAX_SIZE or memory
+ * 		allocation failed.
+ **/
+SudukuContext* createSudukuContext(int size);
+
+/**
+ * this function frees a context and every node of its pool, including nodes still in use.
+ * input :
+ * 		SudukuContext* context - a context
+ * output :
+ * 		void
+ **/
+void freeSudukuContext(SudukuContext* context);
+
+/**
+ * this function sets whether the boards of a context are used by more than one thread at a time.
+ * every thread takes the boards of a shared context from a local pool of its own, which only
+ * locks the context to move a batch of nodes, and the counters are atomic, so its boards can be
+ * copied, freed and expanded from any thread (in place moves still need one thread per context,
+ * since the trail is shared). a thread gives the nodes of its local pool back to the context when
+ * it ends or uses another shared context, and the calling thread gives its own back when the
+ * context stops being shared, so a shared context must be freed after the other threads that used
+ * it ended.
+ * input :
+ * 		SudukuContext* context - a context
+ * 		int shared - 1 if the context is shared, else 0
+ * output :
+ * 		void
+ **/
+void setSudukuContextShared(SudukuContext* context, int shared);
+
+/**
+ * this function takes a new board with all its slots empty out of a context's pool. it also
+ * clears the context's trail, since the new board starts a new in place search.
+ * input :
+ * 		SudukuContext* context - a context
+ * output :
+ * 		the board. NULL if memory allocation failed
+ **/
+SudukuBoardStruct* createSudukuBoard(SudukuContext* context);
+
+/**
+ * this function builds the used digits sets, the filled slots count and the hash of a suduku
+ * struct from its board. it has to be called once after the board was filled directly (as the
+ * parser does) and before the struct is used by any other function of this file.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct with a filled board
+ * output :
+ * 		1 if no digit is repeated in a row, col or little board, 0 else.
+ **/
+int initSudukuMasks(SudukuBoardStruct* suduku);
+
+/**
+ * this function puts a num in a slot of the board and updates the used digits sets. a num of 0
+ * empties the slot.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int row - the slot's row in the board
+ * 		int col - the slot's col in the board
+ * 		int num - the num to put in the slot, 0 to empty it
+ * output :
+ * 		void
+ **/
+void setSudukuSlot(SudukuBoardStruct* suduku, int row, int col, int num);
+
+/**
+ * this function calculates the digits that can be legally put in a slot, as a set of maskWords
+ * words. the slot's own value is not taken out of the sets, so it should be called for empty
+ * slots.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct
+ * 		int row - the slot's row in the board
+ * 		int col - the slot's col in the board
+ * 		SudukuMask* candidates - an array of maskWords words to put the set in
+ * output :
+ * 		the number of legal digits for the slot
+ **/
+int getSudukuCandidates(SudukuBoardStruct* suduku, int row, int col, SudukuMask* candidates);
+
+/**
+ * a tie break policy for SUDUKU_BRANCH_FEWEST_CANDIDATES that prefers the slot with more empty
+ * slots in its row, col and little board, since filling it constrains more of the board.
+ * input :
+ * 		struct SudukuBoardStruct* suduku - a suduku struct
+ * 		int firstSlot - the slot found first
+ * 		int secondSlot - the slot found second
+ * output :
+ * 		1 if secondSlot has more empty peers than firstSlot, 0 else.
+ **/
+int sudukuDegreeTieBreak(struct SudukuBoardStruct* suduku, int firstSlot, int secondSlot);
+
 /**
  * This function copies a suduku struct to another one and returns it
  * input :
@@ -49,6 +265,19 @@ int isValid(SudukuBoardStruct* suduku, int num, int numRow, int numCol);
  **/
 void* copySudukuFunc(void* originalSuduku);
 
+/**
+ * this is a function that gets a node and a cursor over its children, and makes the next child:
+ * a copy of the node with the next digit that is not used in the row, col or little board of the
+ * slot picked by the branch policy put in the slot. a child whose forced slots can't all be
+ * filled has no solution, so it's skipped. the node must not change between the calls.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		long* cursor - 0 for the first child, then the value the last call left in it
+ * output :
+ * 		the child, NULL if there are no more children or memory allocation failed
+ **/
+void* getNextSudukuChildFunc(void* sudukuStruct, long* cursor);
+
 /**
  * this is a function that gets a node and a pointer to an array of nodes.
  * The function allocates memory for an array of all the children of the node, populate it,
@@ -62,7 +291,65 @@ void* copySudukuFunc(void* originalSuduku);
 int getSudukuChildrenFunc(void* sudukuStruct, void*** childrenListStruct);
 
 /**
- * This function returns the number of numbers in the board that are not 0
+ * this is a function that gets a node and a pointer to an array of moves.
+ * The function allocates memory for an array of the moves to all the children of the node (the
+ * same children getSudukuChildrenFunc makes), populate it, and returns it using the second
+ * parameter. The returned value is the number of moves.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int** movesList - a pointer to an array of moves
+ * output :
+ * 		the number of moves. -1 indicates illeagal value
+ **/
+int getSudukuMovesFunc(void* sudukuStruct, int** movesList);
+
+/**
+ * this is getSudukuMovesFunc that puts the moves in a given array instead of allocating one.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int* moves - an array of size moves
+ * output :
+ * 		the number of moves.
+ **/
+int fillSudukuMovesFunc(void* sudukuStruct, int* moves);
+
+/**
+ * this function fills the forced slots of a board before it's searched, if its context
+ * propagates, like applySudukuMoveFunc does for every child. the slots are not recorded on the
+ * trail, since no move is undone past the root.
+ * input :
+ * 		SudukuBoardStruct* suduku - a suduku struct with its used digits sets built
+ * output :
+ * 		0 if it found the board can't be solved (and marked it as a dead end), else 1.
+ **/
+int propagateSudukuRoot(SudukuBoardStruct* suduku);
+
+/**
+ * this is a function that applies a move returned by getSudukuMovesFunc to a node, putting the
+ * move's num in its slot and then, if the context propagates, filling the forced slots. the
+ * filled slots are recorded on the context's trail, so the boards of a context are searched in
+ * place by one thread at a time.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int move - the move
+ * output :
+ * 		void
+ **/
+void applySudukuMoveFunc(void* sudukuStruct, int move);
+
+/**
+ * this is a function that undoes the last move applied to a node, emptying every slot the move
+ * filled.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * 		int move - the move
+ * output :
+ * 		void
+ **/
+void undoSudukuMoveFunc(void* sudukuStruct, int move);
+
+/**
+ * This function returns the number of numbers in the board that are not 0, in O(1)
  * input :
  * 		void* sudukuStruct - a pNode struct
  * output :
@@ -70,6 +357,25 @@ int getSudukuChildrenFunc(void* sudukuStruct, void*** childrenListStruct);
  **/
 unsigned int getSudukuValFunc(void* sudukuStruct);
 
+/**
+ * This function returns the Zobrist hash of a board, in O(1)
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * output :
+ * 		the hash
+ **/
+uint64_t getSudukuHashFunc(void* sudukuStruct);
+
+/**
+ * This function returns the key of a board for a transposition table: its slots, size * size
+ * bytes.
+ * input :
+ * 		void* sudukuStruct - a pNode struct
+ * output :
+ * 		a pointer to the slots of the board
+ **/
+const void* getSudukuKeyFunc(void* sudukuStruct);
+
 /**
  * this is a function that frees a memory of a given node
  * input :